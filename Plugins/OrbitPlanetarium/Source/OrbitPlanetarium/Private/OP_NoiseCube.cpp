@@ -1,12 +1,149 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "OP_NoiseCube.h"
+#include "OP_NoiseCubeCache.h"
+#include "OP_NoiseCubeAsset.h"
 #include "Engine/Texture2D.h"
-#include "ImageUtils.h"
+#include "Math/Float16.h"
+#include "Async/Async.h"
 #include "UnrealFastNoisePlugin/Public/UFNBlueprintFunctionLibrary.h"
 
 
-void UOP_NoiseCube::Init(int resolution,
+bool UOP_NoiseCube::Init(int resolution, const TArray<FOP_NoiseCubeChannel>& channels, EOP_NoiseCubeStorage storage, const UOP_NoiseCubeAsset* bakedAsset)
+{
+	FOP_NoiseCubeKey key;
+	if (!MakeKey(resolution, channels, storage, key))
+	{
+		return false;
+	}
+
+	// Nothing to do if we already hold the data for these parameters, e.g. when regenerating for a new LOD. A preview
+	// still being refined doesn't count, Init always leaves the full resolution data
+	if (!IsRefining() && IsCurrentKey(key))
+	{
+		return false;
+	}
+
+	CancelRefinement();
+
+	FOP_NoiseCubeDataPtr bakedData = FindBakedData(key, bakedAsset);
+	SetData(FOP_NoiseCubeCache::Get().FindOrGenerate(key, [&key, &bakedData]() { return bakedData.IsValid() ? bakedData : GenerateNoiseCube(key); }));
+
+	return true;
+}
+
+bool UOP_NoiseCube::InitProgressive(int resolution, const TArray<FOP_NoiseCubeChannel>& channels, EOP_NoiseCubeStorage storage, const UOP_NoiseCubeAsset* bakedAsset, TFunction<void()> onRefined)
+{
+	FOP_NoiseCubeKey key;
+	if (!MakeKey(resolution, channels, storage, key))
+	{
+		return false;
+	}
+
+	if (IsCurrentKey(key))
+	{
+		return false;
+	}
+
+	// Any refinement still running is for the old parameters
+	CancelRefinement();
+
+	// Nothing to refine if the full resolution cube is already around
+	FOP_NoiseCubeDataPtr data = FindBakedData(key, bakedAsset);
+	if (!data.IsValid())
+	{
+		data = FOP_NoiseCubeCache::Get().Find(key);
+	}
+	if (data.IsValid() || resolution <= PreviewResolution)
+	{
+		SetData(FOP_NoiseCubeCache::Get().FindOrGenerate(key, [&key, &data]() { return data.IsValid() ? data : GenerateNoiseCube(key); }));
+		return true;
+	}
+
+	// The same generators produce every resolution, so they are created once and the worker gets its own copy
+	TArray<FFastNoise> channelGenerators = CreateChannelGenerators(key);
+
+	FOP_NoiseCubeKey previewKey = key;
+	previewKey.Resolution = PreviewResolution;
+	SetData(FOP_NoiseCubeCache::Get().FindOrGenerate(previewKey, [&previewKey, &channelGenerators]() { return BuildNoiseCube(previewKey, channelGenerators); }));
+
+	RefineKey = key;
+	RefineCancelled = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>(false);
+
+	TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe> cancelled = RefineCancelled;
+	TWeakObjectPtr<UOP_NoiseCube> weakThis(this);
+
+	Async<void>(EAsyncExecution::ThreadPool, [key, channelGenerators, cancelled, weakThis, onRefined]()
+	{
+		// Double the resolution each step until the full resolution has been built
+		for (int32 levelResolution = PreviewResolution * 2; !*cancelled; levelResolution *= 2)
+		{
+			FOP_NoiseCubeKey levelKey = key;
+			levelKey.Resolution = FMath::Min(levelResolution, key.Resolution);
+
+			FOP_NoiseCubeDataPtr levelData = FOP_NoiseCubeCache::Get().FindOrGenerate(levelKey, [&levelKey, &channelGenerators, &cancelled]()
+			{
+				return BuildNoiseCube(levelKey, channelGenerators, cancelled.Get());
+			});
+
+			// Null when the build was cancelled part way through
+			if (!levelData.IsValid())
+			{
+				break;
+			}
+
+			const bool bFinal = levelKey.Resolution == key.Resolution;
+			AsyncTask(ENamedThreads::GameThread, [weakThis, cancelled, levelData, bFinal, onRefined]()
+			{
+				UOP_NoiseCube* cube = weakThis.Get();
+				if (cube == nullptr || *cancelled)
+				{
+					return;
+				}
+
+				cube->SetData(levelData);
+				if (bFinal)
+				{
+					cube->RefineCancelled = nullptr;
+				}
+
+				if (onRefined)
+				{
+					onRefined();
+				}
+			});
+
+			if (bFinal)
+			{
+				break;
+			}
+		}
+	});
+
+	return true;
+}
+
+void UOP_NoiseCube::CancelRefinement()
+{
+	if (RefineCancelled.IsValid())
+	{
+		*RefineCancelled = true;
+		RefineCancelled = nullptr;
+	}
+}
+
+bool UOP_NoiseCube::IsRefiningTo(const FOP_NoiseCubeKey& key) const
+{
+	return IsRefining() && RefineKey == key;
+}
+
+void UOP_NoiseCube::BeginDestroy()
+{
+	CancelRefinement();
+	Super::BeginDestroy();
+}
+
+bool UOP_NoiseCube::Init(int resolution,
 	EFractalNoiseType noiseType,
 	int32 seed,
 	float frequency,
@@ -16,9 +153,6 @@ void UOP_NoiseCube::Init(int resolution,
 	int32 octaves,
 	float lacunarity)
 {
-	Resolution = resolution;
-	ResStep = 1.0f / resolution;
-
 	FNoiseGeneratorParameters params = FNoiseGeneratorParameters(noiseType,
 		frequency,
 		fractalGain,
@@ -28,173 +162,351 @@ void UOP_NoiseCube::Init(int resolution,
 		lacunarity
 	);
 
-	// X+
-	NoiseGenerator_XPos = CreateNoiseGenerator(params, seed, this);
-	XPosHeight = CreateFlatNoiseArray(NoiseGenerator_XPos, resolution, 0.0f);
-	// X-
-	NoiseGenerator_XNeg = CreateNoiseGenerator(params, seed + 10, this);
-	XNegHeight = CreateFlatNoiseArray(NoiseGenerator_XNeg, resolution, 1.0f);
-	// Y+
-	NoiseGenerator_YPos = CreateNoiseGenerator(params, seed + 20, this);
-	YPosHeight = CreateFlatNoiseArray(NoiseGenerator_YPos, resolution, 2.0f);
-	// Y-
-	NoiseGenerator_YNeg = CreateNoiseGenerator(params, seed + 30, this);
-	YNegHeight = CreateFlatNoiseArray(NoiseGenerator_YNeg, resolution, 3.0f);
-	// Z+
-	NoiseGenerator_ZPos = CreateNoiseGenerator(params, seed + 40, this);
-	ZPosHeight = CreateFlatNoiseArray(NoiseGenerator_ZPos, resolution, 4.0f);
-	// Z-
-	NoiseGenerator_ZNeg = CreateNoiseGenerator(params, seed + 50, this);
-	ZNegHeight = CreateFlatNoiseArray(NoiseGenerator_ZNeg, resolution, 5.0f);
+	TArray<FOP_NoiseCubeChannel> channels;
+	channels.Add(FOP_NoiseCubeChannel(params, seed));
+
+	return Init(resolution, channels);
 }
 
+FOP_NoiseCubeDataPtr UOP_NoiseCube::GenerateNoiseCube(const FOP_NoiseCubeKey& key)
+{
+	return BuildNoiseCube(key, CreateChannelGenerators(key));
+}
 
-float UOP_NoiseCube::SampleNoiseCube(FVector normal)
+TArray<FFastNoise> UOP_NoiseCube::CreateChannelGenerators(const FOP_NoiseCubeKey& key)
 {
-	return GetXHeight(normal.X, normal) + GetYHeight(normal.Y, normal) + GetZHeight(normal.Z, normal);
+	TArray<FFastNoise> channelGenerators;
+	channelGenerators.Reserve(key.Channels.Num());
+	for (const FOP_NoiseCubeChannel& channel : key.Channels)
+	{
+		channelGenerators.Add(CreateNoiseGenerator(channel.Params, channel.Seed));
+	}
+	return channelGenerators;
 }
 
-TArray<UTexture2D*> UOP_NoiseCube::GetCubeTextures()
+FOP_NoiseCubeDataPtr UOP_NoiseCube::BuildNoiseCube(const FOP_NoiseCubeKey& key, const TArray<FFastNoise>& channelGenerators, const FThreadSafeBool* cancelled)
 {
-	TArray<UTexture2D*> cubeTextures;
-	cubeTextures.Add(NoiseToTexture(XPosHeight, Resolution, this, TEXT("XPos")));
-	cubeTextures.Add(NoiseToTexture(XNegHeight, Resolution, this, TEXT("XNeg")));
-	cubeTextures.Add(NoiseToTexture(YPosHeight, Resolution, this, TEXT("YPos")));
-	cubeTextures.Add(NoiseToTexture(YNegHeight, Resolution, this, TEXT("YNeg")));
-	cubeTextures.Add(NoiseToTexture(ZPosHeight, Resolution, this, TEXT("ZPos")));
-	cubeTextures.Add(NoiseToTexture(ZNegHeight, Resolution, this, TEXT("ZNeg")));
+	TSharedRef<FOP_NoiseCubeData, ESPMode::ThreadSafe> data = MakeShared<FOP_NoiseCubeData, ESPMode::ThreadSafe>();
+	data->Key = key;
+	data->Resolution = key.Resolution;
+	data->NumChannels = key.Channels.Num();
+	data->Storage = key.Storage;
 
-	return cubeTextures;
+	const int32 faceSize = key.Resolution * key.Resolution * key.Channels.Num();
+	const bool bQuantize = key.Storage == EOP_NoiseCubeStorage::Quantized16;
+
+	// Quantized faces are generated into a scratch face first as the range has to be known before quantizing
+	TArray<float> scratchFace;
+	if (bQuantize)
+	{
+		data->QuantizedTexels.SetNumUninitialized((int32)EOP_CubeFace::Count * faceSize);
+		data->QuantizedMin.SetNumZeroed((int32)EOP_CubeFace::Count * key.Channels.Num());
+		data->QuantizedScale.SetNumZeroed((int32)EOP_CubeFace::Count * key.Channels.Num());
+		scratchFace.SetNumUninitialized(faceSize);
+	}
+	else
+	{
+		data->Texels.SetNumUninitialized((int32)EOP_CubeFace::Count * faceSize);
+	}
+
+	// Each face offsets the seed by 10 so the faces don't repeat each other. The reseeded generators are made up front
+	// and kept for the whole build, their permutation tables are only shared while something holds on to them
+	const int32 numChannels = key.Channels.Num();
+	TArray<FFastNoise> faceGenerators;
+	faceGenerators.Reserve((int32)EOP_CubeFace::Count * numChannels);
+	for (int32 face = 0; face < (int32)EOP_CubeFace::Count; face++)
+	{
+		for (const FFastNoise& channelGenerator : channelGenerators)
+		{
+			faceGenerators.Add(channelGenerator.WithSeedOffset(face * 10));
+		}
+	}
+
+	for (int32 face = 0; face < (int32)EOP_CubeFace::Count; face++)
+	{
+		if (cancelled && *cancelled)
+		{
+			return nullptr;
+		}
+
+		float* faceTexels = bQuantize ? scratchFace.GetData() : &data->Texels[data->GetTexelIndex((EOP_CubeFace)face, 0, 0)];
+		FillFlatNoiseFace(&faceGenerators[face * numChannels], numChannels, key.Resolution, (float)face, faceTexels);
+
+		if (bQuantize)
+		{
+			QuantizeFace(*data, (EOP_CubeFace)face, faceTexels);
+		}
+	}
+
+	if (bQuantize)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Noise cube quantized to 16 bits, %d KB, max error %f"), (int32)(data->GetTexelBytes() / 1024), data->MaxQuantizationError);
+	}
+
+	return data;
 }
 
-void UOP_NoiseCube::GenerateNoiseCube()
+bool UOP_NoiseCube::MakeKey(int resolution, const TArray<FOP_NoiseCubeChannel>& channels, EOP_NoiseCubeStorage storage, FOP_NoiseCubeKey& outKey)
 {
+	if (channels.Num() == 0 || channels.Num() > MaxChannels)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("UOP_NoiseCube::Init needs between 1 and %d channels, got %d"), MaxChannels, channels.Num());
+		return false;
+	}
 
+	outKey = FOP_NoiseCubeKey(channels, resolution, storage);
+	return true;
 }
 
-UTexture2D * UOP_NoiseCube::NoiseToTexture(TArray<float> data, int resolution, UObject* outer, FString name)
+FOP_NoiseCubeDataPtr UOP_NoiseCube::FindBakedData(const FOP_NoiseCubeKey& key, const UOP_NoiseCubeAsset* bakedAsset)
 {
-	TArray<FColor> colorMap;
-	colorMap.Init(FColor::Black, resolution * resolution);
-	float step = 1.0f / resolution;
-	int index = 0;
-	for (int y = 0; y < resolution; y++)
+	// Baked data goes through the cache too, so other planets with the same parameters share it
+	FOP_NoiseCubeDataPtr bakedData = bakedAsset ? bakedAsset->GetData(key) : nullptr;
+	if (bakedAsset && !bakedData.IsValid())
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s doesn't match the noise parameters, generating the noise cube instead"), *bakedAsset->GetPathName());
+	}
+	return bakedData;
+}
+
+bool UOP_NoiseCube::IsCurrentKey(const FOP_NoiseCubeKey& key) const
+{
+	// While refining, the data is a lower resolution preview of RefineKey
+	if (IsRefining())
+	{
+		return RefineKey == key;
+	}
+	return Data.IsValid() && Data->Key == key;
+}
+
+void UOP_NoiseCube::SetData(const FOP_NoiseCubeDataPtr& data)
+{
+	Data = data;
+	CachedTextures.Empty();
+
+	Resolution = Data.IsValid() ? Data->Resolution : 0;
+	ResStep = Resolution > 0 ? 1.0f / Resolution : 0.0f;
+}
+
+void UOP_NoiseCube::SampleNoiseCube(const FVector& normal, float* outChannels) const
+{
+	const int32 numChannels = GetNumChannels();
+	for (int32 c = 0; c < numChannels; c++)
+	{
+		outChannels[c] = 0.0f;
+	}
+
+	if (!Data.IsValid())
+	{
+		return;
+	}
+
+	AccumulateAxis(normal.X, normal.Y, normal.Z, EOP_CubeFace::XPos, EOP_CubeFace::XNeg, outChannels);
+	AccumulateAxis(normal.Y, normal.X, normal.Z, EOP_CubeFace::YPos, EOP_CubeFace::YNeg, outChannels);
+	AccumulateAxis(normal.Z, normal.X, normal.Y, EOP_CubeFace::ZPos, EOP_CubeFace::ZNeg, outChannels);
+}
+
+float UOP_NoiseCube::SampleNoiseCube(FVector normal) const
+{
+	float channels[MaxChannels];
+	SampleNoiseCube(normal, channels);
+	return Data.IsValid() ? channels[0] : 0.0f;
+}
+
+TArray<UTexture2D*> UOP_NoiseCube::GetCubeTextures(int32 channel, EOP_NoiseTextureFormat format)
+{
+	TArray<UTexture2D*> cubeTextures;
+	if (!Data.IsValid() || channel < 0 || channel >= Data->NumChannels)
+	{
+		return cubeTextures;
+	}
+
+	static const TCHAR* faceNames[] = { TEXT("XPos"), TEXT("XNeg"), TEXT("YPos"), TEXT("YNeg"), TEXT("ZPos"), TEXT("ZNeg") };
+	const int32 numFaces = (int32)EOP_CubeFace::Count;
+
+	CachedTextures.SetNumZeroed((int32)EOP_NoiseTextureFormat::Count * Data->NumChannels * numFaces);
+	const int32 firstFace = ((int32)format * Data->NumChannels + channel) * numFaces;
+
+	for (int32 face = 0; face < numFaces; face++)
 	{
-		for (int x = 0; x < resolution; x++)
+		UTexture2D*& texture = CachedTextures[firstFace + face];
+		if (texture == nullptr)
 		{
-			float height = data[(y * resolution) + x];
-			colorMap[index] = FColor(height * 255, height * 255, height * 255);
+			FName name = MakeUniqueObjectName(this, UTexture2D::StaticClass(), *FString::Printf(TEXT("Noise_%s_%d"), faceNames[face], channel));
+			texture = NoiseToTexture(*Data, (EOP_CubeFace)face, channel, format, this, name);
+		}
+		cubeTextures.Add(texture);
+	}
+
+	return cubeTextures;
+}
+
+UTexture2D * UOP_NoiseCube::NoiseToTexture(const FOP_NoiseCubeData& data, EOP_CubeFace face, int32 channel, EOP_NoiseTextureFormat format, UObject* outer, FName name)
+{
+	static const EPixelFormat pixelFormats[] = { PF_R32_FLOAT, PF_R16F, PF_G16 };
+	static const int32 bytesPerPixel[] = { sizeof(float), sizeof(FFloat16), sizeof(uint16) };
+
+	const int32 resolution = data.Resolution;
+
+	UTexture2D* texture = NewObject<UTexture2D>(outer, name, RF_Transient);
+	texture->PlatformData = new FTexturePlatformData();
+	texture->PlatformData->SizeX = resolution;
+	texture->PlatformData->SizeY = resolution;
+	texture->PlatformData->PixelFormat = pixelFormats[(int32)format];
+	texture->SRGB = false;
+	texture->CompressionSettings = TC_HDR;
+
+	FTexture2DMipMap* mip = new(texture->PlatformData->Mips) FTexture2DMipMap();
+	mip->SizeX = resolution;
+	mip->SizeY = resolution;
+	mip->BulkData.Lock(LOCK_READ_WRITE);
+	void* mipData = mip->BulkData.Realloc(resolution * resolution * bytesPerPixel[(int32)format]);
+
+	// Write each texel straight into the mip, converting from the cube's storage as we go
+	int32 index = 0;
+	for (int32 y = 0; y < resolution; y++)
+	{
+		for (int32 x = 0; x < resolution; x++)
+		{
+			const float height = data.GetValue(face, x, y, channel);
+			switch (format)
+			{
+			case EOP_NoiseTextureFormat::Float32:
+				static_cast<float*>(mipData)[index] = height;
+				break;
+			case EOP_NoiseTextureFormat::Float16:
+				static_cast<FFloat16*>(mipData)[index] = FFloat16(height);
+				break;
+			case EOP_NoiseTextureFormat::Unorm16:
+				static_cast<uint16*>(mipData)[index] = (uint16)FMath::RoundToInt(FMath::Clamp(height, 0.0f, 1.0f) * MAX_uint16);
+				break;
+			}
 			index++;
 		}
 	}
 
-	FString imgName = TEXT("Noise ") + name;
+	mip->BulkData.Unlock();
+	texture->UpdateResource();
 
-	FCreateTexture2DParameters params;
-	return FImageUtils::CreateTexture2D(resolution,
-		resolution,
-		colorMap,
-		outer,
-		imgName,
-		EObjectFlags::RF_Transient,
-		params);
+	return texture;
 }
 
-UFastNoise * UOP_NoiseCube::CreateNoiseGenerator(FNoiseGeneratorParameters params, int32 seed, UObject* outer)
+FFastNoise UOP_NoiseCube::CreateNoiseGenerator(FNoiseGeneratorParameters params, int32 seed)
 {
-
-	UFastNoise* noiseGen = NewObject<UFastNoise>(outer);
+	FFastNoise noiseGen(seed);
 
 	switch (params.NoiseType)
 	{
 	case EFractalNoiseType::FractalGradient:
-		noiseGen->SetNoiseType(ENoiseType::GradientFractal);
+		noiseGen.SetNoiseType(ENoiseType::GradientFractal);
 		break;
 	case EFractalNoiseType::FractalSimplex:
-		noiseGen->SetNoiseType(ENoiseType::SimplexFractal);
+		noiseGen.SetNoiseType(ENoiseType::SimplexFractal);
 		break;
 	case EFractalNoiseType::FractalValue:
-		noiseGen->SetNoiseType(ENoiseType::ValueFractal);
+		noiseGen.SetNoiseType(ENoiseType::ValueFractal);
 		break;
 	}
 
-	noiseGen->SetSeed(seed);
-	noiseGen->SetFractalOctaves(params.Octaves);
-	noiseGen->SetFrequency(params.Frequency);
-	noiseGen->SetFractalType(params.FractalType);
-	noiseGen->SetFractalGain(params.FractalGain);
-	noiseGen->SetFractalLacunarity(params.Lacunarity);
-	noiseGen->SetInterp(params.Interpolation);
+	noiseGen.SetFractalOctaves(params.Octaves);
+	noiseGen.SetFrequency(params.Frequency);
+	noiseGen.SetFractalType(params.FractalType);
+	noiseGen.SetFractalGain(params.FractalGain);
+	noiseGen.SetFractalLacunarity(params.Lacunarity);
+	noiseGen.SetInterp(params.Interpolation);
 
 	return noiseGen;
 }
 
-TArray<float> UOP_NoiseCube::CreateFlatNoiseArray(UFastNoise * noiseGen, int resolution, float offset)
+void UOP_NoiseCube::FillFlatNoiseFace(const FFastNoise* channelGenerators, int32 numChannels, int32 resolution, float offset, float* outTexels)
 {
-	if (noiseGen == nullptr)
-	{
-		UE_LOG(LogTemp, Warning, TEXT("UOP_NoiseCube::CreateFlatNoiseArray noiseGen is null"));
-		return TArray<float>();
-	}
-	
-	// Init the array to the desired resolution
-	TArray<float> flatArray;
-	flatArray.Init(0.0f, resolution * resolution);
 
 	// Constrain the sampled noise to between 0 and 1 for consistency between resolutions
 	float step = 1.0f / resolution;
 
+	// Each channel fills a row at a time, then the rows are interleaved into the texels
+	TArray<float> row;
+	row.SetNumUninitialized(resolution);
+
 	for (int y = 0; y < resolution; y++)
 	{
-		for (int x = 0; x < resolution; x++)
+		const FVector2D origin(offset, y * step);
+		for (int32 c = 0; c < numChannels; c++)
 		{
-			// Get the height at the coordinate
-			float xPos = offset + (x * step);
-			float yPos = y * step;
-			flatArray[(y * resolution) + x] = noiseGen->GetNoise2D(xPos, yPos);
+			// The texel spacing is the footprint, octaves finer than that would only alias at this resolution
+			channelGenerators[c].FillNoiseGrid2D(origin, FVector2D(step, step), FIntPoint(resolution, 1), row.GetData(), step);
+
+			float* texel = outTexels + c;
+			for (int x = 0; x < resolution; x++, texel += numChannels)
+			{
+				*texel = row[x];
+			}
 		}
+		outTexels += resolution * numChannels;
 	}
-
-	return flatArray;
 }
 
-float UOP_NoiseCube::GetXHeight(float perc, FVector pos)
+void UOP_NoiseCube::QuantizeFace(FOP_NoiseCubeData& data, EOP_CubeFace face, const float* faceTexels)
 {
-	int32 y = ((pos.Y + 1.0f) / 2.0f) / ResStep;
-	int32 z = ((pos.Z + 1.0f) / 2.0f) / ResStep;
-	int32 index = ((z * Resolution) + y);
-	if (index >= XPosHeight.Num() || index >= XNegHeight.Num())
+	const int32 numChannels = data.NumChannels;
+	const int32 numTexels = data.Resolution * data.Resolution;
+	uint16* outTexels = &data.QuantizedTexels[data.GetTexelIndex(face, 0, 0)];
+
+	for (int32 c = 0; c < numChannels; c++)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("UOP_NoiseCube::GetXHeight out of array bounds"));
-		return 0.0f;
+		float minValue = MAX_FLT;
+		float maxValue = -MAX_FLT;
+		for (int32 i = 0; i < numTexels; i++)
+		{
+			minValue = FMath::Min(minValue, faceTexels[i * numChannels + c]);
+			maxValue = FMath::Max(maxValue, faceTexels[i * numChannels + c]);
+		}
+
+		// A flat face still needs a non zero scale to avoid dividing by zero
+		const float scale = FMath::Max(maxValue - minValue, SMALL_NUMBER) / MAX_uint16;
+		const float invScale = 1.0f / scale;
+
+		const int32 range = (int32)face * numChannels + c;
+		data.QuantizedMin[range] = minValue;
+		data.QuantizedScale[range] = scale;
+
+		for (int32 i = 0; i < numTexels; i++)
+		{
+			const float value = faceTexels[i * numChannels + c];
+			const uint16 quantized = (uint16)FMath::Clamp(FMath::RoundToInt((value - minValue) * invScale), 0, (int32)MAX_uint16);
+			outTexels[i * numChannels + c] = quantized;
+
+			const float error = FMath::Abs(value - (minValue + quantized * scale));
+			data.MaxQuantizationError = FMath::Max(data.MaxQuantizationError, error);
+		}
 	}
-	return FMath::Abs(perc) * (perc > 0.0f ? XPosHeight[index] : XNegHeight[FMath::Abs(index)]);
 }
 
-float UOP_NoiseCube::GetYHeight(float perc, FVector pos)
+void UOP_NoiseCube::AccumulateAxis(float perc, float u, float v, EOP_CubeFace posFace, EOP_CubeFace negFace, float* outChannels) const
 {
-	int32 x = ((pos.X + 1.0f) / 2.0f) / ResStep;
-	int32 z = ((pos.Z + 1.0f) / 2.0f) / ResStep;
-	int32 index = ((z * Resolution) + x);
-	if (index >= YPosHeight.Num() || index >= YNegHeight.Num())
+	// Map the other two axes from -1..1 to texel coordinates, clamped so normals on the cube edges stay on the face
+	int32 x = FMath::Clamp((int32)(((u + 1.0f) / 2.0f) / ResStep), 0, Resolution - 1);
+	int32 y = FMath::Clamp((int32)(((v + 1.0f) / 2.0f) / ResStep), 0, Resolution - 1);
+
+	const float weight = FMath::Abs(perc);
+	const EOP_CubeFace face = perc > 0.0f ? posFace : negFace;
+
+	if (Data->Storage == EOP_NoiseCubeStorage::Quantized16)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("UOP_NoiseCube::GetYHeight out of array bounds"));
-		return 0.0f;
+		// Dequantize with the weight folded in: weight * (min + q * scale) = weight * min + q * (weight * scale)
+		const uint16* texel = Data->GetQuantizedTexel(face, x, y);
+		const float* faceMin = &Data->QuantizedMin[(int32)face * Data->NumChannels];
+		const float* faceScale = &Data->QuantizedScale[(int32)face * Data->NumChannels];
+		for (int32 c = 0; c < Data->NumChannels; c++)
+		{
+			outChannels[c] += weight * faceMin[c] + texel[c] * (weight * faceScale[c]);
+		}
+		return;
 	}
-	return FMath::Abs(perc) * (perc > 0.0f ? YPosHeight[index] : YNegHeight[FMath::Abs(index)]);
-}
 
-float UOP_NoiseCube::GetZHeight(float perc, FVector pos)
-{
-	//int32 x = FMath::Abs(pos.X / ResStep);
-	//int32 y = FMath::Abs(pos.Y / ResStep);
-	int32 x = ((pos.X + 1.0f) / 2.0f) / ResStep;
-	int32 y = ((pos.Y + 1.0f) / 2.0f) / ResStep;
-	int32 index = ((y * Resolution) + x);
-	if (index >= ZPosHeight.Num() || index >= ZNegHeight.Num())
+	const float* texel = Data->GetTexel(face, x, y);
+	for (int32 c = 0; c < Data->NumChannels; c++)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("UOP_NoiseCube::GetZHeight out of array bounds"));
-		return 0.0f;
+		outChannels[c] += weight * texel[c];
 	}
-	return FMath::Abs(perc) * (perc > 0.0f ? ZPosHeight[index] : ZNegHeight[FMath::Abs(index)]);
 }
@@ -0,0 +1,136 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OP_NoiseCubeAsset.h"
+#include "Serialization/MemoryWriter.h"
+
+// Bump when the layout written by Serialize or the values generated for a key change, older assets are then skipped
+// and regenerated. 3: fractal octaves are cut off at the sample footprint
+static const int32 NoiseCubeAssetVersion = 3;
+
+static void SerializeNoiseCubeKey(FArchive& Ar, FOP_NoiseCubeKey& key)
+{
+	Ar << key.Resolution;
+
+	uint8 storage = (uint8)key.Storage;
+	Ar << storage;
+	key.Storage = (EOP_NoiseCubeStorage)storage;
+
+	int32 numChannels = key.Channels.Num();
+	Ar << numChannels;
+	if (Ar.IsLoading())
+	{
+		key.Channels.SetNum(numChannels);
+	}
+
+	for (FOP_NoiseCubeChannel& channel : key.Channels)
+	{
+		FNoiseGeneratorParameters& params = channel.Params;
+
+		uint8 noiseType = (uint8)params.NoiseType;
+		uint8 interpolation = (uint8)params.Interpolation;
+		uint8 fractalType = (uint8)params.FractalType;
+		Ar << noiseType << interpolation << fractalType;
+		params.NoiseType = (EFractalNoiseType)noiseType;
+		params.Interpolation = (EInterp)interpolation;
+		params.FractalType = (EFractalType)fractalType;
+
+		Ar << params.Frequency << params.FractalGain << params.Octaves << params.Lacunarity;
+		Ar << channel.Seed;
+	}
+}
+
+static void SerializeNoiseCubePayload(FArchive& Ar, FOP_NoiseCubeData& data)
+{
+	SerializeNoiseCubeKey(Ar, data.Key);
+
+	data.Texels.BulkSerialize(Ar);
+	data.QuantizedTexels.BulkSerialize(Ar);
+	Ar << data.QuantizedMin << data.QuantizedScale << data.MaxQuantizationError;
+}
+
+void UOP_NoiseCubeAsset::Bake(const FOP_NoiseCubeDataPtr& data)
+{
+	Modify();
+	Data = data;
+}
+
+FOP_NoiseCubeDataPtr UOP_NoiseCubeAsset::GetData(const FOP_NoiseCubeKey& key) const
+{
+	if (Data.IsValid() && Data->Key == key)
+	{
+		return Data;
+	}
+	return nullptr;
+}
+
+void UOP_NoiseCubeAsset::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	// Nothing here references objects, and the cube is too large to copy for archives that only look for them
+	if (Ar.IsObjectReferenceCollector())
+	{
+		return;
+	}
+
+	int32 version = NoiseCubeAssetVersion;
+	Ar << version;
+
+	bool bHasData = Data.IsValid();
+	Ar << bHasData;
+
+	if (Ar.IsLoading())
+	{
+		Data = nullptr;
+
+		// Version 1 wrote the payload without its size, the layout is otherwise the same
+		int64 payloadSize = 0;
+		if (version >= 2)
+		{
+			Ar << payloadSize;
+		}
+
+		if (!bHasData)
+		{
+			return;
+		}
+
+		TSharedRef<FOP_NoiseCubeData, ESPMode::ThreadSafe> data = MakeShared<FOP_NoiseCubeData, ESPMode::ThreadSafe>();
+		if (version != NoiseCubeAssetVersion)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s was baked with a different version, the noise cube will be regenerated"), *GetPathName());
+			if (version >= 2)
+			{
+				Ar.Seek(Ar.Tell() + payloadSize);
+			}
+			else
+			{
+				SerializeNoiseCubePayload(Ar, *data);
+			}
+			return;
+		}
+
+		SerializeNoiseCubePayload(Ar, *data);
+		data->Resolution = data->Key.Resolution;
+		data->NumChannels = data->Key.Channels.Num();
+		data->Storage = data->Key.Storage;
+
+		Data = data;
+	}
+	else
+	{
+		// The data is shared with every planet using it, so it is written from a copy rather than cast to mutable. The
+		// payload goes through a buffer first so its size can be written ahead of it
+		TArray<uint8> payload;
+		if (bHasData)
+		{
+			FOP_NoiseCubeData data = *Data;
+			FMemoryWriter writer(payload, true);
+			SerializeNoiseCubePayload(writer, data);
+		}
+
+		int64 payloadSize = payload.Num();
+		Ar << payloadSize;
+		Ar.Serialize(payload.GetData(), payload.Num());
+	}
+}
@@ -0,0 +1,102 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OP_NoiseCubeBudget.h"
+#include "OP_ProceduralPlanet.h"
+#include "OP_NoiseCube.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarNoiseCubeBudgetMB(
+	TEXT("op.NoiseCubeBudgetMB"),
+	64,
+	TEXT("Memory in MB shared by the noise cubes of all planets using an automatic noise cube resolution.\n")
+	TEXT("Takes effect the next time a planet is spawned or destroyed."),
+	ECVF_Default);
+
+FOP_NoiseCubeBudget& FOP_NoiseCubeBudget::Get()
+{
+	static FOP_NoiseCubeBudget Instance;
+	return Instance;
+}
+
+void FOP_NoiseCubeBudget::Register(AOP_ProceduralPlanet* planet)
+{
+	Planets.AddUnique(planet);
+}
+
+void FOP_NoiseCubeBudget::Unregister(AOP_ProceduralPlanet* planet)
+{
+	Planets.Remove(planet);
+}
+
+int64 FOP_NoiseCubeBudget::GetBudgetBytes()
+{
+	return (int64)FMath::Max(CVarNoiseCubeBudgetMB.GetValueOnGameThread(), 0) * 1024 * 1024;
+}
+
+void FOP_NoiseCubeBudget::Rebalance()
+{
+	Planets.RemoveAll([](const TWeakObjectPtr<AOP_ProceduralPlanet>& planet) { return !planet.IsValid(); });
+
+	struct FAllocation
+	{
+		AOP_ProceduralPlanet* Planet;
+		int32 Resolution;
+		int32 NumChannels;
+		EOP_NoiseCubeStorage Storage;
+	};
+
+	// Planets sharing a cube through FOP_NoiseCubeCache are counted once each, so the total errs on the high side
+	TArray<FAllocation> allocations;
+	int64 totalBytes = 0;
+	for (const TWeakObjectPtr<AOP_ProceduralPlanet>& planet : Planets)
+	{
+		FOP_NoiseCubeKey key = planet->MakeNoiseCubeKey();
+		if (!planet->bAutoNoiseCubeResolution)
+		{
+			// Fixed resolutions aren't changed but still use up the budget
+			totalBytes += FOP_NoiseCubeData::EstimateTexelBytes(key.Resolution, key.Channels.Num(), key.Storage);
+			continue;
+		}
+
+		FAllocation allocation;
+		allocation.Planet = planet.Get();
+		allocation.Resolution = planet->GetDesiredNoiseCubeResolution();
+		allocation.NumChannels = key.Channels.Num();
+		allocation.Storage = key.Storage;
+		allocations.Add(allocation);
+
+		totalBytes += FOP_NoiseCubeData::EstimateTexelBytes(allocation.Resolution, allocation.NumChannels, allocation.Storage);
+	}
+
+	// Halve the planet with the finest texels until everything fits
+	const int64 budgetBytes = GetBudgetBytes();
+	while (totalBytes > budgetBytes)
+	{
+		FAllocation* finest = nullptr;
+		float finestTexelSize = MAX_FLT;
+		for (FAllocation& allocation : allocations)
+		{
+			float texelSize = allocation.Planet->GetNoiseCubeTexelSize(allocation.Resolution);
+			if (allocation.Resolution > MinResolution && texelSize < finestTexelSize)
+			{
+				finest = &allocation;
+				finestTexelSize = texelSize;
+			}
+		}
+
+		if (finest == nullptr)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Noise cubes need %d KB, over the %d KB budget even at the lowest resolution"), (int32)(totalBytes / 1024), (int32)(budgetBytes / 1024));
+			break;
+		}
+
+		totalBytes -= FOP_NoiseCubeData::EstimateTexelBytes(finest->Resolution, finest->NumChannels, finest->Storage);
+		finest->Resolution /= 2;
+		totalBytes += FOP_NoiseCubeData::EstimateTexelBytes(finest->Resolution, finest->NumChannels, finest->Storage);
+	}
+
+	for (const FAllocation& allocation : allocations)
+	{
+		allocation.Planet->SetAutoNoiseCubeResolution(allocation.Resolution);
+	}
+}
@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OP_NoiseCubeCache.h"
+
+FOP_NoiseCubeCache& FOP_NoiseCubeCache::Get()
+{
+	static FOP_NoiseCubeCache Instance;
+	return Instance;
+}
+
+FOP_NoiseCubeDataPtr FOP_NoiseCubeCache::Find(const FOP_NoiseCubeKey& key)
+{
+	return Cubes.Find(key);
+}
+
+FOP_NoiseCubeDataPtr FOP_NoiseCubeCache::FindOrGenerate(const FOP_NoiseCubeKey& key, TFunctionRef<FOP_NoiseCubeDataPtr()> generator)
+{
+	// Generation takes a while, it runs outside the cache's lock
+	return Cubes.FindOrCreate(key, generator);
+}
+
+int32 FOP_NoiseCubeCache::Num()
+{
+	return Cubes.Num();
+}
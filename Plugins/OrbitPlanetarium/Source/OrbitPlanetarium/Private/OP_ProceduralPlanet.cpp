@@ -9,7 +9,10 @@
 #include "Kismet/GameplayStatics.h"
 #include "ImageUtils.h"
 #include "Engine/Texture2D.h"
+#include "Engine/World.h"
 #include "OP_NoiseCube.h"
+#include "OP_NoiseCubeAsset.h"
+#include "OP_NoiseCubeBudget.h"
 
 FString UOP_PlanetData::ToString()
 {
@@ -49,24 +52,153 @@ void AOP_ProceduralPlanet::BeginPlay()
 	// Get references
 	PlayerPawn = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
 
+	// Share the noise budget with the new planet before generating
+	FOP_NoiseCubeBudget::Get().Register(this);
+	FOP_NoiseCubeBudget::Get().Rebalance();
+
 	// Check the LOD, this also generates the planet if the LOD has changed
 	CheckLODRange(true);
 
 }
 
-void AOP_ProceduralPlanet::GenerateNoiseCubes()
+bool AOP_ProceduralPlanet::GenerateNoiseCubes(bool bFullResolution)
+{
+	if (NoiseCube == nullptr)
+	{
+		NoiseCube = NewObject<UOP_NoiseCube>(this);
+	}
+
+	FOP_NoiseCubeKey key = MakeNoiseCubeKey();
+
+#if WITH_EDITOR
+	// In the editor show a low resolution preview straight away and refine it in the background, so iterating on the parameters is quick
+	UWorld* world = GetWorld();
+	if (world && !world->IsGameWorld() && !bFullResolution)
+	{
+		TWeakObjectPtr<AOP_ProceduralPlanet> weakThis(this);
+		return NoiseCube->InitProgressive(key.Resolution, key.Channels, key.Storage, BakedNoiseCube, [weakThis]()
+		{
+			if (AOP_ProceduralPlanet* planet = weakThis.Get())
+			{
+				planet->CachedLODLevels.Empty();
+				planet->GeneratePlanet(true);
+			}
+		});
+	}
+#endif
+
+	// Init only generates when no cube with the same parameters exists, so this is cheap when nothing has changed
+	return NoiseCube->Init(key.Resolution, key.Channels, key.Storage, BakedNoiseCube);
+}
+
+FOP_NoiseCubeKey AOP_ProceduralPlanet::MakeNoiseCubeKey() const
+{
+	// Terrain and roughness are generated together as two channels of the same cube
+	TArray<FOP_NoiseCubeChannel> channels;
+	channels.Add(FOP_NoiseCubeChannel(FNoiseGeneratorParameters(NoiseType, Frequency, FractalGain, Interpolation, FractalType, Octaves, Lacunarity), Seed));
+	channels.Add(FOP_NoiseCubeChannel(FNoiseGeneratorParameters(RoughNoiseType, RoughFrequency, RoughFractalGain, RoughInterpolation, RoughFractalType, RoughOctaves, RoughLacunarity), Seed));
+
+	return FOP_NoiseCubeKey(channels, GetNoiseCubeResolution(), bQuantizeNoiseCube ? EOP_NoiseCubeStorage::Quantized16 : EOP_NoiseCubeStorage::Float);
+}
+
+int32 AOP_ProceduralPlanet::GetNoiseCubeResolution() const
+{
+	if (!bAutoNoiseCubeResolution)
+	{
+		return NoiseCubeResolution;
+	}
+	return AutoNoiseCubeResolution > 0 ? AutoNoiseCubeResolution : GetDesiredNoiseCubeResolution();
+}
+
+int32 AOP_ProceduralPlanet::GetDesiredNoiseCubeResolution() const
+{
+	// The mesh is built around a sphere of radius |1 - Radius| before the actor scale is applied
+	const float worldRadius = FMath::Abs(1.0f - Radius) * GetActorScale3D().GetMax();
+
+	// Icosphere edges are 1.05 * radius at LOD 0 and halve each LOD, texels finer than that can't be shown
+	const int32 maxLOD = bOverrideLOD ? currentLOD : 8;
+	const float vertexSpacing = 1.0515f * worldRadius / (1 << maxLOD);
+	const float texelSize = FMath::Max3(NoiseCubeTargetTexelSize, vertexSpacing, KINDA_SMALL_NUMBER);
+
+	// A cube face spans a quarter of the circumference
+	const float texels = ((PI / 2.0f) * worldRadius) / texelSize;
+	int32 resolution = FMath::Clamp((int32)FMath::RoundUpToPowerOfTwo(FMath::Max(FMath::CeilToInt(texels), 1)), (int32)FOP_NoiseCubeBudget::MinResolution, 2048);
+
+	// A single planet never asks for more than the whole budget
+	const EOP_NoiseCubeStorage storage = bQuantizeNoiseCube ? EOP_NoiseCubeStorage::Quantized16 : EOP_NoiseCubeStorage::Float;
+	while (resolution > FOP_NoiseCubeBudget::MinResolution && FOP_NoiseCubeData::EstimateTexelBytes(resolution, NoiseChannel_Count, storage) > FOP_NoiseCubeBudget::GetBudgetBytes())
+	{
+		resolution /= 2;
+	}
+	return resolution;
+}
+
+float AOP_ProceduralPlanet::GetNoiseCubeTexelSize(int32 resolution) const
+{
+	// The mesh is built around a sphere of radius |1 - Radius| before the actor scale is applied
+	const float worldRadius = FMath::Abs(1.0f - Radius) * GetActorScale3D().GetMax();
+	return ((PI / 2.0f) * worldRadius) / FMath::Max(resolution, 1);
+}
+
+void AOP_ProceduralPlanet::SetAutoNoiseCubeResolution(int32 resolution)
+{
+	if (resolution == AutoNoiseCubeResolution)
+	{
+		return;
+	}
+
+	const bool bWasGenerated = NoiseCube != nullptr;
+	AutoNoiseCubeResolution = resolution;
+
+	// Planets that haven't generated yet pick the new resolution up when they do. The others wait for their tick, so a
+	// level spawning many planets rebalances once per planet but regenerates each at most once per frame
+	if (bAutoNoiseCubeResolution && bWasGenerated)
+	{
+		bNoiseCubeResolutionChanged = true;
+	}
+}
+
+#if WITH_EDITOR
+void AOP_ProceduralPlanet::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Stop refining noise that no longer matches the parameters
+	if (NoiseCube && NoiseCube->IsRefining() && !NoiseCube->IsRefiningTo(MakeNoiseCubeKey()))
+	{
+		NoiseCube->CancelRefinement();
+	}
+}
+#endif
+
+void AOP_ProceduralPlanet::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	NoiseCube = NewObject<UOP_NoiseCube>(this);
-	NoiseCube->Init(256, NoiseType, Seed, Frequency, FractalGain, Interpolation, FractalType, Octaves, Lacunarity);
+	Super::EndPlay(EndPlayReason);
 
-	RoughNoiseCube = NewObject<UOP_NoiseCube>(this);
-	RoughNoiseCube->Init(256, RoughNoiseType, Seed, RoughFrequency, RoughFractalGain, RoughInterpolation, RoughFractalType, RoughOctaves, RoughLacunarity);
+	// Give the planet's share of the noise budget back to the others
+	FOP_NoiseCubeBudget::Get().Unregister(this);
+	if (EndPlayReason == EEndPlayReason::Destroyed || EndPlayReason == EEndPlayReason::RemovedFromWorld)
+	{
+		FOP_NoiseCubeBudget::Get().Rebalance();
+	}
 }
 
 // Called every frame
 void AOP_ProceduralPlanet::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+
+	// A later rebalance may have given the planet its old resolution back, then nothing needs regenerating
+	if (bNoiseCubeResolutionChanged)
+	{
+		bNoiseCubeResolutionChanged = false;
+		if (GenerateNoiseCubes())
+		{
+			CachedLODLevels.Empty();
+			GeneratePlanet(true);
+		}
+	}
+
 	CheckLODRange(false);
 }
 
@@ -75,10 +207,10 @@ void AOP_ProceduralPlanet::GeneratePlanet(bool bIgnoreLOD)
 	// If no procedural mesh component no point executing
 	if (ProcMeshComponent == nullptr) { return; }
 
-	// If there is no noiseCube or a seed hasn't been set, generate them
-	if (NoiseCube == nullptr || RoughNoiseCube == nullptr || !bUseSeed)
+	// Make sure the noise cubes match the current parameters, any cached LODs were displaced with the old noise
+	if (GenerateNoiseCubes())
 	{
-		GenerateNoiseCubes();
+		CachedLODLevels.Empty();
 	}
 
 	UOP_PlanetData* planetData = TryGetCachedLOD(currentLOD);
@@ -171,16 +303,15 @@ void AOP_ProceduralPlanet::GeneratePlanet(bool bIgnoreLOD)
 			//float height = GetCubemapHeight(planetData->Vertices[i], vNormal);
 
 			float height = 0.0f;
-			// Get height from noiseCube
-			if (NoiseCube)
+			// Get terrain and roughness from the noiseCube in one sample
+			if (NoiseCube && NoiseCube->GetNumChannels() == NoiseChannel_Count)
 			{
-				height = NoiseCube->SampleNoiseCube(vNormal);
-			}
+				float channels[UOP_NoiseCube::MaxChannels];
+				NoiseCube->SampleNoiseCube(vNormal, channels);
 
-			if (RoughNoiseCube)
-			{
+				height = channels[NoiseChannel_Terrain];
 				//height *= 1.0f - RoughnessInfluence;
-				height += RoughnessInfluence * RoughNoiseCube->SampleNoiseCube(vNormal);
+				height += RoughnessInfluence * channels[NoiseChannel_Rough];
 			}
 
 			height *= Boost;
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
+#include "HAL/ThreadSafeBool.h"
 #include "UnrealFastNoisePlugin/Public/FastNoise/FastNoise.h"
 #include "OP_NoiseCube.generated.h"
 
@@ -38,12 +39,189 @@ struct FNoiseGeneratorParameters
 		Octaves = octaves;
 		Lacunarity = lacunarity;
 	}
+
+	bool operator==(const FNoiseGeneratorParameters& other) const
+	{
+		return NoiseType == other.NoiseType
+			&& Frequency == other.Frequency
+			&& FractalGain == other.FractalGain
+			&& Interpolation == other.Interpolation
+			&& FractalType == other.FractalType
+			&& Octaves == other.Octaves
+			&& Lacunarity == other.Lacunarity;
+	}
+
+	friend uint32 GetTypeHash(const FNoiseGeneratorParameters& params)
+	{
+		uint32 hash = GetTypeHash((uint8)params.NoiseType);
+		hash = HashCombine(hash, GetTypeHash(params.Frequency));
+		hash = HashCombine(hash, GetTypeHash(params.FractalGain));
+		hash = HashCombine(hash, GetTypeHash((uint8)params.Interpolation));
+		hash = HashCombine(hash, GetTypeHash((uint8)params.FractalType));
+		hash = HashCombine(hash, GetTypeHash(params.Octaves));
+		return HashCombine(hash, GetTypeHash(params.Lacunarity));
+	}
+};
+
+// One channel of a noise cube, each channel is produced by its own generator
+struct FOP_NoiseCubeChannel
+{
+	FNoiseGeneratorParameters Params;
+	int32 Seed = 0;
+
+	FOP_NoiseCubeChannel() {}
+
+	FOP_NoiseCubeChannel(const FNoiseGeneratorParameters& params, int32 seed)
+		: Params(params)
+		, Seed(seed)
+	{
+	}
+
+	bool operator==(const FOP_NoiseCubeChannel& other) const
+	{
+		return Seed == other.Seed && Params == other.Params;
+	}
+
+	friend uint32 GetTypeHash(const FOP_NoiseCubeChannel& channel)
+	{
+		return HashCombine(GetTypeHash(channel.Params), GetTypeHash(channel.Seed));
+	}
+};
+
+// How the texels of a noise cube are stored
+enum class EOP_NoiseCubeStorage : uint8
+{
+	// Full precision floats
+	Float,
+	// uint16 normalised to the min/max range of each face and channel, half the memory of Float
+	Quantized16
+};
+
+// Everything that determines the contents of a noise cube, two cubes with equal keys hold identical data
+struct FOP_NoiseCubeKey
+{
+	TArray<FOP_NoiseCubeChannel> Channels;
+	int32 Resolution = 0;
+	EOP_NoiseCubeStorage Storage = EOP_NoiseCubeStorage::Float;
+
+	FOP_NoiseCubeKey() {}
+
+	FOP_NoiseCubeKey(const TArray<FOP_NoiseCubeChannel>& channels, int32 resolution, EOP_NoiseCubeStorage storage = EOP_NoiseCubeStorage::Float)
+		: Channels(channels)
+		, Resolution(resolution)
+		, Storage(storage)
+	{
+	}
+
+	bool operator==(const FOP_NoiseCubeKey& other) const
+	{
+		return Resolution == other.Resolution && Storage == other.Storage && Channels == other.Channels;
+	}
+
+	friend uint32 GetTypeHash(const FOP_NoiseCubeKey& key)
+	{
+		uint32 hash = HashCombine(GetTypeHash(key.Resolution), GetTypeHash((uint8)key.Storage));
+		for (const FOP_NoiseCubeChannel& channel : key.Channels)
+		{
+			hash = HashCombine(hash, GetTypeHash(channel));
+		}
+		return hash;
+	}
+};
+
+// The six faces of a cube, in the order they are stored
+enum class EOP_CubeFace : uint8
+{
+	XPos,
+	XNeg,
+	YPos,
+	YNeg,
+	ZPos,
+	ZNeg,
+	Count
+};
+
+// The generated noise for the six faces of a cube, never modified once generated so it can be shared.
+// Channels are interleaved per texel so a single sample reads every channel from one cache line
+struct FOP_NoiseCubeData
+{
+	FOP_NoiseCubeKey Key;
+
+	int32 Resolution = 0;
+	int32 NumChannels = 0;
+	EOP_NoiseCubeStorage Storage = EOP_NoiseCubeStorage::Float;
+
+	// Face major, then row, column and channel. Only one of these is filled, depending on Storage
+	TArray<float> Texels;
+	TArray<uint16> QuantizedTexels;
+
+	// Quantized16 only, per face and channel: value = QuantizedMin + quantized * QuantizedScale
+	TArray<float> QuantizedMin;
+	TArray<float> QuantizedScale;
+
+	// Quantized16 only, the largest difference between a generated value and its dequantized texel
+	float MaxQuantizationError = 0.0f;
+
+	FORCEINLINE int32 GetTexelIndex(EOP_CubeFace face, int32 x, int32 y) const
+	{
+		return ((((int32)face * Resolution) + y) * Resolution + x) * NumChannels;
+	}
+
+	FORCEINLINE const float* GetTexel(EOP_CubeFace face, int32 x, int32 y) const
+	{
+		return &Texels[GetTexelIndex(face, x, y)];
+	}
+
+	FORCEINLINE const uint16* GetQuantizedTexel(EOP_CubeFace face, int32 x, int32 y) const
+	{
+		return &QuantizedTexels[GetTexelIndex(face, x, y)];
+	}
+
+	// The value of a single channel of a texel, whatever the storage
+	FORCEINLINE float GetValue(EOP_CubeFace face, int32 x, int32 y, int32 channel) const
+	{
+		if (Storage == EOP_NoiseCubeStorage::Quantized16)
+		{
+			const int32 range = (int32)face * NumChannels + channel;
+			return QuantizedMin[range] + GetQuantizedTexel(face, x, y)[channel] * QuantizedScale[range];
+		}
+		return GetTexel(face, x, y)[channel];
+	}
+
+	// Memory used by the texels
+	SIZE_T GetTexelBytes() const
+	{
+		return Texels.GetAllocatedSize() + QuantizedTexels.GetAllocatedSize();
+	}
+
+	// Memory the texels of a cube with these settings will use
+	static int64 EstimateTexelBytes(int32 resolution, int32 numChannels, EOP_NoiseCubeStorage storage)
+	{
+		const int64 bytesPerValue = storage == EOP_NoiseCubeStorage::Quantized16 ? sizeof(uint16) : sizeof(float);
+		return (int64)EOP_CubeFace::Count * resolution * resolution * numChannels * bytesPerValue;
+	}
 };
 
+typedef TSharedPtr<const FOP_NoiseCubeData, ESPMode::ThreadSafe> FOP_NoiseCubeDataPtr;
+
 class UTexture2D;
+class UOP_NoiseCubeAsset;
+
+// Pixel formats the noise can be written to textures in
+enum class EOP_NoiseTextureFormat : uint8
+{
+	// PF_R32_FLOAT, exact copy of the noise
+	Float32,
+	// PF_R16F, half precision
+	Float16,
+	// PF_G16, the noise clamped to 0..1 and normalised to 16 bits
+	Unorm16,
+	Count
+};
 
 /**
- * 
+ * Six faces of noise projected onto the unit sphere. A cube can hold several channels (e.g. terrain and roughness)
+ * which are generated together in a single pass over each face.
  */
 UCLASS()
 class ORBITPLANETARIUM_API UOP_NoiseCube : public UObject
@@ -52,8 +230,29 @@ class ORBITPLANETARIUM_API UOP_NoiseCube : public UObject
 	
 public:
 
-	// Generate the textures and noise
-	void Init(int resolution,
+	// The most channels a single cube can hold
+	static const int32 MaxChannels = 8;
+
+	// Generate the noise, or share it from FOP_NoiseCubeCache if another cube was built with the same parameters.
+	// If bakedAsset holds data for the same parameters it is used instead of generating.
+	// Returns true if the cube data changed
+	bool Init(int resolution, const TArray<FOP_NoiseCubeChannel>& channels, EOP_NoiseCubeStorage storage = EOP_NoiseCubeStorage::Float, const UOP_NoiseCubeAsset* bakedAsset = nullptr);
+
+	// Like Init, but when the cube has to be generated a low resolution preview is generated straight away and refined
+	// up to the full resolution on a background thread. onRefined is called on the game thread each time the data improves.
+	// Calling Init or InitProgressive with different parameters cancels the refinement
+	bool InitProgressive(int resolution, const TArray<FOP_NoiseCubeChannel>& channels, EOP_NoiseCubeStorage storage, const UOP_NoiseCubeAsset* bakedAsset, TFunction<void()> onRefined);
+
+	// Stops any refinement in progress, the cube keeps the resolution it has reached
+	void CancelRefinement();
+
+	bool IsRefining() const { return RefineCancelled.IsValid(); }
+
+	// True if a refinement towards the data for key is in progress
+	bool IsRefiningTo(const FOP_NoiseCubeKey& key) const;
+
+	// Single channel convenience version of Init
+	bool Init(int resolution,
 		EFractalNoiseType noiseType,
 		int32 seed,
 		float frequency,
@@ -63,75 +262,88 @@ public:
 		int32 octaves,
 		float lacunarity);
 	
-	// Sample the noise cube
-	float SampleNoiseCube(FVector normal);
+	// Sample every channel of the noise cube, outChannels must hold at least GetNumChannels() floats
+	void SampleNoiseCube(const FVector& normal, float* outChannels) const;
+
+	// Sample the first channel of the noise cube
+	float SampleNoiseCube(FVector normal) const;
+
+	// Returns the 6 faces of a channel of the cube as UTextures. The textures are created on the first call
+	// and reused until the cube data changes
+	TArray<UTexture2D* > GetCubeTextures(int32 channel = 0, EOP_NoiseTextureFormat format = EOP_NoiseTextureFormat::Float32);
 
-	// Returns the 6 faces of the cube as UTextures
-	TArray<UTexture2D* > GetCubeTextures();
+	// The key the current data was generated from
+	const FOP_NoiseCubeKey* GetKey() const { return Data.IsValid() ? &Data->Key : nullptr; }
+
+	// The current data, for baking into a UOP_NoiseCubeAsset
+	const FOP_NoiseCubeDataPtr& GetData() const { return Data; }
+
+	int32 GetNumChannels() const { return Data.IsValid() ? Data->NumChannels : 0; }
+
+	// The largest error introduced by Quantized16 storage, 0 for float storage
+	float GetQuantizationError() const { return Data.IsValid() ? Data->MaxQuantizationError : 0.0f; }
 
 protected:
 
-	// Creates the textures
-	void GenerateNoiseCube();
-
-	// The data
-	TArray<float> XPosHeight;
-	TArray<float> XNegHeight;
-	TArray<float> YPosHeight;
-	TArray<float> YNegHeight;
-	TArray<float> ZPosHeight;
-	TArray<float> ZNegHeight;
-
-	// Data stored as textures
-	UPROPERTY()
-	UTexture2D* XPosTex;
-	UPROPERTY()
-	UTexture2D* XNegTex;
-	UPROPERTY()
-	UTexture2D* YPosTex;
-	UPROPERTY()
-	UTexture2D* YNegTex;
-	UPROPERTY()
-	UTexture2D* ZPosTex;
-	UPROPERTY()
-	UTexture2D* ZNegTex;
-
-	// CubeMap
-	UPROPERTY()
-		UFastNoise* NoiseGenerator_XPos;
-
-	UPROPERTY()
-		UFastNoise* NoiseGenerator_XNeg;
-
-	UPROPERTY()
-		UFastNoise* NoiseGenerator_YPos;
-
-	UPROPERTY()
-		UFastNoise* NoiseGenerator_YNeg;
-
-	UPROPERTY()
-		UFastNoise* NoiseGenerator_ZPos;
-
-	UPROPERTY()
-		UFastNoise* NoiseGenerator_ZNeg;
-
-	static UTexture2D* NoiseToTexture(TArray<float> data, int resolution, UObject* outer, FString name);
+	virtual void BeginDestroy() override;
+
+	// The resolution of the preview InitProgressive generates before refining
+	static const int32 PreviewResolution = 32;
+
+	// Builds the six faces for the key, creating the noise generators only for the duration of the build
+	static FOP_NoiseCubeDataPtr GenerateNoiseCube(const FOP_NoiseCubeKey& key);
+
+	// Creates one generator per channel of the key, the faces are told apart by seed offsets rather than generators
+	static TArray<FFastNoise> CreateChannelGenerators(const FOP_NoiseCubeKey& key);
+
+	// Builds the six faces for the key from generators made by CreateChannelGenerators.
+	// Safe to call off the game thread, returns null if cancelled is set before the build finishes
+	static FOP_NoiseCubeDataPtr BuildNoiseCube(const FOP_NoiseCubeKey& key, const TArray<FFastNoise>& channelGenerators, const FThreadSafeBool* cancelled = nullptr);
+
+	static bool MakeKey(int resolution, const TArray<FOP_NoiseCubeChannel>& channels, EOP_NoiseCubeStorage storage, FOP_NoiseCubeKey& outKey);
+
+	static FOP_NoiseCubeDataPtr FindBakedData(const FOP_NoiseCubeKey& key, const UOP_NoiseCubeAsset* bakedAsset);
+
+	// The data, shared with every other cube using the same key
+	FOP_NoiseCubeDataPtr Data;
+
+	// Textures from GetCubeTextures, 6 faces per channel and format, null until requested
+	UPROPERTY(Transient)
+	TArray<UTexture2D*> CachedTextures;
+
+	// Creates a texture for one channel of a face, writing the noise straight into its mip
+	static UTexture2D* NoiseToTexture(const FOP_NoiseCubeData& data, EOP_CubeFace face, int32 channel, EOP_NoiseTextureFormat format, UObject* outer, FName name);
 	
-	UFastNoise* CreateNoiseGenerator(FNoiseGeneratorParameters params, int32 seed, UObject* outer);
+	static FFastNoise CreateNoiseGenerator(FNoiseGeneratorParameters params, int32 seed);
 
-	// Uses the noise generator to create a heightmap array, samples between 0 and 1
-	TArray<float> CreateFlatNoiseArray(UFastNoise* noiseGen, int resolution, float offset);
+	// Fills one face of the cube, visiting each texel once and evaluating every channel's generator there.
+	// Samples are taken between 0 and 1 so the noise is consistent between resolutions, channelGenerators are already
+	// seeded for the face so each face gets its own noise
+	static void FillFlatNoiseFace(const FFastNoise* channelGenerators, int32 numChannels, int32 resolution, float offset, float* outTexels);
+
+	// Stores a generated face of float texels as uint16 in data, normalised to the face's range for each channel
+	static void QuantizeFace(FOP_NoiseCubeData& data, EOP_CubeFace face, const float* faceTexels);
 
 private:
 
+	// True if Data is, or is being refined to, the data for key
+	bool IsCurrentKey(const FOP_NoiseCubeKey& key) const;
+
+	// Switches to new data, updating the sampling resolution and dropping textures made from the old data
+	void SetData(const FOP_NoiseCubeDataPtr& data);
+
+	// The key the refinement in progress is building towards
+	FOP_NoiseCubeKey RefineKey;
+
+	// Set to cancel the refinement in progress, null when not refining
+	TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe> RefineCancelled;
+
 	// The resolution of each of the cube faces
 	int Resolution = 128;
 
 	// 1 / Resolution
 	float ResStep;
 
-	// Height for each of the axes
-	float GetXHeight(float perc, FVector pos);
-	float GetYHeight(float perc, FVector pos);
-	float GetZHeight(float perc, FVector pos);
+	// Adds the weighted texel of the face the axis points at to outChannels, u and v are the other two axes
+	void AccumulateAxis(float perc, float u, float v, EOP_CubeFace posFace, EOP_CubeFace negFace, float* outChannels) const;
 };
@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "OP_NoiseCube.h"
+#include "OP_NoiseCubeAsset.generated.h"
+
+/**
+ * Noise cube data baked into an asset, so planets can load their noise instead of generating it at startup.
+ * The texels are written as one bulk block per array and read back with a single read.
+ */
+UCLASS()
+class ORBITPLANETARIUM_API UOP_NoiseCubeAsset : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	// Store the data in the asset, replacing what was baked before
+	void Bake(const FOP_NoiseCubeDataPtr& data);
+
+	// Returns the baked data if it was generated from key, null otherwise
+	FOP_NoiseCubeDataPtr GetData(const FOP_NoiseCubeKey& key) const;
+
+	bool HasData() const { return Data.IsValid(); }
+
+	virtual void Serialize(FArchive& Ar) override;
+
+private:
+
+	FOP_NoiseCubeDataPtr Data;
+};
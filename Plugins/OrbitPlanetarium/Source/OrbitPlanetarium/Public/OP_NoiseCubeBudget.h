@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class AOP_ProceduralPlanet;
+
+/**
+ * Shares the noise memory budget (op.NoiseCubeBudgetMB) between the planets in play.
+ *
+ * Planets with an automatic noise cube resolution ask for the resolution their size and target texel size need, if the
+ * total doesn't fit the budget the planets whose texels are smallest in world space are halved first,
+ * so the memory goes to the bodies that can actually show the detail.
+ */
+class ORBITPLANETARIUM_API FOP_NoiseCubeBudget
+{
+public:
+
+	static FOP_NoiseCubeBudget& Get();
+
+	void Register(AOP_ProceduralPlanet* planet);
+	void Unregister(AOP_ProceduralPlanet* planet);
+
+	// Shares the budget out between the registered planets. This only hands out resolutions, planets that have already
+	// generated and whose resolution changes regenerate their noise on their next tick
+	void Rebalance();
+
+	// The budget in bytes, from op.NoiseCubeBudgetMB
+	static int64 GetBudgetBytes();
+
+	// Auto resolutions are never reduced below this
+	static const int32 MinResolution = 32;
+
+private:
+
+	FOP_NoiseCubeBudget() {}
+
+	TArray<TWeakObjectPtr<AOP_ProceduralPlanet>> Planets;
+};
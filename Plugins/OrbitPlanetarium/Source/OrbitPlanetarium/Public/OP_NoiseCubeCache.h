@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+#include "UnrealFastNoisePlugin/Public/UFNWeakValueCache.h"
+#include "OP_NoiseCube.h"
+
+/**
+ * Process-wide cache of generated noise cube data.
+ *
+ * Entries are weak, so the cache never keeps a cube alive on its own: the data is reference
+ * counted by the UOP_NoiseCubes using it and is freed once the last planet lets go of it.
+ */
+class ORBITPLANETARIUM_API FOP_NoiseCubeCache
+{
+public:
+
+	static FOP_NoiseCubeCache& Get();
+
+	// Returns the live data for the key, or null if no cube built from it is still referenced
+	FOP_NoiseCubeDataPtr Find(const FOP_NoiseCubeKey& key);
+
+	// Returns the live data for the key, calling generator to build and register it on a miss
+	FOP_NoiseCubeDataPtr FindOrGenerate(const FOP_NoiseCubeKey& key, TFunctionRef<FOP_NoiseCubeDataPtr()> generator);
+
+	// Number of cubes currently shared through the cache
+	int32 Num();
+
+private:
+
+	FOP_NoiseCubeCache() {}
+
+	TUFNWeakValueCache<FOP_NoiseCubeKey, FOP_NoiseCubeData> Cubes;
+};
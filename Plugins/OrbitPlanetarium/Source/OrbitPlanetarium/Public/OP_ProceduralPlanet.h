@@ -198,14 +198,48 @@ public:
 
 	// CUBE ///////////////////////////////////////////////////////////////////
 
+	// Channels of NoiseCube
+	enum ENoiseChannel
+	{
+		NoiseChannel_Terrain,
+		NoiseChannel_Rough,
+		NoiseChannel_Count
+	};
+
 	UPROPERTY()
 	class UOP_NoiseCube* NoiseCube;
 
-	UPROPERTY()
-	class UOP_NoiseCube* RoughNoiseCube;
+	// Creates the UOP_NoiseCube using the parameters, returns true if the noise changed.
+	// In the editor the cube starts as a low resolution preview and the planet is regenerated as it is refined,
+	// unless bFullResolution asks for the full resolution cube straight away, e.g. to bake it
+	bool GenerateNoiseCubes(bool bFullResolution = false);
 
-	// Creates the UOP_NoiseCubes using the parameters
-	void GenerateNoiseCubes();
+	// The key of the noise cube for the current parameters
+	struct FOP_NoiseCubeKey MakeNoiseCubeKey() const;
+
+	// Pick the noise cube resolution from the planet size and LOD, sharing op.NoiseCubeBudgetMB with the other planets
+	UPROPERTY(EditAnywhere, Category = "Cube")
+	bool bAutoNoiseCubeResolution = false;
+
+	// Resolution of each face of the noise cube when bAutoNoiseCubeResolution is off
+	UPROPERTY(EditAnywhere, Category = "Cube", meta = (EditCondition = "!bAutoNoiseCubeResolution", ClampMin = "16", ClampMax = "4096"))
+	int32 NoiseCubeResolution = 256;
+
+	// World space size the automatic resolution aims for per noise texel, never finer than the highest LOD's vertex spacing
+	UPROPERTY(EditAnywhere, Category = "Cube", meta = (EditCondition = "bAutoNoiseCubeResolution", ClampMin = "1"))
+	float NoiseCubeTargetTexelSize = 100.0f;
+
+	// The face resolution the noise cube is generated at
+	int32 GetNoiseCubeResolution() const;
+
+	// The face resolution that gives NoiseCubeTargetTexelSize texels on this planet, clamped to what the budget can hold
+	int32 GetDesiredNoiseCubeResolution() const;
+
+	// World space size of a noise cube texel on the planet surface at a face resolution
+	float GetNoiseCubeTexelSize(int32 resolution) const;
+
+	// Called by FOP_NoiseCubeBudget, the planet is regenerated on its next tick if the resolution changed
+	void SetAutoNoiseCubeResolution(int32 resolution);
 
 	UPROPERTY(EditAnywhere, Category = "Cube")
 	TArray<UTexture2D*> cubemap;
@@ -216,6 +250,14 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Cube")
 	float Boost = 1.4f;
 
+	// Store the noise cube as 16 bit values instead of floats, halves the memory at a small loss of precision
+	UPROPERTY(EditAnywhere, Category = "Cube")
+	bool bQuantizeNoiseCube = false;
+
+	// Noise baked with "Bake Noise Cube", used instead of generating the cube when the parameters match
+	UPROPERTY(EditAnywhere, Category = "Cube")
+	class UOP_NoiseCubeAsset* BakedNoiseCube;
+
 	// LOD ///////////////////////////////////////////////////////////////////
 
 	
@@ -267,6 +309,14 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Resolution given by FOP_NoiseCubeBudget, 0 until the planet has been through a rebalance
+	int32 AutoNoiseCubeResolution = 0;
+
+	// Set when a rebalance changed the resolution of a generated planet, the noise is regenerated once on the next tick
+	bool bNoiseCubeResolutionChanged = false;
+
 	// Add a vertex to the planet data
 	static int AddVertex(FVector v, UOP_PlanetData* planet);
 	static int GetMiddlePoint(int p1, int p2, UOP_PlanetData* planet);
@@ -281,5 +331,9 @@ protected:
 
 	void GenerateHeatMapTex(UOP_PlanetData* planetData);
 
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
 private:
 };
@@ -5,6 +5,11 @@
 #include "DetailCategoryBuilder.h"
 #include "IDetailsView.h"
 #include "OP_ProceduralPlanet.h"
+#include "OP_NoiseCube.h"
+#include "OP_NoiseCubeAsset.h"
+#include "AssetToolsModule.h"
+#include "AssetRegistryModule.h"
+#include "Misc/PackageName.h"
 
 #define LOCTEXT_NAMESPACE "OP_ProceduralPlanetDetails"
 
@@ -20,6 +25,7 @@ void FOP_ProceduralPlanetDetails::CustomizeDetails(IDetailLayoutBuilder & Detail
 	const FText GeneratePlanetText = LOCTEXT("GeneratePlanet", "Generate Planet");
 	const FText ClearPlanetText = LOCTEXT("ClearPlanet", "Clear Planet");
 	const FText UpdatePlanetText = LOCTEXT("UpdatePlanet", "Update Planet");
+	const FText BakeNoiseCubeText = LOCTEXT("BakeNoiseCube", "Bake Noise Cube");
 
 	// Cache set of selected things
 	SelectedObjectsList = DetailBuilder.GetDetailsView().GetSelectedObjects();
@@ -65,6 +71,27 @@ void FOP_ProceduralPlanetDetails::CustomizeDetails(IDetailLayoutBuilder & Detail
 			.Text(ClearPlanetText)
 		]
 		];
+
+	procPlanetCategory.AddCustomRow(BakeNoiseCubeText, false)
+		.NameContent()
+		[
+			SNullWidget::NullWidget
+		]
+	.ValueContent()
+		.VAlign(VAlign_Center)
+		.MaxDesiredWidth(250)
+		[
+			SNew(SButton)
+			.VAlign(VAlign_Center)
+		.ToolTipText(LOCTEXT("BakeNoiseCubeTooltip", "Bake the noise cube into an asset so it is loaded instead of generated at startup"))
+		.OnClicked(this, &FOP_ProceduralPlanetDetails::ClickedOnBakeNoiseCube)
+		.IsEnabled(this, &FOP_ProceduralPlanetDetails::BakeNoiseCubeEnabled)
+		.Content()
+		[
+			SNew(STextBlock)
+			.Text(BakeNoiseCubeText)
+		]
+		];
 }
 
 FReply FOP_ProceduralPlanetDetails::ClickedOnGeneratePlanet()
@@ -90,6 +117,40 @@ FReply FOP_ProceduralPlanetDetails::ClickedOnClearPlanet()
 	return FReply::Handled();
 }
 
+FReply FOP_ProceduralPlanetDetails::ClickedOnBakeNoiseCube()
+{
+	AOP_ProceduralPlanet* procPlanet = GetFirstSelectedProceduralPlanet();
+	if (procPlanet == nullptr)
+	{
+		return FReply::Handled();
+	}
+
+	// Make sure the cube matches the current parameters at full resolution, the editor otherwise only holds a preview
+	// while it refines. A stale baked asset is regenerated here and baked over
+	procPlanet->GenerateNoiseCubes(true);
+
+	UOP_NoiseCubeAsset* asset = procPlanet->BakedNoiseCube;
+	if (asset == nullptr)
+	{
+		FString packageName;
+		FString assetName;
+		FAssetToolsModule& assetToolsModule = FModuleManager::LoadModuleChecked<FAssetToolsModule>("AssetTools");
+		assetToolsModule.Get().CreateUniqueAssetName(TEXT("/Game/NoiseCubes/") + procPlanet->GetName() + TEXT("_NoiseCube"), TEXT(""), packageName, assetName);
+
+		UPackage* package = CreatePackage(nullptr, *packageName);
+		asset = NewObject<UOP_NoiseCubeAsset>(package, *assetName, RF_Public | RF_Standalone);
+		FAssetRegistryModule::AssetCreated(asset);
+
+		procPlanet->Modify();
+		procPlanet->BakedNoiseCube = asset;
+	}
+
+	asset->Bake(procPlanet->NoiseCube->GetData());
+	asset->MarkPackageDirty();
+
+	return FReply::Handled();
+}
+
 bool FOP_ProceduralPlanetDetails::GeneratePlanetEnabled() const
 {
 	return GetFirstSelectedProceduralPlanet() != nullptr;
@@ -100,6 +161,11 @@ bool FOP_ProceduralPlanetDetails::ClearPlanetEnabled() const
 	return GetFirstSelectedProceduralPlanet() != nullptr;
 }
 
+bool FOP_ProceduralPlanetDetails::BakeNoiseCubeEnabled() const
+{
+	return GetFirstSelectedProceduralPlanet() != nullptr;
+}
+
 AOP_ProceduralPlanet* FOP_ProceduralPlanetDetails::GetFirstSelectedProceduralPlanet() const
 {
 	// Find first selected procedural planet
@@ -23,9 +23,13 @@ public:
 	// Handle clicking on clear button
 	FReply ClickedOnClearPlanet();
 
+	// Handle clicking on bake button
+	FReply ClickedOnBakeNoiseCube();
+
 	// Is the button enabled
 	bool GeneratePlanetEnabled() const;
 	bool ClearPlanetEnabled() const;
+	bool BakeNoiseCubeEnabled() const;
 
 	AOP_ProceduralPlanet* GetFirstSelectedProceduralPlanet() const;
 
@@ -0,0 +1,817 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FastNoiseBenchmarkCommandlet.h"
+#include "FastNoise/FastNoise.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Interfaces/IPluginManager.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogFastNoiseBenchmark, Log, All);
+
+namespace FastNoiseBenchmark
+{
+	static const int32 Seed = 1337;
+	static const float Frequency = 0.02f;
+
+	// Timed runs per path, the fastest is kept as other load on the machine only ever adds time
+	static const int32 Runs = 5;
+
+	// Points and grid samples checked against the golden values, the grid is 8x8 or 4x4x4. The points are stored with
+	// the values so the check doesn't depend on FRandomStream making the same points
+	static const int32 GoldenSamples = 64;
+
+	// Points the anisotropy is measured at, each stepped a quarter of a lattice cell along every axis. Noise with no
+	// preferred axis measures within a few percent of 1 at this many points
+	static const int32 AnisotropySamples = 16384;
+	static const float AnisotropyStep = 0.25f / Frequency;
+	static const float MaxAnisotropy = 1.1f;
+
+	struct FConfig
+	{
+		FString Name;
+		ENoiseType NoiseType = ENoiseType::Value;
+		EFractalType FractalType = EFractalType::FBM;
+		EInterp Interp = EInterp::InterpQuintic;
+		int32 Octaves = 1;
+		ECellularDistanceFunction DistanceFunction = ECellularDistanceFunction::Euclidean;
+		ECellularReturnType ReturnType = ECellularReturnType::CellValue;
+		ELatticeHash LatticeHash = ELatticeHash::Permutation;
+		int32 Dimensions = 2;
+
+		// Also measure multi-thread scaling
+		bool bScaling = false;
+
+		// The name without the lattice hash, for pairing the Permutation and Integer runs of a configuration
+		FString HashlessName;
+
+		void Apply(UFastNoise* noise) const
+		{
+			noise->SetSeed(Seed);
+			noise->SetFrequency(Frequency);
+			noise->SetNoiseType(NoiseType);
+			noise->SetFractalType(FractalType);
+			noise->SetInterp(Interp);
+			noise->SetFractalOctaves(Octaves);
+			noise->SetCellularDistanceFunction(DistanceFunction);
+			noise->SetCellularReturnType(ReturnType);
+			noise->SetLatticeHash(LatticeHash);
+		}
+	};
+
+	struct FPathResult
+	{
+		double SecondsPerSample = 0.0;
+		// Largest difference from the single point path, or from the golden values
+		float MaxError = 0.0f;
+	};
+
+	struct FScalingResult
+	{
+		int32 Threads;
+		double SamplesPerSecond;
+	};
+
+	struct FResult
+	{
+		FPathResult Scalar;
+		FPathResult Batch;
+		FPathResult Grid;
+
+		// Of the batch output over the point set
+		float Mean = 0.0f;
+		float StdDev = 0.0f;
+		float Min = 0.0f;
+		float Max = 0.0f;
+
+		// The largest mean squared change along an axis over the smallest, 1 if the noise changes as much along each
+		float Anisotropy = 1.0f;
+
+		// Empty if the golden values weren't checked
+		FString Golden;
+		float GoldenError = 0.0f;
+
+		TArray<FScalingResult> Scaling;
+
+		bool bFailed = false;
+	};
+
+	// The sample coordinates, the same for every configuration
+	struct FSamples
+	{
+		TArray<float> X;
+		TArray<float> Y;
+		TArray<float> Z;
+
+		FIntVector GridExtent2D;
+		FIntVector GridExtent3D;
+
+		FVector GridOrigin = FVector(-137.3f, 58.9f, -21.7f);
+		FVector GridStep = FVector(0.731f, 0.853f, 0.917f);
+
+		int32 Num() const { return X.Num(); }
+	};
+
+	template<typename EnumType>
+	static FString EnumName(const TCHAR* enumName, EnumType value)
+	{
+		const UEnum* enumObject = FindObject<UEnum>(ANY_PACKAGE, enumName, true);
+		return enumObject ? enumObject->GetNameStringByValue((int64)value) : FString::FromInt((int32)value);
+	}
+
+	static bool IsFractal(ENoiseType noiseType)
+	{
+		return noiseType == ENoiseType::ValueFractal || noiseType == ENoiseType::GradientFractal || noiseType == ENoiseType::SimplexFractal;
+	}
+
+	static bool UsesInterp(ENoiseType noiseType)
+	{
+		return noiseType == ENoiseType::Value || noiseType == ENoiseType::ValueFractal || noiseType == ENoiseType::Gradient || noiseType == ENoiseType::GradientFractal;
+	}
+
+	static void AddConfig(TArray<FConfig>& configs, FConfig config)
+	{
+		FString name = EnumName(TEXT("ENoiseType"), config.NoiseType);
+		if (IsFractal(config.NoiseType))
+		{
+			name += TEXT("/") + EnumName(TEXT("EFractalType"), config.FractalType) + FString::Printf(TEXT("/O%d"), config.Octaves);
+		}
+		if (UsesInterp(config.NoiseType))
+		{
+			name += TEXT("/") + EnumName(TEXT("EInterp"), config.Interp);
+		}
+		if (config.NoiseType == ENoiseType::Cellular)
+		{
+			name += TEXT("/") + EnumName(TEXT("ECellularDistanceFunction"), config.DistanceFunction) + TEXT("/") + EnumName(TEXT("ECellularReturnType"), config.ReturnType);
+		}
+		name += FString::Printf(TEXT("/%dD"), config.Dimensions);
+
+		config.HashlessName = name;
+		config.Name = name + TEXT("/") + EnumName(TEXT("ELatticeHash"), config.LatticeHash);
+		configs.Add(config);
+	}
+
+	static TArray<FConfig> MakeConfigs()
+	{
+		const ENoiseType noiseTypes[] = { ENoiseType::Value, ENoiseType::ValueFractal, ENoiseType::Gradient, ENoiseType::GradientFractal, ENoiseType::Simplex, ENoiseType::SimplexFractal, ENoiseType::Cellular, ENoiseType::WhiteNoise };
+		const EFractalType fractalTypes[] = { EFractalType::FBM, EFractalType::Billow, EFractalType::RigidMulti };
+		const EInterp interps[] = { EInterp::InterpLinear, EInterp::InterpHermite, EInterp::InterpQuintic };
+		const int32 octaveCounts[] = { 2, 4, 8 };
+		const ECellularDistanceFunction distanceFunctions[] = { ECellularDistanceFunction::Euclidean, ECellularDistanceFunction::Manhattan, ECellularDistanceFunction::Natural };
+		const ECellularReturnType returnTypes[] = { ECellularReturnType::CellValue, ECellularReturnType::Distance, ECellularReturnType::Distance2Add };
+		const ELatticeHash latticeHashes[] = { ELatticeHash::Permutation, ELatticeHash::Integer };
+
+		TArray<FConfig> configs;
+		for (ENoiseType noiseType : noiseTypes)
+		{
+			for (int32 dimensions = 2; dimensions <= 3; dimensions++)
+			{
+				for (ELatticeHash latticeHash : latticeHashes)
+				{
+					FConfig config;
+					config.NoiseType = noiseType;
+					config.Dimensions = dimensions;
+					config.LatticeHash = latticeHash;
+
+					// White noise hashes the coordinates' bits directly, the lattice hash doesn't apply
+					if (noiseType == ENoiseType::WhiteNoise)
+					{
+						if (latticeHash == ELatticeHash::Permutation)
+						{
+							AddConfig(configs, config);
+						}
+						continue;
+					}
+
+					if (noiseType == ENoiseType::Cellular)
+					{
+						for (ECellularDistanceFunction distanceFunction : distanceFunctions)
+						{
+							for (ECellularReturnType returnType : returnTypes)
+							{
+								config.DistanceFunction = distanceFunction;
+								config.ReturnType = returnType;
+								config.bScaling = dimensions == 3 && latticeHash == ELatticeHash::Permutation && distanceFunction == ECellularDistanceFunction::Euclidean && returnType == ECellularReturnType::CellValue;
+								AddConfig(configs, config);
+							}
+						}
+						continue;
+					}
+
+					const int32 numFractalTypes = IsFractal(noiseType) ? ARRAY_COUNT(fractalTypes) : 1;
+					const int32 numOctaveCounts = IsFractal(noiseType) ? ARRAY_COUNT(octaveCounts) : 1;
+					const int32 numInterps = UsesInterp(noiseType) ? ARRAY_COUNT(interps) : 1;
+
+					for (int32 f = 0; f < numFractalTypes; f++)
+					{
+						for (int32 o = 0; o < numOctaveCounts; o++)
+						{
+							for (int32 i = 0; i < numInterps; i++)
+							{
+								config.FractalType = fractalTypes[f];
+								config.Octaves = IsFractal(noiseType) ? octaveCounts[o] : 1;
+								config.Interp = UsesInterp(noiseType) ? interps[i] : EInterp::InterpQuintic;
+
+								// Scaling for the planet's usual setup of each type, FBM with 4 octaves and quintic interpolation
+								config.bScaling = dimensions == 3 && latticeHash == ELatticeHash::Permutation && config.FractalType == EFractalType::FBM
+									&& config.Interp == EInterp::InterpQuintic && (!IsFractal(noiseType) || config.Octaves == 4);
+								AddConfig(configs, config);
+							}
+						}
+					}
+				}
+			}
+		}
+		return configs;
+	}
+
+	static FSamples MakeSamples(int32 numSamples)
+	{
+		FSamples samples;
+		FRandomStream random(Seed);
+		samples.X.SetNumUninitialized(numSamples);
+		samples.Y.SetNumUninitialized(numSamples);
+		samples.Z.SetNumUninitialized(numSamples);
+		for (int32 i = 0; i < numSamples; i++)
+		{
+			samples.X[i] = random.FRandRange(-2000.0f, 2000.0f);
+			samples.Y[i] = random.FRandRange(-2000.0f, 2000.0f);
+			samples.Z[i] = random.FRandRange(-2000.0f, 2000.0f);
+		}
+
+		// Grids of about the same number of samples, so the paths are timed on the same amount of work
+		const int32 rowLength = 128;
+		samples.GridExtent2D = FIntVector(rowLength, FMath::Max(numSamples / rowLength, 1), 1);
+		samples.GridExtent3D = FIntVector(rowLength / 4, rowLength / 4, FMath::Max(numSamples / (rowLength * rowLength / 16), 1));
+		return samples;
+	}
+
+	static int32 GridNum(const FIntVector& extent)
+	{
+		return extent.X * extent.Y * extent.Z;
+	}
+
+	static double TimeSecondsPerSample(int32 numSamples, TFunctionRef<void()> run)
+	{
+		double best = DBL_MAX;
+		for (int32 r = 0; r < Runs; r++)
+		{
+			const double start = FPlatformTime::Seconds();
+			run();
+			best = FMath::Min(best, FPlatformTime::Seconds() - start);
+		}
+		return best / numSamples;
+	}
+
+	static float MaxDifference(const float* a, const float* b, int32 n)
+	{
+		float maxError = 0.0f;
+		for (int32 i = 0; i < n; i++)
+		{
+			// NaN counts as a failure rather than being lost in the comparison
+			const float error = FMath::Abs(a[i] - b[i]);
+			maxError = error == error ? FMath::Max(maxError, error) : MAX_FLT;
+		}
+		return maxError;
+	}
+
+	// The single point path on the grid's coordinates, x varying fastest like FillNoiseGrid
+	static void ScalarGrid(UFastNoise* noise, const FSamples& samples, int32 dimensions, const FIntVector& extent, float* out)
+	{
+		for (int32 z = 0; z < extent.Z; z++)
+		{
+			for (int32 y = 0; y < extent.Y; y++)
+			{
+				for (int32 x = 0; x < extent.X; x++)
+				{
+					const float px = samples.GridOrigin.X + x * samples.GridStep.X;
+					const float py = samples.GridOrigin.Y + y * samples.GridStep.Y;
+					const float pz = samples.GridOrigin.Z + z * samples.GridStep.Z;
+					*out++ = dimensions == 2 ? noise->GetNoise2D(px, py) : noise->GetNoise3D(px, py, pz);
+				}
+			}
+		}
+	}
+
+	static void FillGrid(UFastNoise* noise, const FSamples& samples, int32 dimensions, const FIntVector& extent, float* out)
+	{
+		if (dimensions == 2)
+		{
+			noise->FillNoiseGrid2D(FVector2D(samples.GridOrigin), FVector2D(samples.GridStep), FIntPoint(extent.X, extent.Y), out);
+		}
+		else
+		{
+			noise->FillNoiseGrid3D(samples.GridOrigin, samples.GridStep, extent, out);
+		}
+	}
+
+	static void Batch(const UFastNoise* noise, const FSamples& samples, int32 dimensions, int32 start, int32 n, float* out)
+	{
+		if (dimensions == 2)
+		{
+			noise->GetNoise2DBatch(samples.X.GetData() + start, samples.Y.GetData() + start, out, n);
+		}
+		else
+		{
+			noise->GetNoise3DBatch(samples.X.GetData() + start, samples.Y.GetData() + start, samples.Z.GetData() + start, out, n);
+		}
+	}
+
+	static float MeasureAnisotropy(UFastNoise* noise, int32 dimensions)
+	{
+		FRandomStream random(Seed);
+		double sumSquares[3] = { 0.0, 0.0, 0.0 };
+		for (int32 i = 0; i < AnisotropySamples; i++)
+		{
+			const FVector point(random.FRandRange(-2000.0f, 2000.0f), random.FRandRange(-2000.0f, 2000.0f), random.FRandRange(-2000.0f, 2000.0f));
+			const float value = dimensions == 2 ? noise->GetNoise2D(point.X, point.Y) : noise->GetNoise3D(point.X, point.Y, point.Z);
+			for (int32 axis = 0; axis < dimensions; axis++)
+			{
+				FVector stepped = point;
+				stepped[axis] += AnisotropyStep;
+				const float steppedValue = dimensions == 2 ? noise->GetNoise2D(stepped.X, stepped.Y) : noise->GetNoise3D(stepped.X, stepped.Y, stepped.Z);
+				sumSquares[axis] += FMath::Square((double)steppedValue - value);
+			}
+		}
+
+		double smallest = sumSquares[0];
+		double largest = sumSquares[0];
+		for (int32 axis = 1; axis < dimensions; axis++)
+		{
+			smallest = FMath::Min(smallest, sumSquares[axis]);
+			largest = FMath::Max(largest, sumSquares[axis]);
+		}
+		return smallest > 0.0 ? (float)(largest / smallest) : 1.0f;
+	}
+
+	static void MeasureScaling(const UFastNoise* noise, const FSamples& samples, int32 dimensions, int32 maxThreads, FResult& result)
+	{
+		// Each thread evaluates the whole point set, so the work per thread stays the same as threads are added
+		TArray<TArray<float>> outputs;
+		outputs.SetNum(maxThreads);
+		for (TArray<float>& output : outputs)
+		{
+			output.SetNumUninitialized(samples.Num());
+		}
+
+		for (int32 threads = 1; threads <= maxThreads; threads = threads < maxThreads ? FMath::Min(threads * 2, maxThreads) : maxThreads + 1)
+		{
+			const double seconds = TimeSecondsPerSample(1, [&]()
+			{
+				ParallelFor(threads, [&](int32 thread)
+				{
+					Batch(noise, samples, dimensions, 0, samples.Num(), outputs[thread].GetData());
+				}, threads == 1);
+			});
+
+			FScalingResult scaling;
+			scaling.Threads = threads;
+			scaling.SamplesPerSecond = (double)threads * samples.Num() / seconds;
+			result.Scaling.Add(scaling);
+		}
+	}
+
+	static void RunConfig(const FConfig& config, const FSamples& samples, const FSamples& goldenSamples, int32 maxThreads, const FJsonObject* golden, float tolerance, FResult& result, TSharedPtr<FJsonObject>& outGolden)
+	{
+		UFastNoise* noise = NewObject<UFastNoise>();
+		config.Apply(noise);
+
+		const int32 dimensions = config.Dimensions;
+		const int32 numSamples = samples.Num();
+		const FIntVector extent = dimensions == 2 ? samples.GridExtent2D : samples.GridExtent3D;
+		const int32 numGrid = GridNum(extent);
+
+		TArray<float> scalar;
+		TArray<float> batch;
+		TArray<float> grid;
+		scalar.SetNumUninitialized(numSamples);
+		batch.SetNumUninitialized(numSamples);
+		grid.SetNumUninitialized(numGrid);
+
+		result.Scalar.SecondsPerSample = TimeSecondsPerSample(numSamples, [&]()
+		{
+			for (int32 i = 0; i < numSamples; i++)
+			{
+				scalar[i] = dimensions == 2 ? noise->GetNoise2D(samples.X[i], samples.Y[i]) : noise->GetNoise3D(samples.X[i], samples.Y[i], samples.Z[i]);
+			}
+		});
+
+		result.Batch.SecondsPerSample = TimeSecondsPerSample(numSamples, [&]()
+		{
+			Batch(noise, samples, dimensions, 0, numSamples, batch.GetData());
+		});
+		result.Batch.MaxError = MaxDifference(batch.GetData(), scalar.GetData(), numSamples);
+
+		result.Grid.SecondsPerSample = TimeSecondsPerSample(numGrid, [&]()
+		{
+			FillGrid(noise, samples, dimensions, extent, grid.GetData());
+		});
+
+		// The grid path against single points on a small grid, evaluating the whole grid a point at a time would double the run time
+		const FIntVector goldenExtent = dimensions == 2 ? FIntVector(8, 8, 1) : FIntVector(4, 4, 4);
+		TArray<float> scalarGrid;
+		TArray<float> smallGrid;
+		scalarGrid.SetNumUninitialized(GoldenSamples);
+		smallGrid.SetNumUninitialized(GoldenSamples);
+		ScalarGrid(noise, goldenSamples, dimensions, goldenExtent, scalarGrid.GetData());
+		FillGrid(noise, goldenSamples, dimensions, goldenExtent, smallGrid.GetData());
+		result.Grid.MaxError = MaxDifference(smallGrid.GetData(), scalarGrid.GetData(), GoldenSamples);
+
+		TArray<float> scalarPoints;
+		TArray<float> batchPoints;
+		scalarPoints.SetNumUninitialized(GoldenSamples);
+		batchPoints.SetNumUninitialized(GoldenSamples);
+		for (int32 i = 0; i < GoldenSamples; i++)
+		{
+			scalarPoints[i] = dimensions == 2 ? noise->GetNoise2D(goldenSamples.X[i], goldenSamples.Y[i]) : noise->GetNoise3D(goldenSamples.X[i], goldenSamples.Y[i], goldenSamples.Z[i]);
+		}
+		Batch(noise, goldenSamples, dimensions, 0, GoldenSamples, batchPoints.GetData());
+
+		result.bFailed = result.Batch.MaxError > tolerance || result.Grid.MaxError > tolerance;
+
+		double sum = 0.0;
+		double sumSquares = 0.0;
+		result.Min = MAX_FLT;
+		result.Max = -MAX_FLT;
+		for (float value : batch)
+		{
+			sum += value;
+			sumSquares += (double)value * value;
+			result.Min = FMath::Min(result.Min, value);
+			result.Max = FMath::Max(result.Max, value);
+		}
+		result.Mean = (float)(sum / numSamples);
+		result.StdDev = (float)FMath::Sqrt(FMath::Max(sumSquares / numSamples - (sum / numSamples) * (sum / numSamples), 0.0));
+
+		// A biased choice of lattice gradients favours some axes over others
+		result.Anisotropy = MeasureAnisotropy(noise, dimensions);
+		result.bFailed |= result.Anisotropy > MaxAnisotropy;
+
+		// Golden values, the single point path at the golden points and on the small grid
+		if (outGolden.IsValid())
+		{
+			TArray<TSharedPtr<FJsonValue>> pointValues;
+			TArray<TSharedPtr<FJsonValue>> gridValues;
+			for (int32 i = 0; i < GoldenSamples; i++)
+			{
+				pointValues.Add(MakeShareable(new FJsonValueNumber(scalarPoints[i])));
+				gridValues.Add(MakeShareable(new FJsonValueNumber(scalarGrid[i])));
+			}
+
+			TSharedPtr<FJsonObject> values = MakeShareable(new FJsonObject);
+			values->SetArrayField(TEXT("points"), pointValues);
+			values->SetArrayField(TEXT("grid"), gridValues);
+			outGolden->SetObjectField(config.Name, values);
+		}
+		else if (golden != nullptr)
+		{
+			const TSharedPtr<FJsonObject>* values = nullptr;
+			const TArray<TSharedPtr<FJsonValue>>* pointValues = nullptr;
+			const TArray<TSharedPtr<FJsonValue>>* gridValues = nullptr;
+			if (!golden->TryGetObjectField(config.Name, values) || !(*values)->TryGetArrayField(TEXT("points"), pointValues) || !(*values)->TryGetArrayField(TEXT("grid"), gridValues)
+				|| pointValues->Num() != GoldenSamples || gridValues->Num() != GoldenSamples)
+			{
+				result.Golden = TEXT("missing");
+				result.bFailed = true;
+			}
+			else
+			{
+				TArray<float> expectedPoints;
+				TArray<float> expectedGrid;
+				for (int32 i = 0; i < GoldenSamples; i++)
+				{
+					expectedPoints.Add((float)(*pointValues)[i]->AsNumber());
+					expectedGrid.Add((float)(*gridValues)[i]->AsNumber());
+				}
+
+				result.GoldenError = FMath::Max(
+					FMath::Max(MaxDifference(scalarPoints.GetData(), expectedPoints.GetData(), GoldenSamples), MaxDifference(batchPoints.GetData(), expectedPoints.GetData(), GoldenSamples)),
+					FMath::Max(MaxDifference(scalarGrid.GetData(), expectedGrid.GetData(), GoldenSamples), MaxDifference(smallGrid.GetData(), expectedGrid.GetData(), GoldenSamples)));
+				result.Golden = result.GoldenError <= tolerance ? TEXT("pass") : TEXT("fail");
+				result.bFailed |= result.GoldenError > tolerance;
+			}
+		}
+
+		if (config.bScaling)
+		{
+			MeasureScaling(noise, samples, dimensions, maxThreads, result);
+		}
+	}
+
+	static TSharedPtr<FJsonObject> PathToJson(const FPathResult& path)
+	{
+		TSharedPtr<FJsonObject> json = MakeShareable(new FJsonObject);
+		json->SetNumberField(TEXT("nsPerSample"), path.SecondsPerSample * 1e9);
+		json->SetNumberField(TEXT("samplesPerSecondPerCore"), path.SecondsPerSample > 0.0 ? 1.0 / path.SecondsPerSample : 0.0);
+		json->SetNumberField(TEXT("maxError"), path.MaxError);
+		return json;
+	}
+
+	static TSharedPtr<FJsonObject> ResultToJson(const FConfig& config, const FResult& result)
+	{
+		TSharedPtr<FJsonObject> json = MakeShareable(new FJsonObject);
+		json->SetStringField(TEXT("name"), config.Name);
+		json->SetStringField(TEXT("noiseType"), EnumName(TEXT("ENoiseType"), config.NoiseType));
+		json->SetStringField(TEXT("fractalType"), EnumName(TEXT("EFractalType"), config.FractalType));
+		json->SetStringField(TEXT("interp"), EnumName(TEXT("EInterp"), config.Interp));
+		json->SetNumberField(TEXT("octaves"), config.Octaves);
+		json->SetStringField(TEXT("cellularDistanceFunction"), EnumName(TEXT("ECellularDistanceFunction"), config.DistanceFunction));
+		json->SetStringField(TEXT("cellularReturnType"), EnumName(TEXT("ECellularReturnType"), config.ReturnType));
+		json->SetStringField(TEXT("latticeHash"), EnumName(TEXT("ELatticeHash"), config.LatticeHash));
+		json->SetNumberField(TEXT("dimensions"), config.Dimensions);
+
+		json->SetObjectField(TEXT("scalar"), PathToJson(result.Scalar));
+		json->SetObjectField(TEXT("batch"), PathToJson(result.Batch));
+		json->SetObjectField(TEXT("grid"), PathToJson(result.Grid));
+
+		TSharedPtr<FJsonObject> stats = MakeShareable(new FJsonObject);
+		stats->SetNumberField(TEXT("mean"), result.Mean);
+		stats->SetNumberField(TEXT("stdDev"), result.StdDev);
+		stats->SetNumberField(TEXT("min"), result.Min);
+		stats->SetNumberField(TEXT("max"), result.Max);
+		stats->SetNumberField(TEXT("anisotropy"), result.Anisotropy);
+		json->SetObjectField(TEXT("stats"), stats);
+
+		if (!result.Golden.IsEmpty())
+		{
+			json->SetStringField(TEXT("golden"), result.Golden);
+			json->SetNumberField(TEXT("goldenError"), result.GoldenError);
+		}
+
+		if (result.Scaling.Num() > 0)
+		{
+			const double single = result.Scaling[0].SamplesPerSecond;
+			TArray<TSharedPtr<FJsonValue>> scalingValues;
+			for (const FScalingResult& scaling : result.Scaling)
+			{
+				TSharedPtr<FJsonObject> scalingJson = MakeShareable(new FJsonObject);
+				scalingJson->SetNumberField(TEXT("threads"), scaling.Threads);
+				scalingJson->SetNumberField(TEXT("samplesPerSecond"), scaling.SamplesPerSecond);
+				scalingJson->SetNumberField(TEXT("speedup"), scaling.SamplesPerSecond / single);
+				scalingJson->SetNumberField(TEXT("efficiency"), scaling.SamplesPerSecond / (single * scaling.Threads));
+				scalingValues.Add(MakeShareable(new FJsonValueObject(scalingJson)));
+			}
+			json->SetArrayField(TEXT("scaling"), scalingValues);
+		}
+
+		json->SetBoolField(TEXT("failed"), result.bFailed);
+		return json;
+	}
+
+	// Pairs the Permutation and Integer runs of each configuration
+	static TArray<TSharedPtr<FJsonValue>> CompareLatticeHashes(const TArray<FConfig>& configs, const TArray<FResult>& results)
+	{
+		TMap<FString, int32> permutationRuns;
+		for (int32 i = 0; i < configs.Num(); i++)
+		{
+			if (configs[i].LatticeHash == ELatticeHash::Permutation)
+			{
+				permutationRuns.Add(configs[i].HashlessName, i);
+			}
+		}
+
+		TArray<TSharedPtr<FJsonValue>> comparisons;
+		for (int32 i = 0; i < configs.Num(); i++)
+		{
+			const int32* permutation = permutationRuns.Find(configs[i].HashlessName);
+			if (configs[i].LatticeHash != ELatticeHash::Integer || permutation == nullptr)
+			{
+				continue;
+			}
+
+			const FResult& a = results[*permutation];
+			const FResult& b = results[i];
+
+			TSharedPtr<FJsonObject> json = MakeShareable(new FJsonObject);
+			json->SetStringField(TEXT("name"), configs[i].HashlessName);
+			json->SetNumberField(TEXT("permutationBatchNsPerSample"), a.Batch.SecondsPerSample * 1e9);
+			json->SetNumberField(TEXT("integerBatchNsPerSample"), b.Batch.SecondsPerSample * 1e9);
+			json->SetNumberField(TEXT("integerBatchSpeedup"), a.Batch.SecondsPerSample / b.Batch.SecondsPerSample);
+			json->SetNumberField(TEXT("permutationScalarNsPerSample"), a.Scalar.SecondsPerSample * 1e9);
+			json->SetNumberField(TEXT("integerScalarNsPerSample"), b.Scalar.SecondsPerSample * 1e9);
+			json->SetNumberField(TEXT("permutationStdDev"), a.StdDev);
+			json->SetNumberField(TEXT("integerStdDev"), b.StdDev);
+			json->SetNumberField(TEXT("permutationMean"), a.Mean);
+			json->SetNumberField(TEXT("integerMean"), b.Mean);
+			json->SetNumberField(TEXT("permutationAnisotropy"), a.Anisotropy);
+			json->SetNumberField(TEXT("integerAnisotropy"), b.Anisotropy);
+			comparisons.Add(MakeShareable(new FJsonValueObject(json)));
+
+			UE_LOG(LogFastNoiseBenchmark, Display, TEXT("%-52s batch %7.1f -> %7.1f ns/sample (x%.2f), std dev %.3f -> %.3f, anisotropy %.3f -> %.3f"), *configs[i].HashlessName,
+				a.Batch.SecondsPerSample * 1e9, b.Batch.SecondsPerSample * 1e9, a.Batch.SecondsPerSample / b.Batch.SecondsPerSample, a.StdDev, b.StdDev, a.Anisotropy, b.Anisotropy);
+		}
+		return comparisons;
+	}
+
+	static TArray<TSharedPtr<FJsonValue>> ToJsonValues(const float* values, int32 n)
+	{
+		TArray<TSharedPtr<FJsonValue>> jsonValues;
+		for (int32 i = 0; i < n; i++)
+		{
+			jsonValues.Add(MakeShareable(new FJsonValueNumber(values[i])));
+		}
+		return jsonValues;
+	}
+
+	static bool ReadJsonValues(const FJsonObject& json, const TCHAR* field, float* outValues, int32 n)
+	{
+		const TArray<TSharedPtr<FJsonValue>>* jsonValues = nullptr;
+		if (!json.TryGetArrayField(field, jsonValues) || jsonValues->Num() != n)
+		{
+			return false;
+		}
+		for (int32 i = 0; i < n; i++)
+		{
+			outValues[i] = (float)(*jsonValues)[i]->AsNumber();
+		}
+		return true;
+	}
+
+	// The golden points and grid, stored alongside the golden values
+	static TSharedPtr<FJsonObject> GoldenSamplesToJson(const FSamples& samples)
+	{
+		TSharedPtr<FJsonObject> json = MakeShareable(new FJsonObject);
+		json->SetArrayField(TEXT("x"), ToJsonValues(samples.X.GetData(), GoldenSamples));
+		json->SetArrayField(TEXT("y"), ToJsonValues(samples.Y.GetData(), GoldenSamples));
+		json->SetArrayField(TEXT("z"), ToJsonValues(samples.Z.GetData(), GoldenSamples));
+		json->SetArrayField(TEXT("gridOrigin"), ToJsonValues(&samples.GridOrigin.X, 3));
+		json->SetArrayField(TEXT("gridStep"), ToJsonValues(&samples.GridStep.X, 3));
+		return json;
+	}
+
+	static bool ReadGoldenSamples(const FJsonObject& json, FSamples& outSamples)
+	{
+		return ReadJsonValues(json, TEXT("x"), outSamples.X.GetData(), GoldenSamples)
+			&& ReadJsonValues(json, TEXT("y"), outSamples.Y.GetData(), GoldenSamples)
+			&& ReadJsonValues(json, TEXT("z"), outSamples.Z.GetData(), GoldenSamples)
+			&& ReadJsonValues(json, TEXT("gridOrigin"), &outSamples.GridOrigin.X, 3)
+			&& ReadJsonValues(json, TEXT("gridStep"), &outSamples.GridStep.X, 3);
+	}
+
+	static bool WriteJson(const TSharedPtr<FJsonObject>& json, const FString& path)
+	{
+		FString text;
+		TSharedRef<TJsonWriter<>> writer = TJsonWriterFactory<>::Create(&text);
+		FJsonSerializer::Serialize(json.ToSharedRef(), writer);
+		return FFileHelper::SaveStringToFile(text, *path);
+	}
+}
+
+UFastNoiseBenchmarkCommandlet::UFastNoiseBenchmarkCommandlet(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UFastNoiseBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace FastNoiseBenchmark;
+
+	const FString directory = FPaths::GameSavedDir() / TEXT("FastNoiseBenchmark");
+	FString outputPath = directory / TEXT("Results.json");
+	// The golden values recorded from the reference build ship with the plugin
+	const TSharedPtr<IPlugin> plugin = IPluginManager::Get().FindPlugin(TEXT("UnrealFastNoisePlugin"));
+	FString goldenPath = plugin.IsValid() ? plugin->GetBaseDir() / TEXT("Resources/FastNoiseBenchmarkGolden.json") : directory / TEXT("Golden.json");
+	FString filter;
+	int32 numSamples = 16384;
+	int32 maxThreads = FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+	float tolerance = FASTNOISE_BATCH_TOLERANCE;
+
+	FParse::Value(*Params, TEXT("output="), outputPath);
+	FParse::Value(*Params, TEXT("golden="), goldenPath);
+	FParse::Value(*Params, TEXT("filter="), filter);
+	FParse::Value(*Params, TEXT("samples="), numSamples);
+	FParse::Value(*Params, TEXT("threads="), maxThreads);
+	FParse::Value(*Params, TEXT("tolerance="), tolerance);
+	const bool bWriteGolden = FParse::Param(*Params, TEXT("writegolden"));
+
+	numSamples = FMath::Max(numSamples, GoldenSamples);
+	maxThreads = FMath::Max(maxThreads, 1);
+
+	TSharedPtr<FJsonObject> goldenRoot;
+	TSharedPtr<FJsonObject> newGolden;
+	if (bWriteGolden)
+	{
+		newGolden = MakeShareable(new FJsonObject);
+	}
+	else
+	{
+		FString goldenText;
+		if (FFileHelper::LoadFileToString(goldenText, *goldenPath))
+		{
+			TSharedRef<TJsonReader<>> reader = TJsonReaderFactory<>::Create(goldenText);
+			if (!FJsonSerializer::Deserialize(reader, goldenRoot) || !goldenRoot.IsValid())
+			{
+				UE_LOG(LogFastNoiseBenchmark, Error, TEXT("Couldn't parse the golden values in %s"), *goldenPath);
+				return 1;
+			}
+		}
+		else
+		{
+			UE_LOG(LogFastNoiseBenchmark, Error, TEXT("No golden values at %s, run with -writegolden on the reference build to record them"), *goldenPath);
+			return 1;
+		}
+	}
+
+	// Recording takes the first of the timed points, checking uses the points the values were recorded at
+	FSamples goldenSamples = MakeSamples(GoldenSamples);
+	const FJsonObject* golden = nullptr;
+	if (goldenRoot.IsValid())
+	{
+		const TSharedPtr<FJsonObject>* goldenConfigs = nullptr;
+		const TSharedPtr<FJsonObject>* goldenPoints = nullptr;
+		if (!goldenRoot->TryGetObjectField(TEXT("configurations"), goldenConfigs) || !goldenRoot->TryGetObjectField(TEXT("points"), goldenPoints)
+			|| !ReadGoldenSamples(**goldenPoints, goldenSamples))
+		{
+			UE_LOG(LogFastNoiseBenchmark, Error, TEXT("The golden values in %s are incomplete, record them again with -writegolden"), *goldenPath);
+			return 1;
+		}
+		golden = goldenConfigs->Get();
+	}
+
+	TArray<FConfig> configs = MakeConfigs();
+	if (!filter.IsEmpty())
+	{
+		configs.RemoveAll([&filter](const FConfig& config) { return !config.Name.Contains(filter); });
+	}
+
+	const FSamples samples = MakeSamples(numSamples);
+
+	UE_LOG(LogFastNoiseBenchmark, Display, TEXT("%d configurations, %d samples per run, %s kernels, up to %d threads"),
+		configs.Num(), numSamples, FastNoiseBatch::GetInstructionSetName(FastNoiseBatch::GetInstructionSet()), maxThreads);
+
+	TArray<FResult> results;
+	results.SetNum(configs.Num());
+	int32 numFailed = 0;
+
+	TArray<TSharedPtr<FJsonValue>> configValues;
+	for (int32 i = 0; i < configs.Num(); i++)
+	{
+		const FConfig& config = configs[i];
+		FResult& result = results[i];
+		RunConfig(config, samples, goldenSamples, maxThreads, golden, tolerance, result, newGolden);
+
+		UE_LOG(LogFastNoiseBenchmark, Display, TEXT("%-60s scalar %7.1f  batch %7.1f  grid %7.1f ns/sample  %s"), *config.Name,
+			result.Scalar.SecondsPerSample * 1e9, result.Batch.SecondsPerSample * 1e9, result.Grid.SecondsPerSample * 1e9, result.bFailed ? TEXT("FAILED") : *result.Golden);
+
+		if (result.bFailed)
+		{
+			UE_LOG(LogFastNoiseBenchmark, Error, TEXT("%s: batch error %g, grid error %g, golden error %g, anisotropy %.3f"), *config.Name, result.Batch.MaxError, result.Grid.MaxError, result.GoldenError, result.Anisotropy);
+			numFailed++;
+		}
+
+		for (const FScalingResult& scaling : result.Scaling)
+		{
+			UE_LOG(LogFastNoiseBenchmark, Display, TEXT("    %2d threads  %.1f M samples/s  x%.2f"), scaling.Threads, scaling.SamplesPerSecond / 1e6, scaling.SamplesPerSecond / result.Scaling[0].SamplesPerSecond);
+		}
+
+		configValues.Add(MakeShareable(new FJsonValueObject(ResultToJson(config, result))));
+	}
+
+	TSharedPtr<FJsonObject> root = MakeShareable(new FJsonObject);
+	root->SetStringField(TEXT("instructionSet"), FastNoiseBatch::GetInstructionSetName(FastNoiseBatch::GetInstructionSet()));
+	root->SetNumberField(TEXT("logicalCores"), FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+	root->SetNumberField(TEXT("samplesPerRun"), numSamples);
+	root->SetNumberField(TEXT("seed"), Seed);
+	root->SetNumberField(TEXT("frequency"), Frequency);
+	root->SetNumberField(TEXT("tolerance"), tolerance);
+	root->SetNumberField(TEXT("failed"), numFailed);
+	root->SetArrayField(TEXT("configurations"), configValues);
+	root->SetArrayField(TEXT("latticeHashComparison"), CompareLatticeHashes(configs, results));
+
+	if (!WriteJson(root, outputPath))
+	{
+		UE_LOG(LogFastNoiseBenchmark, Error, TEXT("Couldn't write the results to %s"), *outputPath);
+		return 1;
+	}
+	UE_LOG(LogFastNoiseBenchmark, Display, TEXT("Results written to %s"), *outputPath);
+
+	if (bWriteGolden)
+	{
+		TSharedPtr<FJsonObject> goldenOut = MakeShareable(new FJsonObject);
+		goldenOut->SetNumberField(TEXT("seed"), Seed);
+		goldenOut->SetNumberField(TEXT("frequency"), Frequency);
+		goldenOut->SetObjectField(TEXT("points"), GoldenSamplesToJson(goldenSamples));
+		goldenOut->SetObjectField(TEXT("configurations"), newGolden);
+		if (!WriteJson(goldenOut, goldenPath))
+		{
+			UE_LOG(LogFastNoiseBenchmark, Error, TEXT("Couldn't write the golden values to %s"), *goldenPath);
+			return 1;
+		}
+		UE_LOG(LogFastNoiseBenchmark, Display, TEXT("Golden values written to %s"), *goldenPath);
+	}
+
+	if (numFailed > 0)
+	{
+		UE_LOG(LogFastNoiseBenchmark, Error, TEXT("%d of %d configurations failed"), numFailed, configs.Num());
+		return 1;
+	}
+	return 0;
+}
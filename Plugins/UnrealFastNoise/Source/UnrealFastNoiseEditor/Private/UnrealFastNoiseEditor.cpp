@@ -0,0 +1,5 @@
+#include "CoreMinimal.h"
+#include "Modules/ModuleManager.h"
+
+// Holds the editor only tools, FastNoiseBenchmark for now, so they stay out of the runtime module
+IMPLEMENT_MODULE(FDefaultModuleImpl, UnrealFastNoiseEditor)
@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "FastNoiseBenchmarkCommandlet.generated.h"
+
+/**
+ * Headless FastNoise benchmark, needs no GPU or map:
+ *
+ *   UE4Editor-Cmd Orbit.uproject -run=FastNoiseBenchmark -nullrhi [options]
+ *
+ * Runs every noise type, fractal type, interpolation, octave count, dimension and lattice hash through the UFastNoise
+ * single point, batch and grid paths, reporting ns/sample and samples/s per core, plus multi-thread scaling for one
+ * configuration of each noise type. Results go to JSON.
+ *
+ * Every configuration is also checked at fixed points against golden values, so optimised variants can be validated
+ * against the reference build. The plugin ships the values recorded from the scalar path of the reference build, run
+ * the reference with -writegolden to record them again.
+ *
+ * Options:
+ *   -output=<file>     JSON results, default Saved/FastNoiseBenchmark/Results.json
+ *   -golden=<file>     golden values, default the plugin's Resources/FastNoiseBenchmarkGolden.json
+ *   -writegolden       record the golden values from this build instead of checking against them
+ *   -filter=<text>     only run configurations whose name contains the text
+ *   -samples=<n>       samples per timed run, default 16384
+ *   -threads=<n>       most threads to measure scaling with, default the number of logical cores
+ *   -tolerance=<f>     largest difference from the golden values that passes, default FASTNOISE_BATCH_TOLERANCE
+ *
+ * Each configuration's anisotropy, how much more the noise changes along one axis than another, is measured too.
+ *
+ * Returns non-zero if the golden values are missing, or any configuration has none, fails the golden check, has paths
+ * that disagree with each other or an anisotropy over 1.1.
+ */
+UCLASS()
+class UNREALFASTNOISEEDITOR_API UFastNoiseBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,32 @@
+namespace UnrealBuildTool.Rules
+{
+    public class UnrealFastNoiseEditor : ModuleRules
+    {
+        public UnrealFastNoiseEditor(ReadOnlyTargetRules Target) : base(Target)
+        {
+            PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+            PrivateIncludePaths.Add("UnrealFastNoiseEditor/Private");
+            PublicIncludePaths.Add("UnrealFastNoiseEditor/Public");
+
+            PublicDependencyModuleNames.AddRange(
+                new string[]
+                {
+                    "Core",
+                    "CoreUObject",
+                    "Engine",
+                    "UnrealFastNoisePlugin"
+                }
+                );
+
+            // Results and golden values of the benchmark commandlet, the golden values ship in the plugin's Resources
+            PrivateDependencyModuleNames.AddRange(
+                new string[]
+                {
+                    "Json",
+                    "Projects"
+                }
+                );
+        }
+    }
+}
@@ -28,10 +28,12 @@
 
 #include "FastNoise.h"
 #include "UnrealFastNoisePlugin.h"
+#include "UFNNoiseProgram.h"
 
 #include <math.h>
-#include <random>
 
+// In 2D the z axis is dropped, which leaves the diagonals at 0..3, x at 4..7 and y at 8..11. Integer hashing picks
+// one of 12 in 3D, and in 2D one of 8 directions, 0..5 and 8..9, so each axis is picked as often as the others
 const float GRAD_X[] =
 {
 	1, -1, 1, -1,
@@ -187,52 +189,83 @@ static float Lerp(float a, float b, float t) { return a + t * (b - a); }
 static float InterpHermiteFunc(float t) { return t*t*(3 - 2 * t); }
 static float InterpQuinticFunc(float t) { return t*t*t*(t*(t * 6 - 15) + 10); }
 
-UFastNoise::UFastNoise(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+FFastNoise::FFastNoise(int seed)
 {
+	SetSeed(seed);
 	CalculateFractalBounding();
+	BindKernels();
 }
 
-void UFastNoise::SetSeed(int seed)
+void FFastNoise::SetSeed(int seed)
 {
 	m_seed = seed;
 
-	std::mt19937 gen(seed);
+	m_permutation = FFastNoisePermutationCache::Get().FindOrCreate(seed);
+	m_perm = m_permutation->Perm;
+	m_perm12 = m_permutation->Perm12;
+}
+
+// Integer lattice hashing, see FASTNOISE_HASH_PRIME_X
+static uint32 HashCoord2D(uint32 seed, int x, int y)
+{
+	uint32 hash = seed ^ ((uint32)y * FASTNOISE_HASH_PRIME_Y) ^ ((uint32)x * FASTNOISE_HASH_PRIME_X);
+	hash *= FASTNOISE_HASH_MULTIPLIER;
+	return hash ^ (hash >> 15);
+}
+static uint32 HashCoord3D(uint32 seed, int x, int y, int z)
+{
+	uint32 hash = seed ^ ((uint32)z * FASTNOISE_HASH_PRIME_Z) ^ ((uint32)y * FASTNOISE_HASH_PRIME_Y) ^ ((uint32)x * FASTNOISE_HASH_PRIME_X);
+	hash *= FASTNOISE_HASH_MULTIPLIER;
+	return hash ^ (hash >> 15);
+}
+static float HashToValue(uint32 hash)
+{
+	return (float)(int32)hash * (1.0f / 2147483648.0f);
+}
 
-	for (int i = 0; i < 256; i++)
-		m_perm[i] = i;
+uint32 FFastNoise::HashSeed(unsigned char offset) const
+{
+	return (uint32)m_seed + offset * (uint32)FASTNOISE_HASH_OFFSET_MULTIPLIER;
+}
 
-	for (int j = 0; j < 256; j++)
+unsigned char FFastNoise::Index2D_12(unsigned char offset, int x, int y) const
+{
+	if (m_latticeHash == ELatticeHash::Integer)
 	{
-		std::uniform_int_distribution<> dis(0, 256 - j);
-		int k = dis(gen) + j;
-		int l = m_perm[j];
-		m_perm[j] = m_perm[j + 256] = m_perm[k];
-		m_perm[k] = l;
-		m_perm12[j] = m_perm12[j + 256] = m_perm[j] % 12;
+		// The 4 diagonals and the 4 axis directions once each, see GRAD_X
+		const unsigned char hash = HashCoord2D(HashSeed(offset), x, y) & 7;
+		return hash + (((hash + 2) >> 2) & 2);
 	}
-}
 
-unsigned char UFastNoise::Index2D_12(unsigned char offset, int x, int y)
-{
 	return m_perm12[(x & 0xff) + m_perm[(y & 0xff) + offset]];
 }
-unsigned char UFastNoise::Index3D_12(unsigned char offset, int x, int y, int z)
+unsigned char FFastNoise::Index3D_12(unsigned char offset, int x, int y, int z) const
 {
+	if (m_latticeHash == ELatticeHash::Integer)
+		// Scaling 16 bits of the hash down to 12 rather than masking, a mask would repeat some directions
+		return (unsigned char)(((HashCoord3D(HashSeed(offset), x, y, z) & 0xffff) * 12) >> 16);
+
 	return m_perm12[(x & 0xff) + m_perm[(y & 0xff) + m_perm[(z & 0xff) + offset]]];
 }
-unsigned char UFastNoise::Index4D_32(unsigned char offset, int x, int y, int z, int w)
+unsigned char FFastNoise::Index4D_32(unsigned char offset, int x, int y, int z, int w) const
 {
 	return m_perm[(x & 0xff) + m_perm[(y & 0xff) + m_perm[(z & 0xff) + m_perm[(w & 0xff) + offset]]]] & 31;
 }
-unsigned char UFastNoise::Index2D_256(unsigned char offset, int x, int y)
+unsigned char FFastNoise::Index2D_256(unsigned char offset, int x, int y) const
 {
+	if (m_latticeHash == ELatticeHash::Integer)
+		return HashCoord2D(HashSeed(offset), x, y) & 0xff;
+
 	return m_perm[(x & 0xff) + m_perm[(y & 0xff) + offset]];
 }
-unsigned char UFastNoise::Index3D_256(unsigned char offset, int x, int y, int z)
+unsigned char FFastNoise::Index3D_256(unsigned char offset, int x, int y, int z) const
 {
+	if (m_latticeHash == ELatticeHash::Integer)
+		return HashCoord3D(HashSeed(offset), x, y, z) & 0xff;
+
 	return m_perm[(x & 0xff) + m_perm[(y & 0xff) + m_perm[(z & 0xff) + offset]]];
 }
-unsigned char UFastNoise::Index4D_256(unsigned char offset, int x, int y, int z, int w)
+unsigned char FFastNoise::Index4D_256(unsigned char offset, int x, int y, int z, int w) const
 {
 	return m_perm[(x & 0xff) + m_perm[(y & 0xff) + m_perm[(z & 0xff) + m_perm[(w & 0xff) + offset]]]];
 }
@@ -243,191 +276,316 @@ unsigned char UFastNoise::Index4D_256(unsigned char offset, int x, int y, int z,
 #define Z_PRIME 6971
 #define W_PRIME 1013
 
+// Unsigned, so the products wrap rather than overflowing. The cellular batch kernels rely on them wrapping
 static float ValCoord2D(int seed, int x, int y)
 {
-	int n = X_PRIME * x;
-	n += Y_PRIME * y;
-	n += seed;
+	uint32 n = X_PRIME * (uint32)x;
+	n += Y_PRIME * (uint32)y;
+	n += (uint32)seed;
 	n &= 0x7fffffff;
 	n = (n >> 13) ^ n;
-	return 9.311924889611565e-10f * (((n * (n * n * 60493 + 19990303) + 1376312589) & 0x7fffffff) - 1073891824);
+	return 9.311924889611565e-10f * ((int)((n * (n * n * 60493 + 19990303) + 1376312589) & 0x7fffffff) - 1073891824);
 }
 static float ValCoord3D(int seed, int x, int y, int z)
 {
-	int n = X_PRIME * x;
-	n += Y_PRIME * y;
-	n += Z_PRIME * z;
-	n += seed;
+	uint32 n = X_PRIME * (uint32)x;
+	n += Y_PRIME * (uint32)y;
+	n += Z_PRIME * (uint32)z;
+	n += (uint32)seed;
 	n &= 0x7fffffff;
 	n = (n >> 13) ^ n;
-	return 9.311924889611565e-10f * (((n * (n * n * 60493 + 19990303) + 1376312589) & 0x7fffffff) - 1073891824);
+	return 9.311924889611565e-10f * ((int)((n * (n * n * 60493 + 19990303) + 1376312589) & 0x7fffffff) - 1073891824);
 }
 static float ValCoord4D(int seed, int x, int y, int z, int w)
 {
-	int n = X_PRIME * x;
-	n += Y_PRIME * y;
-	n += Z_PRIME * z;
-	n += W_PRIME * w;
-	n += seed;
+	uint32 n = X_PRIME * (uint32)x;
+	n += Y_PRIME * (uint32)y;
+	n += Z_PRIME * (uint32)z;
+	n += W_PRIME * (uint32)w;
+	n += (uint32)seed;
 	n &= 0x7fffffff;
 	n = (n >> 13) ^ n;
-	return 9.311924889611565e-10f * (((n * (n * n * 60493 + 19990303) + 1376312589) & 0x7fffffff) - 1073891824);
+	return 9.311924889611565e-10f * ((int)((n * (n * n * 60493 + 19990303) + 1376312589) & 0x7fffffff) - 1073891824);
 }
 
-float UFastNoise::ValCoord2DFast(unsigned char offset, int x, int y)
+float FFastNoise::ValCoord2DFast(unsigned char offset, int x, int y) const
 {
+	// Integer hashes have plenty of bits to make the value from directly
+	if (m_latticeHash == ELatticeHash::Integer)
+		return HashToValue(HashCoord2D(HashSeed(offset), x, y));
+
 	return VAL_LUT[Index2D_256(offset, x, y)];
 }
-float UFastNoise::ValCoord3DFast(unsigned char offset, int x, int y, int z)
+float FFastNoise::ValCoord3DFast(unsigned char offset, int x, int y, int z) const
 {
+	if (m_latticeHash == ELatticeHash::Integer)
+		return HashToValue(HashCoord3D(HashSeed(offset), x, y, z));
+
 	return VAL_LUT[Index3D_256(offset, x, y, z)];
 }
 
-float UFastNoise::GradCoord2D(unsigned char offset, int x, int y, float xd, float yd)
+float FFastNoise::GradCoord2D(unsigned char offset, int x, int y, float xd, float yd) const
 {
 	unsigned char lutPos = Index2D_12(offset, x, y);
 
 	return xd*GRAD_X[lutPos] + yd*GRAD_Y[lutPos];
 }
-float UFastNoise::GradCoord3D(unsigned char offset, int x, int y, int z, float xd, float yd, float zd)
+float FFastNoise::GradCoord3D(unsigned char offset, int x, int y, int z, float xd, float yd, float zd) const
 {
 	unsigned char lutPos = Index3D_12(offset, x, y, z);
 
 	return xd*GRAD_X[lutPos] + yd*GRAD_Y[lutPos] + zd*GRAD_Z[lutPos];
 }
-float UFastNoise::GradCoord4D(unsigned char offset, int x, int y, int z, int w, float xd, float yd, float zd, float wd)
+float FFastNoise::GradCoord4D(unsigned char offset, int x, int y, int z, int w, float xd, float yd, float zd, float wd) const
 {
 	unsigned char lutPos = Index4D_32(offset, x, y, z, w) << 2;
 
 	return xd*GRAD_4D[lutPos] + yd*GRAD_4D[lutPos + 1] + zd*GRAD_4D[lutPos + 2] + wd*GRAD_4D[lutPos + 3];
 }
 
-float UFastNoise::GetNoise(float x, float y, float z)
+// GetNoise for one configuration. The settings are template parameters so the switches fold away at compile time
+template<ENoiseType NoiseType, EFractalType FractalType, EInterp Interp>
+float FFastNoise::SingleNoise(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const
 {
-	x *= m_frequency;
-	y *= m_frequency;
-	z *= m_frequency;
-
-	switch (m_noiseType)
+	switch (NoiseType)
 	{
 	case ENoiseType::Value:
-		return SingleValue(0, x, y, z);
+		return SingleValue<Interp>(0, x, y, z);
 	case ENoiseType::ValueFractal:
-		switch (m_fractalType)
+		switch (FractalType)
 		{
 		case EFractalType::FBM:
-			return SingleValueFractalFBM(x, y, z);
+			return SingleValueFractalFBM<Interp>(x, y, z, octaves, lastOctaveWeight);
 		case EFractalType::Billow:
-			return SingleValueFractalBillow(x, y, z);
+			return SingleValueFractalBillow<Interp>(x, y, z, octaves, lastOctaveWeight);
 		case EFractalType::RigidMulti:
-			return SingleValueFractalRigidMulti(x, y, z);
+			return SingleValueFractalRigidMulti<Interp>(x, y, z, octaves, lastOctaveWeight);
 		default:
 			return 0.0f;
 		}
 	case ENoiseType::Gradient:
-		return SingleGradient(0, x, y, z);
+		return SingleGradient<Interp>(0, x, y, z);
 	case ENoiseType::GradientFractal:
-		switch (m_fractalType)
+		switch (FractalType)
 		{
 		case EFractalType::FBM:
-			return SingleGradientFractalFBM(x, y, z);
+			return SingleGradientFractalFBM<Interp>(x, y, z, octaves, lastOctaveWeight);
 		case EFractalType::Billow:
-			return SingleGradientFractalBillow(x, y, z);
+			return SingleGradientFractalBillow<Interp>(x, y, z, octaves, lastOctaveWeight);
 		case EFractalType::RigidMulti:
-			return SingleGradientFractalRigidMulti(x, y, z);
+			return SingleGradientFractalRigidMulti<Interp>(x, y, z, octaves, lastOctaveWeight);
 		default:
 			return 0.0f;
 		}
 	case ENoiseType::Simplex:
 		return SingleSimplex(0, x, y, z);
 	case ENoiseType::SimplexFractal:
-		switch (m_fractalType)
+		switch (FractalType)
 		{
 		case EFractalType::FBM:
-			return SingleSimplexFractalFBM(x, y, z);
+			return SingleSimplexFractalFBM(x, y, z, octaves, lastOctaveWeight);
 		case EFractalType::Billow:
-			return SingleSimplexFractalBillow(x, y, z);
+			return SingleSimplexFractalBillow(x, y, z, octaves, lastOctaveWeight);
 		case EFractalType::RigidMulti:
-			return SingleSimplexFractalRigidMulti(x, y, z);
+			return SingleSimplexFractalRigidMulti(x, y, z, octaves, lastOctaveWeight);
 		default:
 			return 0.0f;
 		}
-	case ENoiseType::Cellular:
-		switch (m_cellularReturnType)
-		{
-		case ECellularReturnType::CellValue:
-		case ECellularReturnType::NoiseLookup:
-		case ECellularReturnType::Distance:
-			return SingleCellular(x, y, z);
-		default:
-			return SingleCellular2Edge(x, y, z);
-		}
-	case ENoiseType::WhiteNoise:
-		return GetWhiteNoise(x, y, z);
 	default:
 		return 0.0f;
 	}
 }
 
-float UFastNoise::GetNoise(float x, float y)
+template<ENoiseType NoiseType, EFractalType FractalType, EInterp Interp>
+float FFastNoise::SingleNoise(float x, float y, unsigned int octaves, float lastOctaveWeight) const
 {
-	x *= m_frequency;
-	y *= m_frequency;
-
-	switch (m_noiseType)
+	switch (NoiseType)
 	{
 	case ENoiseType::Value:
-		return SingleValue(0, x, y);
+		return SingleValue<Interp>(0, x, y);
 	case ENoiseType::ValueFractal:
-		switch (m_fractalType)
+		switch (FractalType)
 		{
 		case EFractalType::FBM:
-			return SingleValueFractalFBM(x, y);
+			return SingleValueFractalFBM<Interp>(x, y, octaves, lastOctaveWeight);
 		case EFractalType::Billow:
-			return SingleValueFractalBillow(x, y);
+			return SingleValueFractalBillow<Interp>(x, y, octaves, lastOctaveWeight);
 		case EFractalType::RigidMulti:
-			return SingleValueFractalRigidMulti(x, y);
+			return SingleValueFractalRigidMulti<Interp>(x, y, octaves, lastOctaveWeight);
 		default:
 			return 0.0f;
 		}
 	case ENoiseType::Gradient:
-		return SingleGradient(0, x, y);
+		return SingleGradient<Interp>(0, x, y);
 	case ENoiseType::GradientFractal:
-		switch (m_fractalType)
+		switch (FractalType)
 		{
 		case EFractalType::FBM:
-			return SingleGradientFractalFBM(x, y);
+			return SingleGradientFractalFBM<Interp>(x, y, octaves, lastOctaveWeight);
 		case EFractalType::Billow:
-			return SingleGradientFractalBillow(x, y);
+			return SingleGradientFractalBillow<Interp>(x, y, octaves, lastOctaveWeight);
 		case EFractalType::RigidMulti:
-			return SingleGradientFractalRigidMulti(x, y);
+			return SingleGradientFractalRigidMulti<Interp>(x, y, octaves, lastOctaveWeight);
 		default:
 			return 0.0f;
 		}
 	case ENoiseType::Simplex:
 		return SingleSimplex(0, x, y);
 	case ENoiseType::SimplexFractal:
-		switch (m_fractalType)
+		switch (FractalType)
 		{
 		case EFractalType::FBM:
-			return SingleSimplexFractalFBM(x, y);
+			return SingleSimplexFractalFBM(x, y, octaves, lastOctaveWeight);
 		case EFractalType::Billow:
-			return SingleSimplexFractalBillow(x, y);
+			return SingleSimplexFractalBillow(x, y, octaves, lastOctaveWeight);
 		case EFractalType::RigidMulti:
-			return SingleSimplexFractalRigidMulti(x, y);
+			return SingleSimplexFractalRigidMulti(x, y, octaves, lastOctaveWeight);
 		default:
 			return 0.0f;
 		}
-	case ENoiseType::Cellular:
-		switch (m_cellularReturnType)
+	default:
+		return 0.0f;
+	}
+}
+
+// Picks the SingleNoise instantiation for a configuration. Settings a noise type doesn't use are folded to one value,
+// so they don't add instantiations that would be identical
+struct FFastNoiseSingleBinder
+{
+	static constexpr bool IsFractal(ENoiseType noiseType)
+	{
+		return noiseType == ENoiseType::ValueFractal || noiseType == ENoiseType::GradientFractal || noiseType == ENoiseType::SimplexFractal;
+	}
+
+	static constexpr EFractalType UsedFractalType(ENoiseType noiseType, EFractalType fractalType)
+	{
+		return IsFractal(noiseType) ? fractalType : EFractalType::FBM;
+	}
+
+	static constexpr EInterp UsedInterp(ENoiseType noiseType, EInterp interp)
+	{
+		return noiseType == ENoiseType::Simplex || noiseType == ENoiseType::SimplexFractal ? EInterp::InterpLinear : interp;
+	}
+
+	template<ENoiseType NoiseType, EFractalType FractalType, EInterp Interp>
+	static void BindConfiguration(FFastNoise::FSingleNoise2D& outNoise2D, FFastNoise::FSingleNoise3D& outNoise3D)
+	{
+		outNoise2D = &FFastNoise::SingleNoise<NoiseType, FractalType, Interp>;
+		outNoise3D = &FFastNoise::SingleNoise<NoiseType, FractalType, Interp>;
+	}
+
+	template<ENoiseType NoiseType, EFractalType FractalType>
+	static void BindInterp(EInterp interp, FFastNoise::FSingleNoise2D& outNoise2D, FFastNoise::FSingleNoise3D& outNoise3D)
+	{
+		switch (interp)
+		{
+		case EInterp::InterpLinear:
+			BindConfiguration<NoiseType, FractalType, UsedInterp(NoiseType, EInterp::InterpLinear)>(outNoise2D, outNoise3D);
+			return;
+		case EInterp::InterpHermite:
+			BindConfiguration<NoiseType, FractalType, UsedInterp(NoiseType, EInterp::InterpHermite)>(outNoise2D, outNoise3D);
+			return;
+		default:
+			BindConfiguration<NoiseType, FractalType, UsedInterp(NoiseType, EInterp::InterpQuintic)>(outNoise2D, outNoise3D);
+			return;
+		}
+	}
+
+	template<ENoiseType NoiseType>
+	static void BindFractalType(EFractalType fractalType, EInterp interp, FFastNoise::FSingleNoise2D& outNoise2D, FFastNoise::FSingleNoise3D& outNoise3D)
+	{
+		switch (fractalType)
+		{
+		case EFractalType::Billow:
+			BindInterp<NoiseType, UsedFractalType(NoiseType, EFractalType::Billow)>(interp, outNoise2D, outNoise3D);
+			return;
+		case EFractalType::RigidMulti:
+			BindInterp<NoiseType, UsedFractalType(NoiseType, EFractalType::RigidMulti)>(interp, outNoise2D, outNoise3D);
+			return;
+		default:
+			BindInterp<NoiseType, UsedFractalType(NoiseType, EFractalType::FBM)>(interp, outNoise2D, outNoise3D);
+			return;
+		}
+	}
+
+	// Leaves the functions null for the noise types SingleNoise doesn't cover
+	static void Bind(ENoiseType noiseType, EFractalType fractalType, EInterp interp, FFastNoise::FSingleNoise2D& outNoise2D, FFastNoise::FSingleNoise3D& outNoise3D)
+	{
+		outNoise2D = nullptr;
+		outNoise3D = nullptr;
+
+		switch (noiseType)
 		{
-		case ECellularReturnType::CellValue:
-		case ECellularReturnType::NoiseLookup:
-		case ECellularReturnType::Distance:
-			return SingleCellular(x, y);
+		case ENoiseType::Value:
+			BindFractalType<ENoiseType::Value>(fractalType, interp, outNoise2D, outNoise3D);
+			return;
+		case ENoiseType::ValueFractal:
+			BindFractalType<ENoiseType::ValueFractal>(fractalType, interp, outNoise2D, outNoise3D);
+			return;
+		case ENoiseType::Gradient:
+			BindFractalType<ENoiseType::Gradient>(fractalType, interp, outNoise2D, outNoise3D);
+			return;
+		case ENoiseType::GradientFractal:
+			BindFractalType<ENoiseType::GradientFractal>(fractalType, interp, outNoise2D, outNoise3D);
+			return;
+		case ENoiseType::Simplex:
+			BindFractalType<ENoiseType::Simplex>(fractalType, interp, outNoise2D, outNoise3D);
+			return;
+		case ENoiseType::SimplexFractal:
+			BindFractalType<ENoiseType::SimplexFractal>(fractalType, interp, outNoise2D, outNoise3D);
+			return;
 		default:
-			return SingleCellular2Edge(x, y);
+			return;
 		}
+	}
+};
+
+float FFastNoise::GetNoise(float x, float y, float z) const
+{
+	return GetNoiseOctaves(x, y, z, m_octaves, 1.0f);
+}
+
+float FFastNoise::GetNoise(float x, float y) const
+{
+	return GetNoiseOctaves(x, y, m_octaves, 1.0f);
+}
+
+float FFastNoise::GetNoiseOctaves(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const
+{
+	x *= m_frequency;
+	y *= m_frequency;
+	z *= m_frequency;
+
+	if (m_singleNoise3D)
+	{
+		return (this->*m_singleNoise3D)(x, y, z, octaves, lastOctaveWeight);
+	}
+
+	switch (m_noiseType)
+	{
+	case ENoiseType::Cellular:
+		return SingleCellular(x, y, z);
+	case ENoiseType::WhiteNoise:
+		return GetWhiteNoise(x, y, z);
+	default:
+		return 0.0f;
+	}
+}
+
+float FFastNoise::GetNoiseOctaves(float x, float y, unsigned int octaves, float lastOctaveWeight) const
+{
+	x *= m_frequency;
+	y *= m_frequency;
+
+	if (m_singleNoise2D)
+	{
+		return (this->*m_singleNoise2D)(x, y, octaves, lastOctaveWeight);
+	}
+
+	switch (m_noiseType)
+	{
+	case ENoiseType::Cellular:
+		return SingleCellular(x, y);
 	case ENoiseType::WhiteNoise:
 		return GetWhiteNoise(x, y);
 	default:
@@ -436,7 +594,7 @@ float UFastNoise::GetNoise(float x, float y)
 }
 
 // White Noise
-float UFastNoise::GetWhiteNoise(float x, float y, float z, float w)
+float FFastNoise::GetWhiteNoise(float x, float y, float z, float w) const
 {
 	return ValCoord4D(m_seed,
 		*reinterpret_cast<int*>(&x) ^ (*reinterpret_cast<int*>(&x) >> 16),
@@ -445,7 +603,7 @@ float UFastNoise::GetWhiteNoise(float x, float y, float z, float w)
 		*reinterpret_cast<int*>(&w) ^ (*reinterpret_cast<int*>(&w) >> 16));
 }
 
-float UFastNoise::GetWhiteNoise(float x, float y, float z)
+float FFastNoise::GetWhiteNoise(float x, float y, float z) const
 {
 	return ValCoord3D(m_seed,
 		*reinterpret_cast<int*>(&x) ^ (*reinterpret_cast<int*>(&x) >> 16),
@@ -453,111 +611,129 @@ float UFastNoise::GetWhiteNoise(float x, float y, float z)
 		*reinterpret_cast<int*>(&z) ^ (*reinterpret_cast<int*>(&z) >> 16));
 }
 
-float UFastNoise::GetWhiteNoise(float x, float y)
+float FFastNoise::GetWhiteNoise(float x, float y) const
 {
 	return ValCoord2D(m_seed,
 		*reinterpret_cast<int*>(&x) ^ (*reinterpret_cast<int*>(&x) >> 16),
 		*reinterpret_cast<int*>(&y) ^ (*reinterpret_cast<int*>(&y) >> 16));
 }
 
-float UFastNoise::GetWhiteNoiseInt(int x, int y, int z, int w)
+float FFastNoise::GetWhiteNoiseInt(int x, int y, int z, int w) const
 {
 	return ValCoord4D(m_seed, x, y, z, w);
 }
 
-float UFastNoise::GetWhiteNoiseInt(int x, int y, int z)
+float FFastNoise::GetWhiteNoiseInt(int x, int y, int z) const
 {
 	return ValCoord3D(m_seed, x, y, z);
 }
 
-float UFastNoise::GetWhiteNoiseInt(int x, int y)
+float FFastNoise::GetWhiteNoiseInt(int x, int y) const
 {
 	return ValCoord2D(m_seed, x, y);
 }
 
 // Value Noise
-float UFastNoise::GetValueFractal(float x, float y, float z)
+float FFastNoise::GetValueFractal(float x, float y, float z) const
 {
-	x *= m_frequency;
-	y *= m_frequency;
-	z *= m_frequency;
-
-	switch (m_fractalType)
-	{
-	case EFractalType::FBM:
-		return SingleValueFractalFBM(x, y, z);
-	case EFractalType::Billow:
-		return SingleValueFractalBillow(x, y, z);
-	case EFractalType::RigidMulti:
-		return SingleValueFractalRigidMulti(x, y, z);
-	default:
-		return 0.0f;
-	}
+	FSingleNoise2D noise2D;
+	FSingleNoise3D noise3D;
+	FFastNoiseSingleBinder::Bind(ENoiseType::ValueFractal, m_fractalType, m_interp, noise2D, noise3D);
+	return (this->*noise3D)(x * m_frequency, y * m_frequency, z * m_frequency, m_octaves, 1.0f);
 }
 
-float UFastNoise::SingleValueFractalFBM(float x, float y, float z)
+template<EInterp Interp>
+float FFastNoise::SingleValueFractalFBM(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const
 {
-	float sum = SingleValue(m_perm[0], x, y, z);
+	float sum = SingleValue<Interp>(m_perm[0], x, y, z);
 	float amp = 1.0f;
 	unsigned int i = 0;
 
-	while (++i < m_octaves)
+	while (++i < octaves)
 	{
 		x *= m_lacunarity;
 		y *= m_lacunarity;
 		z *= m_lacunarity;
 
 		amp *= m_gain;
-		sum += SingleValue(m_perm[i], x, y, z) * amp;
+		if (i + 1 == octaves)
+		{
+			amp *= lastOctaveWeight;
+		}
+		sum += SingleValue<Interp>(m_perm[i], x, y, z) * amp;
 	}
 
 	return sum * m_fractalBounding;
 }
 
-float UFastNoise::SingleValueFractalBillow(float x, float y, float z)
+template<EInterp Interp>
+float FFastNoise::SingleValueFractalBillow(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const
 {
-	float sum = FastAbs(SingleValue(m_perm[0], x, y, z)) * 2.0f - 1.0f;
+	float sum = FastAbs(SingleValue<Interp>(m_perm[0], x, y, z)) * 2.0f - 1.0f;
 	float amp = 1.0f;
 	unsigned int i = 0;
 
-	while (++i < m_octaves)
+	while (++i < octaves)
 	{
 		x *= m_lacunarity;
 		y *= m_lacunarity;
 		z *= m_lacunarity;
 
 		amp *= m_gain;
-		sum += (FastAbs(SingleValue(m_perm[i], x, y, z)) * 2.0f - 1.0f) * amp;
+		if (i + 1 == octaves)
+		{
+			amp *= lastOctaveWeight;
+		}
+		sum += (FastAbs(SingleValue<Interp>(m_perm[i], x, y, z)) * 2.0f - 1.0f) * amp;
 	}
 
 	return sum * m_fractalBounding;
 }
 
-float UFastNoise::SingleValueFractalRigidMulti(float x, float y, float z)
+template<EInterp Interp>
+float FFastNoise::SingleValueFractalRigidMulti(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const
 {
-	float sum = 1.0f - FastAbs(SingleValue(m_perm[0], x, y, z));
+	float sum = 1.0f - FastAbs(SingleValue<Interp>(m_perm[0], x, y, z));
 	float amp = 1.0f;
 	unsigned int i = 0;
 
-	while (++i < m_octaves)
+	while (++i < octaves)
 	{
 		x *= m_lacunarity;
 		y *= m_lacunarity;
 		z *= m_lacunarity;
 
 		amp *= m_gain;
-		sum -= (1.0f - FastAbs(SingleValue(m_perm[i], x, y, z))) * amp;
+		if (i + 1 == octaves)
+		{
+			amp *= lastOctaveWeight;
+		}
+		sum -= (1.0f - FastAbs(SingleValue<Interp>(m_perm[i], x, y, z))) * amp;
 	}
 
 	return sum;
 }
 
-float UFastNoise::GetValue(float x, float y, float z)
+float FFastNoise::GetValue(float x, float y, float z) const
 {
 	return SingleValue(0, x * m_frequency, y * m_frequency, z * m_frequency);
 }
 
-float UFastNoise::SingleValue(unsigned char offset, float x, float y, float z)
+float FFastNoise::SingleValue(unsigned char offset, float x, float y, float z) const
+{
+	switch (m_interp)
+	{
+	case EInterp::InterpLinear:
+		return SingleValue<EInterp::InterpLinear>(offset, x, y, z);
+	case EInterp::InterpHermite:
+		return SingleValue<EInterp::InterpHermite>(offset, x, y, z);
+	default:
+		return SingleValue<EInterp::InterpQuintic>(offset, x, y, z);
+	}
+}
+
+template<EInterp Interp>
+float FFastNoise::SingleValue(unsigned char offset, float x, float y, float z) const
 {
 	int x0 = FastFloor(x);
 	int y0 = FastFloor(y);
@@ -568,7 +744,7 @@ float UFastNoise::SingleValue(unsigned char offset, float x, float y, float z)
 
 	float xs, ys, zs;
 	xs = 0.0f; ys = 0.0f; zs = 0.0f;
-	switch (m_interp)
+	switch (Interp)
 	{
 	case EInterp::InterpLinear:
 		xs = x - (float)x0;
@@ -598,83 +774,102 @@ float UFastNoise::SingleValue(unsigned char offset, float x, float y, float z)
 	return Lerp(yf0, yf1, zs);
 }
 
-float UFastNoise::GetValueFractal(float x, float y)
+float FFastNoise::GetValueFractal(float x, float y) const
 {
-	x *= m_frequency;
-	y *= m_frequency;
-
-	switch (m_fractalType)
-	{
-	case EFractalType::FBM:
-		return SingleValueFractalFBM(x, y);
-	case EFractalType::Billow:
-		return SingleValueFractalBillow(x, y);
-	case EFractalType::RigidMulti:
-		return SingleValueFractalRigidMulti(x, y);
-	default:
-		return 0.0f;
-	}
+	FSingleNoise2D noise2D;
+	FSingleNoise3D noise3D;
+	FFastNoiseSingleBinder::Bind(ENoiseType::ValueFractal, m_fractalType, m_interp, noise2D, noise3D);
+	return (this->*noise2D)(x * m_frequency, y * m_frequency, m_octaves, 1.0f);
 }
 
-float UFastNoise::SingleValueFractalFBM(float x, float y)
+template<EInterp Interp>
+float FFastNoise::SingleValueFractalFBM(float x, float y, unsigned int octaves, float lastOctaveWeight) const
 {
-	float sum = SingleValue(m_perm[0], x, y);
+	float sum = SingleValue<Interp>(m_perm[0], x, y);
 	float amp = 1.0f;
 	unsigned int i = 0;
 
-	while (++i < m_octaves)
+	while (++i < octaves)
 	{
 		x *= m_lacunarity;
 		y *= m_lacunarity;
 
 		amp *= m_gain;
-		sum += SingleValue(m_perm[i], x, y) * amp;
+		if (i + 1 == octaves)
+		{
+			amp *= lastOctaveWeight;
+		}
+		sum += SingleValue<Interp>(m_perm[i], x, y) * amp;
 	}
 
 	return sum * m_fractalBounding;
 }
 
-float UFastNoise::SingleValueFractalBillow(float x, float y)
+template<EInterp Interp>
+float FFastNoise::SingleValueFractalBillow(float x, float y, unsigned int octaves, float lastOctaveWeight) const
 {
-	float sum = FastAbs(SingleValue(m_perm[0], x, y)) * 2.0f - 1.0f;
+	float sum = FastAbs(SingleValue<Interp>(m_perm[0], x, y)) * 2.0f - 1.0f;
 	float amp = 1.0f;
 	unsigned int i = 0;
 
-	while (++i < m_octaves)
+	while (++i < octaves)
 	{
 		x *= m_lacunarity;
 		y *= m_lacunarity;
 		amp *= m_gain;
-		sum += (FastAbs(SingleValue(m_perm[i], x, y)) * 2.0f - 1.0f) * amp;
+		if (i + 1 == octaves)
+		{
+			amp *= lastOctaveWeight;
+		}
+		sum += (FastAbs(SingleValue<Interp>(m_perm[i], x, y)) * 2.0f - 1.0f) * amp;
 	}
 
 	return sum * m_fractalBounding;
 }
 
-float UFastNoise::SingleValueFractalRigidMulti(float x, float y)
+template<EInterp Interp>
+float FFastNoise::SingleValueFractalRigidMulti(float x, float y, unsigned int octaves, float lastOctaveWeight) const
 {
-	float sum = 1.0f - FastAbs(SingleValue(m_perm[0], x, y));
+	float sum = 1.0f - FastAbs(SingleValue<Interp>(m_perm[0], x, y));
 	float amp = 1.0f;
 	unsigned int i = 0;
 
-	while (++i < m_octaves)
+	while (++i < octaves)
 	{
 		x *= m_lacunarity;
 		y *= m_lacunarity;
 
 		amp *= m_gain;
-		sum -= (1.0f - FastAbs(SingleValue(m_perm[i], x, y))) * amp;
+		if (i + 1 == octaves)
+		{
+			amp *= lastOctaveWeight;
+		}
+		sum -= (1.0f - FastAbs(SingleValue<Interp>(m_perm[i], x, y))) * amp;
 	}
 
 	return sum;
 }
 
-float UFastNoise::GetValue(float x, float y)
+float FFastNoise::GetValue(float x, float y) const
 {
 	return SingleValue(0, x * m_frequency, y * m_frequency);
 }
 
-float UFastNoise::SingleValue(unsigned char offset, float x, float y)
+float FFastNoise::SingleValue(unsigned char offset, float x, float y) const
+{
+	switch (m_interp)
+	{
+	case EInterp::InterpLinear:
+		return SingleValue<EInterp::InterpLinear>(offset, x, y);
+	case EInterp::InterpHermite:
+		return SingleValue<EInterp::InterpHermite>(offset, x, y);
+	default:
+		return SingleValue<EInterp::InterpQuintic>(offset, x, y);
+	}
+}
+
+template<EInterp Interp>
+float FFastNoise::SingleValue(unsigned char offset, float x, float y) const
 {
 	int x0 = FastFloor(x);
 	int y0 = FastFloor(y);
@@ -683,7 +878,7 @@ float UFastNoise::SingleValue(unsigned char offset, float x, float y)
 
 	float xs, ys;
 	xs = 0.0f; ys = 0.0f;
-	switch (m_interp)
+	switch (Interp)
 	{
 	case EInterp::InterpLinear:
 		xs = x - (float)x0;
@@ -706,88 +901,106 @@ float UFastNoise::SingleValue(unsigned char offset, float x, float y)
 }
 
 // Gradient Noise
-float UFastNoise::GetGradientFractal(float x, float y, float z)
+float FFastNoise::GetGradientFractal(float x, float y, float z) const
 {
-	x *= m_frequency;
-	y *= m_frequency;
-	z *= m_frequency;
-
-	switch (m_fractalType)
-	{
-	case EFractalType::FBM:
-		return SingleGradientFractalFBM(x, y, z);
-	case EFractalType::Billow:
-		return SingleGradientFractalBillow(x, y, z);
-	case EFractalType::RigidMulti:
-		return SingleGradientFractalRigidMulti(x, y, z);
-	default:
-		return 0.0f;
-	}
+	FSingleNoise2D noise2D;
+	FSingleNoise3D noise3D;
+	FFastNoiseSingleBinder::Bind(ENoiseType::GradientFractal, m_fractalType, m_interp, noise2D, noise3D);
+	return (this->*noise3D)(x * m_frequency, y * m_frequency, z * m_frequency, m_octaves, 1.0f);
 }
 
-float UFastNoise::SingleGradientFractalFBM(float x, float y, float z)
+template<EInterp Interp>
+float FFastNoise::SingleGradientFractalFBM(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const
 {
-	float sum = SingleGradient(m_perm[0], x, y, z);
+	float sum = SingleGradient<Interp>(m_perm[0], x, y, z);
 	float amp = 1.0f;
 	unsigned int i = 0;
 
-	while (++i < m_octaves)
+	while (++i < octaves)
 	{
 		x *= m_lacunarity;
 		y *= m_lacunarity;
 		z *= m_lacunarity;
 
 		amp *= m_gain;
-		sum += SingleGradient(m_perm[i], x, y, z) * amp;
+		if (i + 1 == octaves)
+		{
+			amp *= lastOctaveWeight;
+		}
+		sum += SingleGradient<Interp>(m_perm[i], x, y, z) * amp;
 	}
 
 	return sum * m_fractalBounding;
 }
 
-float UFastNoise::SingleGradientFractalBillow(float x, float y, float z)
+template<EInterp Interp>
+float FFastNoise::SingleGradientFractalBillow(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const
 {
-	float sum = FastAbs(SingleGradient(m_perm[0], x, y, z)) * 2.0f - 1.0f;
+	float sum = FastAbs(SingleGradient<Interp>(m_perm[0], x, y, z)) * 2.0f - 1.0f;
 	float amp = 1.0f;
 	unsigned int i = 0;
 
-	while (++i < m_octaves)
+	while (++i < octaves)
 	{
 		x *= m_lacunarity;
 		y *= m_lacunarity;
 		z *= m_lacunarity;
 
 		amp *= m_gain;
-		sum += (FastAbs(SingleGradient(m_perm[i], x, y, z)) * 2.0f - 1.0f) * amp;
+		if (i + 1 == octaves)
+		{
+			amp *= lastOctaveWeight;
+		}
+		sum += (FastAbs(SingleGradient<Interp>(m_perm[i], x, y, z)) * 2.0f - 1.0f) * amp;
 	}
 
 	return sum * m_fractalBounding;
 }
 
-float UFastNoise::SingleGradientFractalRigidMulti(float x, float y, float z)
+template<EInterp Interp>
+float FFastNoise::SingleGradientFractalRigidMulti(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const
 {
-	float sum = 1.0f - FastAbs(SingleGradient(m_perm[0], x, y, z));
+	float sum = 1.0f - FastAbs(SingleGradient<Interp>(m_perm[0], x, y, z));
 	float amp = 1.0f;
 	unsigned int i = 0;
 
-	while (++i < m_octaves)
+	while (++i < octaves)
 	{
 		x *= m_lacunarity;
 		y *= m_lacunarity;
 		z *= m_lacunarity;
 
 		amp *= m_gain;
-		sum -= (1.0f - FastAbs(SingleGradient(m_perm[i], x, y, z))) * amp;
+		if (i + 1 == octaves)
+		{
+			amp *= lastOctaveWeight;
+		}
+		sum -= (1.0f - FastAbs(SingleGradient<Interp>(m_perm[i], x, y, z))) * amp;
 	}
 
 	return sum;
 }
 
-float UFastNoise::GetGradient(float x, float y, float z)
+float FFastNoise::GetGradient(float x, float y, float z) const
 {
 	return SingleGradient(0, x * m_frequency, y * m_frequency, z * m_frequency);
 }
 
-float UFastNoise::SingleGradient(unsigned char offset, float x, float y, float z)
+float FFastNoise::SingleGradient(unsigned char offset, float x, float y, float z) const
+{
+	switch (m_interp)
+	{
+	case EInterp::InterpLinear:
+		return SingleGradient<EInterp::InterpLinear>(offset, x, y, z);
+	case EInterp::InterpHermite:
+		return SingleGradient<EInterp::InterpHermite>(offset, x, y, z);
+	default:
+		return SingleGradient<EInterp::InterpQuintic>(offset, x, y, z);
+	}
+}
+
+template<EInterp Interp>
+float FFastNoise::SingleGradient(unsigned char offset, float x, float y, float z) const
 {
 	int x0 = FastFloor(x);
 	int y0 = FastFloor(y);
@@ -798,7 +1011,7 @@ float UFastNoise::SingleGradient(unsigned char offset, float x, float y, float z
 
 	float xs, ys, zs;
 	xs = 0.0f; ys = 0.0f; zs = 0.0f;
-	switch (m_interp)
+	switch (Interp)
 	{
 	case EInterp::InterpLinear:
 		xs = x - (float)x0;
@@ -835,84 +1048,103 @@ float UFastNoise::SingleGradient(unsigned char offset, float x, float y, float z
 	return Lerp(yf0, yf1, zs);
 }
 
-float UFastNoise::GetGradientFractal(float x, float y)
+float FFastNoise::GetGradientFractal(float x, float y) const
 {
-	x *= m_frequency;
-	y *= m_frequency;
-
-	switch (m_fractalType)
-	{
-	case EFractalType::FBM:
-		return SingleGradientFractalFBM(x, y);
-	case EFractalType::Billow:
-		return SingleGradientFractalBillow(x, y);
-	case EFractalType::RigidMulti:
-		return SingleGradientFractalRigidMulti(x, y);
-	default:
-		return 0.0f;
-	}
+	FSingleNoise2D noise2D;
+	FSingleNoise3D noise3D;
+	FFastNoiseSingleBinder::Bind(ENoiseType::GradientFractal, m_fractalType, m_interp, noise2D, noise3D);
+	return (this->*noise2D)(x * m_frequency, y * m_frequency, m_octaves, 1.0f);
 }
 
-float UFastNoise::SingleGradientFractalFBM(float x, float y)
+template<EInterp Interp>
+float FFastNoise::SingleGradientFractalFBM(float x, float y, unsigned int octaves, float lastOctaveWeight) const
 {
-	float sum = SingleGradient(m_perm[0], x, y);
+	float sum = SingleGradient<Interp>(m_perm[0], x, y);
 	float amp = 1.0f;
 	unsigned int i = 0;
 
-	while (++i < m_octaves)
+	while (++i < octaves)
 	{
 		x *= m_lacunarity;
 		y *= m_lacunarity;
 
 		amp *= m_gain;
-		sum += SingleGradient(m_perm[i], x, y) * amp;
+		if (i + 1 == octaves)
+		{
+			amp *= lastOctaveWeight;
+		}
+		sum += SingleGradient<Interp>(m_perm[i], x, y) * amp;
 	}
 
 	return sum * m_fractalBounding;
 }
 
-float UFastNoise::SingleGradientFractalBillow(float x, float y)
+template<EInterp Interp>
+float FFastNoise::SingleGradientFractalBillow(float x, float y, unsigned int octaves, float lastOctaveWeight) const
 {
-	float sum = FastAbs(SingleGradient(m_perm[0], x, y)) * 2.0f - 1.0f;
+	float sum = FastAbs(SingleGradient<Interp>(m_perm[0], x, y)) * 2.0f - 1.0f;
 	float amp = 1.0f;
 	unsigned int i = 0;
 
-	while (++i < m_octaves)
+	while (++i < octaves)
 	{
 		x *= m_lacunarity;
 		y *= m_lacunarity;
 
 		amp *= m_gain;
-		sum += (FastAbs(SingleGradient(m_perm[i], x, y)) * 2.0f - 1.0f) * amp;
+		if (i + 1 == octaves)
+		{
+			amp *= lastOctaveWeight;
+		}
+		sum += (FastAbs(SingleGradient<Interp>(m_perm[i], x, y)) * 2.0f - 1.0f) * amp;
 	}
 
 	return sum * m_fractalBounding;
 }
 
-float UFastNoise::SingleGradientFractalRigidMulti(float x, float y)
+template<EInterp Interp>
+float FFastNoise::SingleGradientFractalRigidMulti(float x, float y, unsigned int octaves, float lastOctaveWeight) const
 {
-	float sum = 1.0f - FastAbs(SingleGradient(m_perm[0], x, y));
+	float sum = 1.0f - FastAbs(SingleGradient<Interp>(m_perm[0], x, y));
 	float amp = 1.0f;
 	unsigned int i = 0;
 
-	while (++i < m_octaves)
+	while (++i < octaves)
 	{
 		x *= m_lacunarity;
 		y *= m_lacunarity;
 
 		amp *= m_gain;
-		sum -= (1.0f - FastAbs(SingleGradient(m_perm[i], x, y))) * amp;
+		if (i + 1 == octaves)
+		{
+			amp *= lastOctaveWeight;
+		}
+		sum -= (1.0f - FastAbs(SingleGradient<Interp>(m_perm[i], x, y))) * amp;
 	}
 
 	return sum;
 }
 
-float UFastNoise::GetGradient(float x, float y)
+float FFastNoise::GetGradient(float x, float y) const
 {
 	return SingleGradient(0, x * m_frequency, y * m_frequency);
 }
 
-float UFastNoise::SingleGradient(unsigned char offset, float x, float y)
+float FFastNoise::SingleGradient(unsigned char offset, float x, float y) const
+{
+	switch (m_interp)
+	{
+	case EInterp::InterpLinear:
+		return SingleGradient<EInterp::InterpLinear>(offset, x, y);
+	case EInterp::InterpHermite:
+		return SingleGradient<EInterp::InterpHermite>(offset, x, y);
+	default:
+		return SingleGradient<EInterp::InterpQuintic>(offset, x, y);
+	}
+}
+
+template<EInterp Interp>
+float FFastNoise::SingleGradient(unsigned char offset, float x, float y) const
 {
 	int x0 = FastFloor(x);
 	int y0 = FastFloor(y);
@@ -921,7 +1153,7 @@ float UFastNoise::SingleGradient(unsigned char offset, float x, float y)
 
 	float xs, ys;
 	xs = 0.0f; ys = 0.0f;
-	switch (m_interp)
+	switch (Interp)
 	{
 	case EInterp::InterpLinear:
 		xs = x - (float)x0;
@@ -950,7 +1182,7 @@ float UFastNoise::SingleGradient(unsigned char offset, float x, float y)
 
 // Simplex Noise
 
-float UFastNoise::GetSimplexFractal(float x, float y, float z)
+float FFastNoise::GetSimplexFractal(float x, float y, float z) const
 {
 	x *= m_frequency;
 	y *= m_frequency;
@@ -959,74 +1191,86 @@ float UFastNoise::GetSimplexFractal(float x, float y, float z)
 	switch (m_fractalType)
 	{
 	case EFractalType::FBM:
-		return SingleSimplexFractalFBM(x, y, z);
+		return SingleSimplexFractalFBM(x, y, z, m_octaves, 1.0f);
 	case EFractalType::Billow:
-		return SingleSimplexFractalBillow(x, y, z);
+		return SingleSimplexFractalBillow(x, y, z, m_octaves, 1.0f);
 	case EFractalType::RigidMulti:
-		return SingleSimplexFractalRigidMulti(x, y, z);
+		return SingleSimplexFractalRigidMulti(x, y, z, m_octaves, 1.0f);
 	default:
 		return 0.0f;
 	}
 }
 
-float UFastNoise::SingleSimplexFractalFBM(float x, float y, float z)
+float FFastNoise::SingleSimplexFractalFBM(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const
 {
 	float sum = SingleSimplex(m_perm[0], x, y, z);
 	float amp = 1.0f;
 	unsigned int i = 0;
 
-	while (++i < m_octaves)
+	while (++i < octaves)
 	{
 		x *= m_lacunarity;
 		y *= m_lacunarity;
 		z *= m_lacunarity;
 
 		amp *= m_gain;
+		if (i + 1 == octaves)
+		{
+			amp *= lastOctaveWeight;
+		}
 		sum += SingleSimplex(m_perm[i], x, y, z) * amp;
 	}
 
 	return sum * m_fractalBounding;
 }
 
-float UFastNoise::SingleSimplexFractalBillow(float x, float y, float z)
+float FFastNoise::SingleSimplexFractalBillow(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const
 {
 	float sum = FastAbs(SingleSimplex(m_perm[0], x, y, z)) * 2.0f - 1.0f;
 	float amp = 1.0f;
 	unsigned int i = 0;
 
-	while (++i < m_octaves)
+	while (++i < octaves)
 	{
 		x *= m_lacunarity;
 		y *= m_lacunarity;
 		z *= m_lacunarity;
 
 		amp *= m_gain;
+		if (i + 1 == octaves)
+		{
+			amp *= lastOctaveWeight;
+		}
 		sum += (FastAbs(SingleSimplex(m_perm[i], x, y, z)) * 2.0f - 1.0f) * amp;
 	}
 
 	return sum * m_fractalBounding;
 }
 
-float UFastNoise::SingleSimplexFractalRigidMulti(float x, float y, float z)
+float FFastNoise::SingleSimplexFractalRigidMulti(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const
 {
 	float sum = 1.0f - FastAbs(SingleSimplex(m_perm[0], x, y, z));
 	float amp = 1.0f;
 	unsigned int i = 0;
 
-	while (++i < m_octaves)
+	while (++i < octaves)
 	{
 		x *= m_lacunarity;
 		y *= m_lacunarity;
 		z *= m_lacunarity;
 
 		amp *= m_gain;
+		if (i + 1 == octaves)
+		{
+			amp *= lastOctaveWeight;
+		}
 		sum -= (1.0f - FastAbs(SingleSimplex(m_perm[i], x, y, z))) * amp;
 	}
 
 	return sum;
 }
 
-float UFastNoise::GetSimplex(float x, float y, float z)
+float FFastNoise::GetSimplex(float x, float y, float z) const
 {
 	return SingleSimplex(0, x * m_frequency, y * m_frequency, z * m_frequency);
 }
@@ -1034,7 +1278,7 @@ float UFastNoise::GetSimplex(float x, float y, float z)
 static const float F3 = 1.0f / 3.0f;
 static const float G3 = 1.0f / 6.0f;
 
-float UFastNoise::SingleSimplex(unsigned char offset, float x, float y, float z)
+float FFastNoise::SingleSimplex(unsigned char offset, float x, float y, float z) const
 {
 	float t = (x + y + z) * F3;
 	int i = FastFloor(x + t);
@@ -1131,7 +1375,7 @@ float UFastNoise::SingleSimplex(unsigned char offset, float x, float y, float z)
 	return 32.0f * (n0 + n1 + n2 + n3);
 }
 
-float UFastNoise::GetSimplexFractal(float x, float y)
+float FFastNoise::GetSimplexFractal(float x, float y) const
 {
 	x *= m_frequency;
 	y *= m_frequency;
@@ -1139,71 +1383,83 @@ float UFastNoise::GetSimplexFractal(float x, float y)
 	switch (m_fractalType)
 	{
 	case EFractalType::FBM:
-		return SingleSimplexFractalFBM(x, y);
+		return SingleSimplexFractalFBM(x, y, m_octaves, 1.0f);
 	case EFractalType::Billow:
-		return SingleSimplexFractalBillow(x, y);
+		return SingleSimplexFractalBillow(x, y, m_octaves, 1.0f);
 	case EFractalType::RigidMulti:
-		return SingleSimplexFractalRigidMulti(x, y);
+		return SingleSimplexFractalRigidMulti(x, y, m_octaves, 1.0f);
 	default:
 		return 0.0f;
 	}
 }
 
-float UFastNoise::SingleSimplexFractalFBM(float x, float y)
+float FFastNoise::SingleSimplexFractalFBM(float x, float y, unsigned int octaves, float lastOctaveWeight) const
 {
 	float sum = SingleSimplex(m_perm[0], x, y);
 	float amp = 1.0f;
 	unsigned int i = 0;
 
-	while (++i < m_octaves)
+	while (++i < octaves)
 	{
 		x *= m_lacunarity;
 		y *= m_lacunarity;
 
 		amp *= m_gain;
+		if (i + 1 == octaves)
+		{
+			amp *= lastOctaveWeight;
+		}
 		sum += SingleSimplex(m_perm[i], x, y) * amp;
 	}
 
 	return sum * m_fractalBounding;
 }
 
-float UFastNoise::SingleSimplexFractalBillow(float x, float y)
+float FFastNoise::SingleSimplexFractalBillow(float x, float y, unsigned int octaves, float lastOctaveWeight) const
 {
 	float sum = FastAbs(SingleSimplex(m_perm[0], x, y)) * 2.0f - 1.0f;
 	float amp = 1.0f;
 	unsigned int i = 0;
 
-	while (++i < m_octaves)
+	while (++i < octaves)
 	{
 		x *= m_lacunarity;
 		y *= m_lacunarity;
 
 		amp *= m_gain;
+		if (i + 1 == octaves)
+		{
+			amp *= lastOctaveWeight;
+		}
 		sum += (FastAbs(SingleSimplex(m_perm[i], x, y)) * 2.0f - 1.0f) * amp;
 	}
 
 	return sum * m_fractalBounding;
 }
 
-float UFastNoise::SingleSimplexFractalRigidMulti(float x, float y)
+float FFastNoise::SingleSimplexFractalRigidMulti(float x, float y, unsigned int octaves, float lastOctaveWeight) const
 {
 	float sum = 1.0f - FastAbs(SingleSimplex(m_perm[0], x, y));
 	float amp = 1.0f;
 	unsigned int i = 0;
 
-	while (++i < m_octaves)
+	while (++i < octaves)
 	{
 		x *= m_lacunarity;
 		y *= m_lacunarity;
 
 		amp *= m_gain;
+		if (i + 1 == octaves)
+		{
+			amp *= lastOctaveWeight;
+		}
 		sum -= (1.0f - FastAbs(SingleSimplex(m_perm[i], x, y))) * amp;
 	}
 
 	return sum;
 }
 
-float UFastNoise::GetSimplex(float x, float y)
+float FFastNoise::GetSimplex(float x, float y) const
 {
 	return SingleSimplex(0, x * m_frequency, y * m_frequency);
 }
@@ -1211,7 +1467,7 @@ float UFastNoise::GetSimplex(float x, float y)
 static const float F2 = 1.f / 2.f;
 static const float G2 = 1.f / 4.f;
 
-float UFastNoise::SingleSimplex(unsigned char offset, float x, float y)
+float FFastNoise::SingleSimplex(unsigned char offset, float x, float y) const
 {
 	float t = (x + y) * F2;
 	int i = FastFloor(x + t);
@@ -1268,7 +1524,7 @@ float UFastNoise::SingleSimplex(unsigned char offset, float x, float y)
 	return  50.0f * (n0 + n1 + n2);
 }
 
-float UFastNoise::GetSimplex(float x, float y, float z, float w)
+float FFastNoise::GetSimplex(float x, float y, float z, float w) const
 {
 	return SingleSimplex(0, x * m_frequency, y * m_frequency, z * m_frequency, w * m_frequency);
 }
@@ -1288,7 +1544,7 @@ static const int SIMPLEX_4D[] =
 static const float F4 = (sqrtf(5.0f) - 1.0f) / 4.0f;
 static const float G4 = (5.0f - sqrtf(5.0f)) / 20.0f;
 
-float UFastNoise::SingleSimplex(unsigned char offset, float x, float y, float z, float w)
+float FFastNoise::SingleSimplex(unsigned char offset, float x, float y, float z, float w) const
 {
 	float n0, n1, n2, n3, n4;
 	float t = (x + y + z + w) * F4;
@@ -1379,215 +1635,160 @@ float UFastNoise::SingleSimplex(unsigned char offset, float x, float y, float z,
 }
 
 // Cellular Noise
-float UFastNoise::GetCellular(float x, float y, float z)
+//
+// One search per point serves every return type. Cells are visited centre first, then the rest in the order of
+// CELLULAR_SEARCH_ORDER, and planes and rows are skipped when FASTNOISE_CELL_JITTER_BOUND shows they can't hold a
+// closer feature point than the closest so far, or the second closest for the Distance2 return types. Checking single
+// cells as well costs more in mispredicted branches than it saves here, the batch kernels check them as it saves gathers.
+// Both search in the same order, so ties between equally distant cells go the same way
+static const int CELLULAR_SEARCH_ORDER[3] = { 0, -1, 1 };
+
+template<ECellularDistanceFunction Distance>
+static float CellularDistance(float x, float y)
 {
-	x *= m_frequency;
-	y *= m_frequency;
-	z *= m_frequency;
-
-	switch (m_cellularReturnType)
+	switch (Distance)
 	{
-	case ECellularReturnType::CellValue:
-	case ECellularReturnType::NoiseLookup:
-	case ECellularReturnType::Distance:
-		return SingleCellular(x, y, z);
+	case ECellularDistanceFunction::Manhattan:
+		return FastAbs(x) + FastAbs(y);
+	case ECellularDistanceFunction::Natural:
+		return (FastAbs(x) + FastAbs(y)) + (x * x + y * y);
 	default:
-		return SingleCellular2Edge(x, y, z);
+		return x * x + y * y;
 	}
 }
 
-float UFastNoise::SingleCellular(float x, float y, float z)
+template<ECellularDistanceFunction Distance>
+static float CellularDistance(float x, float y, float z)
 {
-	int xr = FastRound(x);
-	int yr = FastRound(y);
-	int zr = FastRound(z);
-
-	float distance = 999999.f;
-	int xc, yc, zc;
-	xc = 0; yc = 0; zc = 0;
-	switch (m_cellularDistanceFunction)
+	switch (Distance)
 	{
-	case ECellularDistanceFunction::Euclidean:
-		for (int xi = xr - 1; xi <= xr + 1; xi++)
-		{
-			for (int yi = yr - 1; yi <= yr + 1; yi++)
-			{
-				for (int zi = zr - 1; zi <= zr + 1; zi++)
-				{
-					unsigned char lutPos = Index3D_256(0, xi, yi, zi);
-
-					float vecX = xi - x + CELL_3D_X[lutPos];
-					float vecY = yi - y + CELL_3D_Y[lutPos];
-					float vecZ = zi - z + CELL_3D_Z[lutPos];
-
-					float newDistance = vecX * vecX + vecY * vecY + vecZ * vecZ;
-
-					if (newDistance < distance)
-					{
-						distance = newDistance;
-						xc = xi;
-						yc = yi;
-						zc = zi;
-					}
-				}
-			}
-		}
-		break;
 	case ECellularDistanceFunction::Manhattan:
-		for (int xi = xr - 1; xi <= xr + 1; xi++)
-		{
-			for (int yi = yr - 1; yi <= yr + 1; yi++)
-			{
-				for (int zi = zr - 1; zi <= zr + 1; zi++)
-				{
-					unsigned char lutPos = Index3D_256(0, xi, yi, zi);
-
-					float vecX = xi - x + CELL_3D_X[lutPos];
-					float vecY = yi - y + CELL_3D_Y[lutPos];
-					float vecZ = zi - z + CELL_3D_Z[lutPos];
-
-					float newDistance = FastAbs(vecX) + FastAbs(vecY) + FastAbs(vecZ);
-
-					if (newDistance < distance)
-					{
-						distance = newDistance;
-						xc = xi;
-						yc = yi;
-						zc = zi;
-					}
-				}
-			}
-		}
-		break;
+		return FastAbs(x) + FastAbs(y) + FastAbs(z);
 	case ECellularDistanceFunction::Natural:
-		for (int xi = xr - 1; xi <= xr + 1; xi++)
-		{
-			for (int yi = yr - 1; yi <= yr + 1; yi++)
-			{
-				for (int zi = zr - 1; zi <= zr + 1; zi++)
-				{
-					unsigned char lutPos = Index3D_256(0, xi, yi, zi);
-
-					float vecX = xi - x + CELL_3D_X[lutPos];
-					float vecY = yi - y + CELL_3D_Y[lutPos];
-					float vecZ = zi - z + CELL_3D_Z[lutPos];
-
-					float newDistance = (FastAbs(vecX) + FastAbs(vecY) + FastAbs(vecZ)) + (vecX * vecX + vecY * vecY + vecZ * vecZ);
-
-					if (newDistance < distance)
-					{
-						distance = newDistance;
-						xc = xi;
-						yc = yi;
-						zc = zi;
-					}
-				}
-			}
-		}
-		break;
+		return (FastAbs(x) + FastAbs(y) + FastAbs(z)) + (x * x + y * y + z * z);
 	default:
-		break;
+		return x * x + y * y + z * z;
 	}
+}
 
-	unsigned char lutPos;
-	switch (m_cellularReturnType)
-	{
-	case ECellularReturnType::CellValue:
-		return ValCoord3D(0, xc, yc, zc);
-
-	case ECellularReturnType::NoiseLookup:
-		check(m_cellularNoiseLookup);
+// Lower bound of the distance along an axis from x to the feature point of cell xi
+static float CellularAxisBound(int xi, float x)
+{
+	return fmaxf(FastAbs(xi - x) - FASTNOISE_CELL_JITTER_BOUND, 0.0f);
+}
 
-		lutPos = Index3D_256(0, xc, yc, zc);
-		return m_cellularNoiseLookup->GetNoise(xc + CELL_3D_X[lutPos], yc + CELL_3D_Y[lutPos], zc + CELL_3D_Z[lutPos]);
+float FFastNoise::GetCellular(float x, float y, float z) const
+{
+	x *= m_frequency;
+	y *= m_frequency;
+	z *= m_frequency;
 
-	case ECellularReturnType::Distance:
-		return distance - 1.0f;
-	default:
-		return 0.0f;
-	}
+	return SingleCellular(x, y, z);
 }
 
-float UFastNoise::SingleCellular2Edge(float x, float y, float z)
+template<ECellularDistanceFunction Distance, bool bDistance2>
+void FFastNoise::SingleCellularSearch(float x, float y, float z, float& distance, float& distance2, int& xc, int& yc, int& zc) const
 {
 	int xr = FastRound(x);
 	int yr = FastRound(y);
 	int zr = FastRound(z);
 
-	float distance = 999999.f;
-	float distance2 = 999999.f;
+	distance = 999999.f;
+	distance2 = 999999.f;
+	xc = xr; yc = yr; zc = zr;
 
-	switch (m_cellularDistanceFunction)
+	for (int zo : CELLULAR_SEARCH_ORDER)
 	{
-	case ECellularDistanceFunction::Euclidean:
-		for (int xi = xr - 1; xi <= xr + 1; xi++)
+		int zi = zr + zo;
+		float boundZ = CellularAxisBound(zi, z);
+		if (CellularDistance<Distance>(0.0f, 0.0f, boundZ) > (bDistance2 ? distance2 : distance))
+			continue;
+
+		for (int yo : CELLULAR_SEARCH_ORDER)
 		{
-			for (int yi = yr - 1; yi <= yr + 1; yi++)
+			int yi = yr + yo;
+			float boundY = CellularAxisBound(yi, y);
+			if (CellularDistance<Distance>(0.0f, boundY, boundZ) > (bDistance2 ? distance2 : distance))
+				continue;
+
+			for (int xo : CELLULAR_SEARCH_ORDER)
 			{
-				for (int zi = zr - 1; zi <= zr + 1; zi++)
-				{
-					unsigned char lutPos = Index3D_256(0, xi, yi, zi);
+				int xi = xr + xo;
+				unsigned char lutPos = Index3D_256(0, xi, yi, zi);
 
-					float vecX = xi - x + CELL_3D_X[lutPos];
-					float vecY = yi - y + CELL_3D_Y[lutPos];
-					float vecZ = zi - z + CELL_3D_Z[lutPos];
+				float vecX = xi - x + CELL_3D_X[lutPos];
+				float vecY = yi - y + CELL_3D_Y[lutPos];
+				float vecZ = zi - z + CELL_3D_Z[lutPos];
 
-					float newDistance = vecX * vecX + vecY * vecY + vecZ * vecZ;
+				float newDistance = CellularDistance<Distance>(vecX, vecY, vecZ);
 
+				if (bDistance2)
+				{
 					distance2 = fmaxf(fminf(distance2, newDistance), distance);
 					distance = fminf(distance, newDistance);
 				}
-			}
-		}
-		break;
-	case ECellularDistanceFunction::Manhattan:
-		for (int xi = xr - 1; xi <= xr + 1; xi++)
-		{
-			for (int yi = yr - 1; yi <= yr + 1; yi++)
-			{
-				for (int zi = zr - 1; zi <= zr + 1; zi++)
+				else if (newDistance < distance)
 				{
-					unsigned char lutPos = Index3D_256(0, xi, yi, zi);
-
-					float vecX = xi - x + CELL_3D_X[lutPos];
-					float vecY = yi - y + CELL_3D_Y[lutPos];
-					float vecZ = zi - z + CELL_3D_Z[lutPos];
-
-					float newDistance = FastAbs(vecX) + FastAbs(vecY) + FastAbs(vecZ);
-
-					distance2 = fmaxf(fminf(distance2, newDistance), distance);
-					distance = fminf(distance, newDistance);
+					distance = newDistance;
+					xc = xi;
+					yc = yi;
+					zc = zi;
 				}
 			}
 		}
-		break;
-	case ECellularDistanceFunction::Natural:
-		for (int xi = xr - 1; xi <= xr + 1; xi++)
-		{
-			for (int yi = yr - 1; yi <= yr + 1; yi++)
-			{
-				for (int zi = zr - 1; zi <= zr + 1; zi++)
-				{
-					unsigned char lutPos = Index3D_256(0, xi, yi, zi);
-
-					float vecX = xi - x + CELL_3D_X[lutPos];
-					float vecY = yi - y + CELL_3D_Y[lutPos];
-					float vecZ = zi - z + CELL_3D_Z[lutPos];
+	}
+}
 
-					float newDistance = (FastAbs(vecX) + FastAbs(vecY) + FastAbs(vecZ)) + (vecX * vecX + vecY * vecY + vecZ * vecZ);
+float FFastNoise::SingleCellular(float x, float y, float z) const
+{
+	float distance, distance2;
+	int xc, yc, zc;
 
-					distance2 = fmaxf(fminf(distance2, newDistance), distance);
-					distance = fminf(distance, newDistance);
-				}
-			}
+	if (m_cellularReturnType >= ECellularReturnType::Distance2)
+	{
+		switch (m_cellularDistanceFunction)
+		{
+		case ECellularDistanceFunction::Manhattan:
+			SingleCellularSearch<ECellularDistanceFunction::Manhattan, true>(x, y, z, distance, distance2, xc, yc, zc);
+			break;
+		case ECellularDistanceFunction::Natural:
+			SingleCellularSearch<ECellularDistanceFunction::Natural, true>(x, y, z, distance, distance2, xc, yc, zc);
+			break;
+		default:
+			SingleCellularSearch<ECellularDistanceFunction::Euclidean, true>(x, y, z, distance, distance2, xc, yc, zc);
+			break;
+		}
+	}
+	else
+	{
+		switch (m_cellularDistanceFunction)
+		{
+		case ECellularDistanceFunction::Manhattan:
+			SingleCellularSearch<ECellularDistanceFunction::Manhattan, false>(x, y, z, distance, distance2, xc, yc, zc);
+			break;
+		case ECellularDistanceFunction::Natural:
+			SingleCellularSearch<ECellularDistanceFunction::Natural, false>(x, y, z, distance, distance2, xc, yc, zc);
+			break;
+		default:
+			SingleCellularSearch<ECellularDistanceFunction::Euclidean, false>(x, y, z, distance, distance2, xc, yc, zc);
+			break;
 		}
-		break;
-	default:
-		break;
 	}
 
+	unsigned char lutPos;
 	switch (m_cellularReturnType)
 	{
+	case ECellularReturnType::CellValue:
+		return ValCoord3D(0, xc, yc, zc);
+
+	case ECellularReturnType::NoiseLookup:
+		check(m_cellularNoiseLookup);
+
+		lutPos = Index3D_256(0, xc, yc, zc);
+		return m_cellularNoiseLookup->GetNoise(xc + CELL_3D_X[lutPos], yc + CELL_3D_Y[lutPos], zc + CELL_3D_Z[lutPos]);
+
+	case ECellularReturnType::Distance:
+		return distance - 1.0f;
 	case ECellularReturnType::Distance2:
 		return distance2 - 1.0f;
 	case ECellularReturnType::Distance2Add:
@@ -1603,97 +1804,90 @@ float UFastNoise::SingleCellular2Edge(float x, float y, float z)
 	}
 }
 
-float UFastNoise::GetCellular(float x, float y)
+float FFastNoise::GetCellular(float x, float y) const
 {
 	x *= m_frequency;
 	y *= m_frequency;
 
-	switch (m_cellularReturnType)
-	{
-	case ECellularReturnType::CellValue:
-	case ECellularReturnType::NoiseLookup:
-	case ECellularReturnType::Distance:
-		return SingleCellular(x, y);
-	default:
-		return SingleCellular2Edge(x, y);
-	}
+	return SingleCellular(x, y);
 }
 
-float UFastNoise::SingleCellular(float x, float y)
+template<ECellularDistanceFunction Distance, bool bDistance2>
+void FFastNoise::SingleCellularSearch(float x, float y, float& distance, float& distance2, int& xc, int& yc) const
 {
 	int xr = FastRound(x);
 	int yr = FastRound(y);
 
-	float distance = 999999.f;
-	int xc, yc;
-	xc = 0; yc = 0;
+	distance = 999999.f;
+	distance2 = 999999.f;
+	xc = xr; yc = yr;
 
-	switch (m_cellularDistanceFunction)
+	for (int yo : CELLULAR_SEARCH_ORDER)
 	{
-	default:
-	case ECellularDistanceFunction::Euclidean:
-		for (int xi = xr - 1; xi <= xr + 1; xi++)
+		int yi = yr + yo;
+		float boundY = CellularAxisBound(yi, y);
+		if (CellularDistance<Distance>(0.0f, boundY) > (bDistance2 ? distance2 : distance))
+			continue;
+
+		for (int xo : CELLULAR_SEARCH_ORDER)
 		{
-			for (int yi = yr - 1; yi <= yr + 1; yi++)
-			{
-				unsigned char lutPos = Index2D_256(0, xi, yi);
+			int xi = xr + xo;
+			unsigned char lutPos = Index2D_256(0, xi, yi);
 
-				float vecX = xi - x + CELL_2D_X[lutPos];
-				float vecY = yi - y + CELL_2D_Y[lutPos];
+			float vecX = xi - x + CELL_2D_X[lutPos];
+			float vecY = yi - y + CELL_2D_Y[lutPos];
 
-				float newDistance = vecX * vecX + vecY * vecY;
+			float newDistance = CellularDistance<Distance>(vecX, vecY);
 
-				if (newDistance < distance)
-				{
-					distance = newDistance;
-					xc = xi;
-					yc = yi;
-				}
+			if (bDistance2)
+			{
+				distance2 = fmaxf(fminf(distance2, newDistance), distance);
+				distance = fminf(distance, newDistance);
 			}
-		}
-		break;
-	case ECellularDistanceFunction::Manhattan:
-		for (int xi = xr - 1; xi <= xr + 1; xi++)
-		{
-			for (int yi = yr - 1; yi <= yr + 1; yi++)
+			else if (newDistance < distance)
 			{
-				unsigned char lutPos = Index2D_256(0, xi, yi);
-
-				float vecX = xi - x + CELL_2D_X[lutPos];
-				float vecY = yi - y + CELL_2D_Y[lutPos];
-
-				float newDistance = (FastAbs(vecX) + FastAbs(vecY));
-
-				if (newDistance < distance)
-				{
-					distance = newDistance;
-					xc = xi;
-					yc = yi;
-				}
+				distance = newDistance;
+				xc = xi;
+				yc = yi;
 			}
 		}
-		break;
-	case ECellularDistanceFunction::Natural:
-		for (int xi = xr - 1; xi <= xr + 1; xi++)
-		{
-			for (int yi = yr - 1; yi <= yr + 1; yi++)
-			{
-				unsigned char lutPos = Index2D_256(0, xi, yi);
-
-				float vecX = xi - x + CELL_2D_X[lutPos];
-				float vecY = yi - y + CELL_2D_Y[lutPos];
+	}
+}
 
-				float newDistance = (FastAbs(vecX) + FastAbs(vecY)) + (vecX * vecX + vecY * vecY);
+float FFastNoise::SingleCellular(float x, float y) const
+{
+	float distance, distance2;
+	int xc, yc;
 
-				if (newDistance < distance)
-				{
-					distance = newDistance;
-					xc = xi;
-					yc = yi;
-				}
-			}
+	if (m_cellularReturnType >= ECellularReturnType::Distance2)
+	{
+		switch (m_cellularDistanceFunction)
+		{
+		case ECellularDistanceFunction::Manhattan:
+			SingleCellularSearch<ECellularDistanceFunction::Manhattan, true>(x, y, distance, distance2, xc, yc);
+			break;
+		case ECellularDistanceFunction::Natural:
+			SingleCellularSearch<ECellularDistanceFunction::Natural, true>(x, y, distance, distance2, xc, yc);
+			break;
+		default:
+			SingleCellularSearch<ECellularDistanceFunction::Euclidean, true>(x, y, distance, distance2, xc, yc);
+			break;
+		}
+	}
+	else
+	{
+		switch (m_cellularDistanceFunction)
+		{
+		case ECellularDistanceFunction::Manhattan:
+			SingleCellularSearch<ECellularDistanceFunction::Manhattan, false>(x, y, distance, distance2, xc, yc);
+			break;
+		case ECellularDistanceFunction::Natural:
+			SingleCellularSearch<ECellularDistanceFunction::Natural, false>(x, y, distance, distance2, xc, yc);
+			break;
+		default:
+			SingleCellularSearch<ECellularDistanceFunction::Euclidean, false>(x, y, distance, distance2, xc, yc);
+			break;
 		}
-		break;
 	}
 
 	unsigned char lutPos;
@@ -1710,77 +1904,6 @@ float UFastNoise::SingleCellular(float x, float y)
 
 	case ECellularReturnType::Distance:
 		return distance - 1.0f;
-	default:
-		return 0.0f;
-	}
-}
-
-float UFastNoise::SingleCellular2Edge(float x, float y)
-{
-	int xr = FastRound(x);
-	int yr = FastRound(y);
-
-	float distance = 999999.f;
-	float distance2 = 999999.f;
-
-	switch (m_cellularDistanceFunction)
-	{
-	default:
-	case ECellularDistanceFunction::Euclidean:
-		for (int xi = xr - 1; xi <= xr + 1; xi++)
-		{
-			for (int yi = yr - 1; yi <= yr + 1; yi++)
-			{
-				unsigned char lutPos = Index2D_256(0, xi, yi);
-
-				float vecX = xi - x + CELL_2D_X[lutPos];
-				float vecY = yi - y + CELL_2D_Y[lutPos];
-
-				float newDistance = vecX * vecX + vecY * vecY;
-
-				distance2 = fmaxf(fminf(distance2, newDistance), distance);
-				distance = fminf(distance, newDistance);
-			}
-		}
-		break;
-	case ECellularDistanceFunction::Manhattan:
-		for (int xi = xr - 1; xi <= xr + 1; xi++)
-		{
-			for (int yi = yr - 1; yi <= yr + 1; yi++)
-			{
-				unsigned char lutPos = Index2D_256(0, xi, yi);
-
-				float vecX = xi - x + CELL_2D_X[lutPos];
-				float vecY = yi - y + CELL_2D_Y[lutPos];
-
-				float newDistance = FastAbs(vecX) + FastAbs(vecY);
-
-				distance2 = fmaxf(fminf(distance2, newDistance), distance);
-				distance = fminf(distance, newDistance);
-			}
-		}
-		break;
-	case ECellularDistanceFunction::Natural:
-		for (int xi = xr - 1; xi <= xr + 1; xi++)
-		{
-			for (int yi = yr - 1; yi <= yr + 1; yi++)
-			{
-				unsigned char lutPos = Index2D_256(0, xi, yi);
-
-				float vecX = xi - x + CELL_2D_X[lutPos];
-				float vecY = yi - y + CELL_2D_Y[lutPos];
-
-				float newDistance = (FastAbs(vecX) + FastAbs(vecY)) + (vecX * vecX + vecY * vecY);
-
-				distance2 = fmaxf(fminf(distance2, newDistance), distance);
-				distance = fminf(distance, newDistance);
-			}
-		}
-		break;
-	}
-
-	switch (m_cellularReturnType)
-	{
 	case ECellularReturnType::Distance2:
 		return distance2 - 1.0f;
 	case ECellularReturnType::Distance2Add:
@@ -1796,12 +1919,12 @@ float UFastNoise::SingleCellular2Edge(float x, float y)
 	}
 }
 
-void UFastNoise::PositionWarp(float& x, float& y, float& z)
+void FFastNoise::PositionWarp(float& x, float& y, float& z) const
 {
 	SinglePositionWarp(0, m_positionWarpAmp, m_frequency, x, y, z);
 }
 
-void UFastNoise::PositionWarpFractal(float& x, float& y, float& z)
+void FFastNoise::PositionWarpFractal(float& x, float& y, float& z) const
 {
 	float amp = m_positionWarpAmp * m_fractalBounding;
 	float freq = m_frequency;
@@ -1817,7 +1940,7 @@ void UFastNoise::PositionWarpFractal(float& x, float& y, float& z)
 	}
 }
 
-void UFastNoise::SinglePositionWarp(unsigned char offset, float warpAmp, float frequency, float& x, float& y, float& z)
+void FFastNoise::SinglePositionWarp(unsigned char offset, float warpAmp, float frequency, float& x, float& y, float& z) const
 {
 	float xf = x * frequency;
 	float yf = y * frequency;
@@ -1888,12 +2011,12 @@ void UFastNoise::SinglePositionWarp(unsigned char offset, float warpAmp, float f
 	z += Lerp(lz0y, Lerp(lz0x, lz1x, ys), zs) * warpAmp;
 }
 
-void UFastNoise::PositionWarp(float& x, float& y)
+void FFastNoise::PositionWarp(float& x, float& y) const
 {
 	SinglePositionWarp(0, m_positionWarpAmp, m_frequency, x, y);
 }
 
-void UFastNoise::PositionWarpFractal(float& x, float& y)
+void FFastNoise::PositionWarpFractal(float& x, float& y) const
 {
 	float amp = m_positionWarpAmp * m_fractalBounding;
 	float freq = m_frequency;
@@ -1909,7 +2032,7 @@ void UFastNoise::PositionWarpFractal(float& x, float& y)
 	}
 }
 
-void UFastNoise::SinglePositionWarp(unsigned char offset, float warpAmp, float frequency, float& x, float& y)
+void FFastNoise::SinglePositionWarp(unsigned char offset, float warpAmp, float frequency, float& x, float& y) const
 {
 	float xf = x * frequency;
 	float yf = y * frequency;
@@ -1953,53 +2076,608 @@ void UFastNoise::SinglePositionWarp(unsigned char offset, float warpAmp, float f
 	y += Lerp(ly0x, ly1x, ys) * warpAmp;
 }
 
-FVector UFastNoise::GetNoise2DDeriv(float x, float y)
-{
-	FVector2D p = FVector2D(x, y);
-	p.X = FMath::FloorToFloat(p.X);
-	p.Y = FMath::FloorToFloat(p.Y);
-	FVector2D f = FVector2D(x, y) - p;
-
-	
+// Derivatives
 
-	FVector2D u = f*f*f;
-
-	float a = GetNoise2D(p.X, p.Y);
-	float b = GetNoise2D(p.X + 1.f, p.Y);
-	float c = GetNoise2D(p.X, p.Y + 1.f);
-	float d = GetNoise2D(p.X + 1.0f, p.Y + 1.0f);
-
-	FVector result;
-
-	const FVector2D Intermediate = 6.0f*f*(f)*(FVector2D(b - a, c - a) + (a - b - c + d)*(FVector2D(u.Y, u.X)));
-
-	result = FVector(a + (b - a)*u.X + (c - a)*u.Y + (a - b - c + d)*u.X*u.Y,
-		Intermediate.X, Intermediate.Y);
-
-	//result = FVector(a + (b - a)*u.X + (c - a)*u.Y + (a - b - c + d)*u.X*u.Y,
-		//6.0*f*(1.0 - f)*(FVector2D(b - a, c - a) + (a - b - c + d)*(FVector2D(u.Y, u.X))));
-
-	return result;
+// A value and its gradient, carried through the interpolation so the gradient comes out of the same evaluation.
+// The value is worked out with the same operations as the plain functions so it matches them exactly
+struct FNoiseDeriv2D
+{
+	float V, X, Y;
+};
+struct FNoiseDeriv3D
+{
+	float V, X, Y, Z;
+};
 
+static FNoiseDeriv2D Lerp(const FNoiseDeriv2D& a, const FNoiseDeriv2D& b, const FNoiseDeriv2D& t)
+{
+	return { a.V + t.V * (b.V - a.V), a.X + t.X * (b.V - a.V) + t.V * (b.X - a.X), a.Y + t.Y * (b.V - a.V) + t.V * (b.Y - a.Y) };
 }
-
-float UFastNoise::GetNoise2D(float x, float y)
+static FNoiseDeriv3D Lerp(const FNoiseDeriv3D& a, const FNoiseDeriv3D& b, const FNoiseDeriv3D& t)
 {
-	switch (m_positionWarpType)
-	{
-	default:
-	case EPositionWarpType::None:
-		return GetNoise(x, y);
-	case EPositionWarpType::Fractal:
-		PositionWarpFractal(x, y);
-		return GetNoise(x, y);
-	case EPositionWarpType::Regular:
-		PositionWarp(x, y);
-		return GetNoise(x, y);
-	}
+	return { a.V + t.V * (b.V - a.V), a.X + t.X * (b.V - a.V) + t.V * (b.X - a.X), a.Y + t.Y * (b.V - a.V) + t.V * (b.Y - a.Y), a.Z + t.Z * (b.V - a.V) + t.V * (b.Z - a.Z) };
 }
 
-float UFastNoise::GetNoise3D(float x, float y, float z)
+// The interpolation weight for t and its derivative
+template<EInterp Interp>
+static void InterpWithDeriv(float t, float& outS, float& outDS)
+{
+	switch (Interp)
+	{
+	case EInterp::InterpLinear:
+		outS = t;
+		outDS = 1.0f;
+		break;
+	case EInterp::InterpHermite:
+		outS = InterpHermiteFunc(t);
+		outDS = 6.0f * t * (1.0f - t);
+		break;
+	case EInterp::InterpQuintic:
+		outS = InterpQuinticFunc(t);
+		outDS = 30.0f * t * t * (t * (t - 2.0f) + 1.0f);
+		break;
+	}
+}
+
+template<EInterp Interp>
+float FFastNoise::SingleGradientDeriv(unsigned char offset, float x, float y, float& outDX, float& outDY) const
+{
+	int x0 = FastFloor(x);
+	int y0 = FastFloor(y);
+	int x1 = x0 + 1;
+	int y1 = y0 + 1;
+
+	float xd0 = x - (float)x0;
+	float yd0 = y - (float)y0;
+	float xd1 = xd0 - 1.0f;
+	float yd1 = yd0 - 1.0f;
+
+	FNoiseDeriv2D xs = { 0.0f, 0.0f, 0.0f };
+	FNoiseDeriv2D ys = { 0.0f, 0.0f, 0.0f };
+	InterpWithDeriv<Interp>(xd0, xs.V, xs.X);
+	InterpWithDeriv<Interp>(yd0, ys.V, ys.Y);
+
+	// The gradient of a corner's contribution is its gradient vector
+	unsigned char lut00 = Index2D_12(offset, x0, y0);
+	unsigned char lut10 = Index2D_12(offset, x1, y0);
+	unsigned char lut01 = Index2D_12(offset, x0, y1);
+	unsigned char lut11 = Index2D_12(offset, x1, y1);
+	FNoiseDeriv2D g00 = { xd0*GRAD_X[lut00] + yd0*GRAD_Y[lut00], GRAD_X[lut00], GRAD_Y[lut00] };
+	FNoiseDeriv2D g10 = { xd1*GRAD_X[lut10] + yd0*GRAD_Y[lut10], GRAD_X[lut10], GRAD_Y[lut10] };
+	FNoiseDeriv2D g01 = { xd0*GRAD_X[lut01] + yd1*GRAD_Y[lut01], GRAD_X[lut01], GRAD_Y[lut01] };
+	FNoiseDeriv2D g11 = { xd1*GRAD_X[lut11] + yd1*GRAD_Y[lut11], GRAD_X[lut11], GRAD_Y[lut11] };
+
+	FNoiseDeriv2D result = Lerp(Lerp(g00, g10, xs), Lerp(g01, g11, xs), ys);
+	outDX = result.X;
+	outDY = result.Y;
+	return result.V;
+}
+
+template<EInterp Interp>
+float FFastNoise::SingleGradientDeriv(unsigned char offset, float x, float y, float z, float& outDX, float& outDY, float& outDZ) const
+{
+	int x0 = FastFloor(x);
+	int y0 = FastFloor(y);
+	int z0 = FastFloor(z);
+	int x1 = x0 + 1;
+	int y1 = y0 + 1;
+	int z1 = z0 + 1;
+
+	float xd0 = x - (float)x0;
+	float yd0 = y - (float)y0;
+	float zd0 = z - (float)z0;
+	float xd1 = xd0 - 1.0f;
+	float yd1 = yd0 - 1.0f;
+	float zd1 = zd0 - 1.0f;
+
+	FNoiseDeriv3D xs = { 0.0f, 0.0f, 0.0f, 0.0f };
+	FNoiseDeriv3D ys = { 0.0f, 0.0f, 0.0f, 0.0f };
+	FNoiseDeriv3D zs = { 0.0f, 0.0f, 0.0f, 0.0f };
+	InterpWithDeriv<Interp>(xd0, xs.V, xs.X);
+	InterpWithDeriv<Interp>(yd0, ys.V, ys.Y);
+	InterpWithDeriv<Interp>(zd0, zs.V, zs.Z);
+
+	auto corner = [this, offset](int xi, int yi, int zi, float xd, float yd, float zd)
+	{
+		unsigned char lutPos = Index3D_12(offset, xi, yi, zi);
+		FNoiseDeriv3D g = { xd*GRAD_X[lutPos] + yd*GRAD_Y[lutPos] + zd*GRAD_Z[lutPos], GRAD_X[lutPos], GRAD_Y[lutPos], GRAD_Z[lutPos] };
+		return g;
+	};
+
+	FNoiseDeriv3D xf00 = Lerp(corner(x0, y0, z0, xd0, yd0, zd0), corner(x1, y0, z0, xd1, yd0, zd0), xs);
+	FNoiseDeriv3D xf10 = Lerp(corner(x0, y1, z0, xd0, yd1, zd0), corner(x1, y1, z0, xd1, yd1, zd0), xs);
+	FNoiseDeriv3D xf01 = Lerp(corner(x0, y0, z1, xd0, yd0, zd1), corner(x1, y0, z1, xd1, yd0, zd1), xs);
+	FNoiseDeriv3D xf11 = Lerp(corner(x0, y1, z1, xd0, yd1, zd1), corner(x1, y1, z1, xd1, yd1, zd1), xs);
+
+	FNoiseDeriv3D result = Lerp(Lerp(xf00, xf10, ys), Lerp(xf01, xf11, ys), zs);
+	outDX = result.X;
+	outDY = result.Y;
+	outDZ = result.Z;
+	return result.V;
+}
+
+// Each simplex corner contributes t^4 * (g . d) with t = r - |d|^2, so its gradient is t^4 * g - 8 * t^3 * (g . d) * d
+float FFastNoise::SingleSimplexDeriv(unsigned char offset, float x, float y, float& outDX, float& outDY) const
+{
+	float t = (x + y) * F2;
+	int i = FastFloor(x + t);
+	int j = FastFloor(y + t);
+
+	t = (i + j) * G2;
+	float X0 = i - t;
+	float Y0 = j - t;
+
+	float xd[3], yd[3];
+	xd[0] = x - X0;
+	yd[0] = y - Y0;
+
+	int i1, j1;
+	if (xd[0] > yd[0])
+	{
+		i1 = 1; j1 = 0;
+	}
+	else
+	{
+		i1 = 0; j1 = 1;
+	}
+
+	xd[1] = xd[0] - (float)i1 + G2;
+	yd[1] = yd[0] - (float)j1 + G2;
+	xd[2] = xd[0] - 1.0f + 2.0f*G2;
+	yd[2] = yd[0] - 1.0f + 2.0f*G2;
+
+	const int ci[3] = { i, i + i1, i + 1 };
+	const int cj[3] = { j, j + j1, j + 1 };
+
+	float n = 0.0f;
+	float dx = 0.0f;
+	float dy = 0.0f;
+	for (int c = 0; c < 3; c++)
+	{
+		t = 0.5f - xd[c]*xd[c] - yd[c]*yd[c];
+		if (t < 0)
+		{
+			continue;
+		}
+
+		unsigned char lutPos = Index2D_12(offset, ci[c], cj[c]);
+		float gd = xd[c]*GRAD_X[lutPos] + yd[c]*GRAD_Y[lutPos];
+		float t2 = t * t;
+		float t4 = t2 * t2;
+		n += t4 * gd;
+
+		float falloff = -8.0f * t2 * t * gd;
+		dx += t4 * GRAD_X[lutPos] + falloff * xd[c];
+		dy += t4 * GRAD_Y[lutPos] + falloff * yd[c];
+	}
+
+	outDX = 50.0f * dx;
+	outDY = 50.0f * dy;
+	return 50.0f * n;
+}
+
+float FFastNoise::SingleSimplexDeriv(unsigned char offset, float x, float y, float z, float& outDX, float& outDY, float& outDZ) const
+{
+	float t = (x + y + z) * F3;
+	int i = FastFloor(x + t);
+	int j = FastFloor(y + t);
+	int k = FastFloor(z + t);
+
+	t = (i + j + k) * G3;
+	float X0 = i - t;
+	float Y0 = j - t;
+	float Z0 = k - t;
+
+	float x0 = x - X0;
+	float y0 = y - Y0;
+	float z0 = z - Z0;
+
+	int i1, j1, k1;
+	int i2, j2, k2;
+
+	if (x0 >= y0)
+	{
+		if (y0 >= z0)
+		{
+			i1 = 1; j1 = 0; k1 = 0; i2 = 1; j2 = 1; k2 = 0;
+		}
+		else if (x0 >= z0)
+		{
+			i1 = 1; j1 = 0; k1 = 0; i2 = 1; j2 = 0; k2 = 1;
+		}
+		else // x0 < z0
+		{
+			i1 = 0; j1 = 0; k1 = 1; i2 = 1; j2 = 0; k2 = 1;
+		}
+	}
+	else // x0 < y0
+	{
+		if (y0 < z0)
+		{
+			i1 = 0; j1 = 0; k1 = 1; i2 = 0; j2 = 1; k2 = 1;
+		}
+		else if (x0 < z0)
+		{
+			i1 = 0; j1 = 1; k1 = 0; i2 = 0; j2 = 1; k2 = 1;
+		}
+		else // x0 >= z0
+		{
+			i1 = 0; j1 = 1; k1 = 0; i2 = 1; j2 = 1; k2 = 0;
+		}
+	}
+
+	const float xd[4] = { x0, x0 - i1 + G3, x0 - i2 + 2.0f*G3, x0 - 1.0f + 3.0f*G3 };
+	const float yd[4] = { y0, y0 - j1 + G3, y0 - j2 + 2.0f*G3, y0 - 1.0f + 3.0f*G3 };
+	const float zd[4] = { z0, z0 - k1 + G3, z0 - k2 + 2.0f*G3, z0 - 1.0f + 3.0f*G3 };
+	const int ci[4] = { i, i + i1, i + i2, i + 1 };
+	const int cj[4] = { j, j + j1, j + j2, j + 1 };
+	const int ck[4] = { k, k + k1, k + k2, k + 1 };
+
+	float n = 0.0f;
+	float dx = 0.0f;
+	float dy = 0.0f;
+	float dz = 0.0f;
+	for (int c = 0; c < 4; c++)
+	{
+		t = 0.6f - xd[c]*xd[c] - yd[c]*yd[c] - zd[c]*zd[c];
+		if (t < 0.0f)
+		{
+			continue;
+		}
+
+		unsigned char lutPos = Index3D_12(offset, ci[c], cj[c], ck[c]);
+		float gd = xd[c]*GRAD_X[lutPos] + yd[c]*GRAD_Y[lutPos] + zd[c]*GRAD_Z[lutPos];
+		float t2 = t * t;
+		float t4 = t2 * t2;
+		n += t4 * gd;
+
+		float falloff = -8.0f * t2 * t * gd;
+		dx += t4 * GRAD_X[lutPos] + falloff * xd[c];
+		dy += t4 * GRAD_Y[lutPos] + falloff * yd[c];
+		dz += t4 * GRAD_Z[lutPos] + falloff * zd[c];
+	}
+
+	outDX = 32.0f * dx;
+	outDY = 32.0f * dy;
+	outDZ = 32.0f * dz;
+	return 32.0f * n;
+}
+
+float FFastNoise::SingleNoiseDeriv(unsigned char offset, float x, float y, float& outDX, float& outDY) const
+{
+	if (m_noiseType == ENoiseType::Simplex || m_noiseType == ENoiseType::SimplexFractal)
+	{
+		return SingleSimplexDeriv(offset, x, y, outDX, outDY);
+	}
+
+	switch (m_interp)
+	{
+	case EInterp::InterpLinear:
+		return SingleGradientDeriv<EInterp::InterpLinear>(offset, x, y, outDX, outDY);
+	case EInterp::InterpHermite:
+		return SingleGradientDeriv<EInterp::InterpHermite>(offset, x, y, outDX, outDY);
+	default:
+		return SingleGradientDeriv<EInterp::InterpQuintic>(offset, x, y, outDX, outDY);
+	}
+}
+
+float FFastNoise::SingleNoiseDeriv(unsigned char offset, float x, float y, float z, float& outDX, float& outDY, float& outDZ) const
+{
+	if (m_noiseType == ENoiseType::Simplex || m_noiseType == ENoiseType::SimplexFractal)
+	{
+		return SingleSimplexDeriv(offset, x, y, z, outDX, outDY, outDZ);
+	}
+
+	switch (m_interp)
+	{
+	case EInterp::InterpLinear:
+		return SingleGradientDeriv<EInterp::InterpLinear>(offset, x, y, z, outDX, outDY, outDZ);
+	case EInterp::InterpHermite:
+		return SingleGradientDeriv<EInterp::InterpHermite>(offset, x, y, z, outDX, outDY, outDZ);
+	default:
+		return SingleGradientDeriv<EInterp::InterpQuintic>(offset, x, y, z, outDX, outDY, outDZ);
+	}
+}
+
+// The fractal sums of SingleNoiseDeriv, following Single*FractalFBM/Billow/RigidMulti. Each octave's gradient is
+// scaled by its frequency as well as its amplitude
+float FFastNoise::SingleFractalDeriv(float x, float y, float& outDX, float& outDY) const
+{
+	float dx, dy;
+	float n = SingleNoiseDeriv(m_perm[0], x, y, dx, dy);
+	float sign = n < 0.0f ? -1.0f : 1.0f;
+
+	float sum;
+	switch (m_fractalType)
+	{
+	case EFractalType::Billow:
+		sum = FastAbs(n) * 2.0f - 1.0f;
+		outDX = sign * 2.0f * dx;
+		outDY = sign * 2.0f * dy;
+		break;
+	case EFractalType::RigidMulti:
+		sum = 1.0f - FastAbs(n);
+		outDX = -sign * dx;
+		outDY = -sign * dy;
+		break;
+	default:
+		sum = n;
+		outDX = dx;
+		outDY = dy;
+		break;
+	}
+
+	float amp = 1.0f;
+	float scale = 1.0f;
+	unsigned int i = 0;
+
+	while (++i < m_octaves)
+	{
+		x *= m_lacunarity;
+		y *= m_lacunarity;
+
+		amp *= m_gain;
+		scale *= m_lacunarity;
+		n = SingleNoiseDeriv(m_perm[i], x, y, dx, dy);
+		sign = n < 0.0f ? -1.0f : 1.0f;
+
+		switch (m_fractalType)
+		{
+		case EFractalType::Billow:
+			sum += (FastAbs(n) * 2.0f - 1.0f) * amp;
+			outDX += sign * 2.0f * dx * amp * scale;
+			outDY += sign * 2.0f * dy * amp * scale;
+			break;
+		case EFractalType::RigidMulti:
+			sum -= (1.0f - FastAbs(n)) * amp;
+			outDX += sign * dx * amp * scale;
+			outDY += sign * dy * amp * scale;
+			break;
+		default:
+			sum += n * amp;
+			outDX += dx * amp * scale;
+			outDY += dy * amp * scale;
+			break;
+		}
+	}
+
+	if (m_fractalType == EFractalType::RigidMulti)
+	{
+		return sum;
+	}
+
+	outDX *= m_fractalBounding;
+	outDY *= m_fractalBounding;
+	return sum * m_fractalBounding;
+}
+
+float FFastNoise::SingleFractalDeriv(float x, float y, float z, float& outDX, float& outDY, float& outDZ) const
+{
+	float dx, dy, dz;
+	float n = SingleNoiseDeriv(m_perm[0], x, y, z, dx, dy, dz);
+	float sign = n < 0.0f ? -1.0f : 1.0f;
+
+	float sum;
+	switch (m_fractalType)
+	{
+	case EFractalType::Billow:
+		sum = FastAbs(n) * 2.0f - 1.0f;
+		outDX = sign * 2.0f * dx;
+		outDY = sign * 2.0f * dy;
+		outDZ = sign * 2.0f * dz;
+		break;
+	case EFractalType::RigidMulti:
+		sum = 1.0f - FastAbs(n);
+		outDX = -sign * dx;
+		outDY = -sign * dy;
+		outDZ = -sign * dz;
+		break;
+	default:
+		sum = n;
+		outDX = dx;
+		outDY = dy;
+		outDZ = dz;
+		break;
+	}
+
+	float amp = 1.0f;
+	float scale = 1.0f;
+	unsigned int i = 0;
+
+	while (++i < m_octaves)
+	{
+		x *= m_lacunarity;
+		y *= m_lacunarity;
+		z *= m_lacunarity;
+
+		amp *= m_gain;
+		scale *= m_lacunarity;
+		n = SingleNoiseDeriv(m_perm[i], x, y, z, dx, dy, dz);
+		sign = n < 0.0f ? -1.0f : 1.0f;
+
+		switch (m_fractalType)
+		{
+		case EFractalType::Billow:
+			sum += (FastAbs(n) * 2.0f - 1.0f) * amp;
+			outDX += sign * 2.0f * dx * amp * scale;
+			outDY += sign * 2.0f * dy * amp * scale;
+			outDZ += sign * 2.0f * dz * amp * scale;
+			break;
+		case EFractalType::RigidMulti:
+			sum -= (1.0f - FastAbs(n)) * amp;
+			outDX += sign * dx * amp * scale;
+			outDY += sign * dy * amp * scale;
+			outDZ += sign * dz * amp * scale;
+			break;
+		default:
+			sum += n * amp;
+			outDX += dx * amp * scale;
+			outDY += dy * amp * scale;
+			outDZ += dz * amp * scale;
+			break;
+		}
+	}
+
+	if (m_fractalType == EFractalType::RigidMulti)
+	{
+		return sum;
+	}
+
+	outDX *= m_fractalBounding;
+	outDY *= m_fractalBounding;
+	outDZ *= m_fractalBounding;
+	return sum * m_fractalBounding;
+}
+
+// Step for the central difference fallback, in noise space so it scales with the frequency
+static const float DERIV_STEP = 1.0f / 1024.0f;
+
+bool FFastNoise::SupportsAnalyticGradient() const
+{
+	switch (m_noiseType)
+	{
+	case ENoiseType::Gradient:
+	case ENoiseType::GradientFractal:
+	case ENoiseType::Simplex:
+	case ENoiseType::SimplexFractal:
+		return m_positionWarpType == EPositionWarpType::None;
+	default:
+		return false;
+	}
+}
+
+FFloatInterval FFastNoise::GetNoiseBounds() const
+{
+	// Largest magnitude of a single octave. Value and white noise blend or return values in [-1, 1]. Gradient noise is
+	// bounded by sqrt(N / 4) times its longest gradient, sqrt(2) in both 2D and 3D. Simplex adds up (R - r^2)^4 times
+	// the gradient's dot product with the offset r, at most sqrt(2) r, for each corner in reach. (R - r^2)^4 r peaks at
+	// r^2 = R / 9, so every corner at its peak bounds it by 50 * 3 * sqrt(2) * 0.0092 = 1.951 in 2D and
+	// 32 * 4 * sqrt(2) * 0.02089 = 3.782 in 3D. Values seen stay within 1, so Simplex prunes less, but on a limit that
+	// always holds
+	float octave;
+	switch (m_noiseType)
+	{
+	case ENoiseType::Gradient:
+	case ENoiseType::GradientFractal:
+		octave = 1.2248f;
+		break;
+	case ENoiseType::Simplex:
+	case ENoiseType::SimplexFractal:
+		octave = 3.7816f;
+		break;
+	case ENoiseType::Cellular:
+		if (m_cellularReturnType == ECellularReturnType::CellValue)
+		{
+			octave = 1.0f;
+		}
+		else if (m_cellularReturnType == ECellularReturnType::NoiseLookup && m_cellularNoiseLookup)
+		{
+			return m_cellularNoiseLookup->GetNoiseBounds();
+		}
+		else
+		{
+			return FFloatInterval(TNumericLimits<float>::Lowest(), TNumericLimits<float>::Max());
+		}
+		break;
+	default:
+		octave = 1.0f;
+		break;
+	}
+
+	if (FFastNoiseSingleBinder::IsFractal(m_noiseType))
+	{
+		// Every octave after the first is weighted by the gain, fading the last one out only lowers that
+		float amps = 0.0f;
+		float amp = 1.0f;
+		for (unsigned int i = 1; i < m_octaves; i++)
+		{
+			amp *= m_gain;
+			amps += FMath::Abs(amp);
+		}
+
+		switch (m_fractalType)
+		{
+		case EFractalType::FBM:
+			octave *= (1.0f + amps) * FMath::Abs(m_fractalBounding);
+			break;
+		case EFractalType::Billow:
+			octave = FMath::Max(1.0f, octave * 2.0f - 1.0f) * (1.0f + amps) * FMath::Abs(m_fractalBounding);
+			break;
+		case EFractalType::RigidMulti:
+			// 1 - |n| for the first octave, less the gain weighted 1 - |n| of the rest, and it isn't normalised
+			{
+				const float term = FMath::Max(1.0f, octave - 1.0f);
+				return FFloatInterval(1.0f - octave - amps * term - 1e-4f, 1.0f + amps * term + 1e-4f);
+			}
+		}
+	}
+
+	// Headroom for rounding, the batch kernels can differ from the single point functions by 1e-5
+	octave += 1e-4f;
+	return FFloatInterval(-octave, octave);
+}
+
+float FFastNoise::GetNoise2DWithGradient(float x, float y, FVector2D& outGradient) const
+{
+	if (SupportsAnalyticGradient())
+	{
+		float dx, dy;
+		float value = FFastNoiseSingleBinder::IsFractal(m_noiseType)
+			? SingleFractalDeriv(x * m_frequency, y * m_frequency, dx, dy)
+			: SingleNoiseDeriv(0, x * m_frequency, y * m_frequency, dx, dy);
+
+		// The noise is evaluated at x * m_frequency, so that scales the gradient too
+		outGradient = FVector2D(dx * m_frequency, dy * m_frequency);
+		return value;
+	}
+
+	const float h = DERIV_STEP / m_frequency;
+	outGradient = FVector2D(GetNoise2D(x + h, y) - GetNoise2D(x - h, y), GetNoise2D(x, y + h) - GetNoise2D(x, y - h)) * (0.5f / h);
+	return GetNoise2D(x, y);
+}
+
+float FFastNoise::GetNoise3DWithGradient(float x, float y, float z, FVector& outGradient) const
+{
+	if (SupportsAnalyticGradient())
+	{
+		float dx, dy, dz;
+		float value = FFastNoiseSingleBinder::IsFractal(m_noiseType)
+			? SingleFractalDeriv(x * m_frequency, y * m_frequency, z * m_frequency, dx, dy, dz)
+			: SingleNoiseDeriv(0, x * m_frequency, y * m_frequency, z * m_frequency, dx, dy, dz);
+
+		outGradient = FVector(dx * m_frequency, dy * m_frequency, dz * m_frequency);
+		return value;
+	}
+
+	const float h = DERIV_STEP / m_frequency;
+	outGradient = FVector(GetNoise3D(x + h, y, z) - GetNoise3D(x - h, y, z), GetNoise3D(x, y + h, z) - GetNoise3D(x, y - h, z), GetNoise3D(x, y, z + h) - GetNoise3D(x, y, z - h)) * (0.5f / h);
+	return GetNoise3D(x, y, z);
+}
+
+FVector FFastNoise::GetNoise2DDeriv(float x, float y) const
+{
+	FVector2D gradient;
+	float value = GetNoise2DWithGradient(x, y, gradient);
+	return FVector(value, gradient.X, gradient.Y);
+}
+
+float FFastNoise::GetNoise2D(float x, float y) const
+{
+	switch (m_positionWarpType)
+	{
+	default:
+	case EPositionWarpType::None:
+		return GetNoise(x, y);
+	case EPositionWarpType::Fractal:
+		PositionWarpFractal(x, y);
+		return GetNoise(x, y);
+	case EPositionWarpType::Regular:
+		PositionWarp(x, y);
+		return GetNoise(x, y);
+	}
+}
+
+float FFastNoise::GetNoise3D(float x, float y, float z) const
 {
 	switch (m_positionWarpType)
 	{
@@ -2013,4 +2691,342 @@ float UFastNoise::GetNoise3D(float x, float y, float z)
 		PositionWarp(x, y, z);
 		return GetNoise(x, y, z);
 	}
-}
\ No newline at end of file
+}
+
+void FFastNoise::GetOctaveCutoff(float footprint, unsigned int& outOctaves, float& outLastOctaveWeight) const
+{
+	outOctaves = m_octaves;
+	outLastOctaveWeight = 1.0f;
+
+	if (footprint <= 0.0f || m_lacunarity <= 1.0f || m_octaves <= 1)
+	{
+		return;
+	}
+
+	// Octave i has a frequency of m_frequency * m_lacunarity^i, it's kept while that's under half the sample rate.
+	// The count is fractional so the highest octave can fade out as the footprint grows instead of popping
+	const float maxFrequency = 0.5f / footprint;
+	const float octaves = FMath::Clamp(FMath::Loge(maxFrequency / m_frequency) / FMath::Loge(m_lacunarity) + 1.0f, 1.0f, (float)m_octaves);
+	const unsigned int wholeOctaves = (unsigned int)octaves;
+	const float fraction = octaves - wholeOctaves;
+
+	if (fraction > 0.0f && wholeOctaves < m_octaves)
+	{
+		outOctaves = wholeOctaves + 1;
+		outLastOctaveWeight = fraction;
+	}
+	else
+	{
+		outOctaves = wholeOctaves;
+	}
+}
+
+float FFastNoise::GetNoise2DAdaptive(float x, float y, float footprint) const
+{
+	unsigned int octaves;
+	float lastOctaveWeight;
+	GetOctaveCutoff(footprint, octaves, lastOctaveWeight);
+
+	switch (m_positionWarpType)
+	{
+	default:
+	case EPositionWarpType::None:
+		return GetNoiseOctaves(x, y, octaves, lastOctaveWeight);
+	case EPositionWarpType::Fractal:
+		PositionWarpFractal(x, y);
+		return GetNoiseOctaves(x, y, octaves, lastOctaveWeight);
+	case EPositionWarpType::Regular:
+		PositionWarp(x, y);
+		return GetNoiseOctaves(x, y, octaves, lastOctaveWeight);
+	}
+}
+
+float FFastNoise::GetNoise3DAdaptive(float x, float y, float z, float footprint) const
+{
+	unsigned int octaves;
+	float lastOctaveWeight;
+	GetOctaveCutoff(footprint, octaves, lastOctaveWeight);
+
+	switch (m_positionWarpType)
+	{
+	default:
+	case EPositionWarpType::None:
+		return GetNoiseOctaves(x, y, z, octaves, lastOctaveWeight);
+	case EPositionWarpType::Fractal:
+		PositionWarpFractal(x, y, z);
+		return GetNoiseOctaves(x, y, z, octaves, lastOctaveWeight);
+	case EPositionWarpType::Regular:
+		PositionWarp(x, y, z);
+		return GetNoiseOctaves(x, y, z, octaves, lastOctaveWeight);
+	}
+}
+
+FFastNoiseBatchParams FFastNoise::MakeBatchParams(float footprint) const
+{
+	FFastNoiseBatchParams params;
+	params.Perm = m_permutation->PermBatch;
+	params.Perm12 = m_permutation->Perm12Batch;
+	params.ValueLUT = VAL_LUT;
+	params.Cell2DX = CELL_2D_X;
+	params.Cell2DY = CELL_2D_Y;
+	params.Cell3DX = CELL_3D_X;
+	params.Cell3DY = CELL_3D_Y;
+	params.Cell3DZ = CELL_3D_Z;
+	params.NoiseType = m_noiseType;
+	params.Interp = m_interp;
+	params.FractalType = m_fractalType;
+	params.LatticeHash = m_latticeHash;
+	params.Seed = m_seed;
+	params.CellularDistanceFunction = m_cellularDistanceFunction;
+	params.CellularReturnType = m_cellularReturnType;
+	params.Frequency = m_frequency;
+	unsigned int octaves;
+	GetOctaveCutoff(footprint, octaves, params.LastOctaveWeight);
+	params.Octaves = octaves;
+	params.Lacunarity = m_lacunarity;
+	params.Gain = m_gain;
+	params.FractalBounding = m_fractalBounding;
+	params.PositionWarpType = m_positionWarpType;
+	params.PositionWarpAmp = m_positionWarpAmp;
+	params.WarpOctaves = m_octaves;
+	return params;
+}
+
+void FFastNoise::BindKernels()
+{
+	FastNoiseBatch::BindKernels(MakeBatchParams(0.0f), m_kernels);
+	FFastNoiseSingleBinder::Bind(m_noiseType, m_fractalType, m_interp, m_singleNoise2D, m_singleNoise3D);
+}
+
+// Warped points go through the warp and noise kernels this many at a time. The warped coordinates are written to
+// buffers small enough to still be in L1 when the noise kernel reads them back, so warping costs the warp kernel
+// and nothing more
+static const int32 WARP_CHUNK = 256;
+
+void FFastNoise::GetWarpedNoise2DBatch(const FFastNoiseBatchParams& params, float* x, float* y, float* out, int32 n) const
+{
+	m_kernels.PositionWarp2D(params, x, y, n);
+	m_kernels.GetNoise2D(params, x, y, out, n);
+}
+
+void FFastNoise::GetWarpedNoise3DBatch(const FFastNoiseBatchParams& params, float* x, float* y, float* z, float* out, int32 n) const
+{
+	m_kernels.PositionWarp3D(params, x, y, z, n);
+	m_kernels.GetNoise3D(params, x, y, z, out, n);
+}
+
+void FFastNoise::GetNoise2DBatch(const float* x, const float* y, float* out, int32 n, float footprint) const
+{
+	if (!m_kernels.IsBound())
+	{
+		for (int32 i = 0; i < n; i++)
+		{
+			out[i] = GetNoise2DAdaptive(x[i], y[i], footprint);
+		}
+		return;
+	}
+
+	const FFastNoiseBatchParams params = MakeBatchParams(footprint);
+	if (m_positionWarpType == EPositionWarpType::None)
+	{
+		m_kernels.GetNoise2D(params, x, y, out, n);
+		return;
+	}
+
+	float warpedX[WARP_CHUNK];
+	float warpedY[WARP_CHUNK];
+	for (int32 start = 0; start < n; start += WARP_CHUNK)
+	{
+		const int32 count = FMath::Min(WARP_CHUNK, n - start);
+		for (int32 i = 0; i < count; i++)
+		{
+			warpedX[i] = x[start + i];
+			warpedY[i] = y[start + i];
+		}
+		GetWarpedNoise2DBatch(params, warpedX, warpedY, out + start, count);
+	}
+}
+
+void FFastNoise::GetNoise3DBatch(const float* x, const float* y, const float* z, float* out, int32 n, float footprint) const
+{
+	if (!m_kernels.IsBound())
+	{
+		for (int32 i = 0; i < n; i++)
+		{
+			out[i] = GetNoise3DAdaptive(x[i], y[i], z[i], footprint);
+		}
+		return;
+	}
+
+	const FFastNoiseBatchParams params = MakeBatchParams(footprint);
+	if (m_positionWarpType == EPositionWarpType::None)
+	{
+		m_kernels.GetNoise3D(params, x, y, z, out, n);
+		return;
+	}
+
+	float warpedX[WARP_CHUNK];
+	float warpedY[WARP_CHUNK];
+	float warpedZ[WARP_CHUNK];
+	for (int32 start = 0; start < n; start += WARP_CHUNK)
+	{
+		const int32 count = FMath::Min(WARP_CHUNK, n - start);
+		for (int32 i = 0; i < count; i++)
+		{
+			warpedX[i] = x[start + i];
+			warpedY[i] = y[start + i];
+			warpedZ[i] = z[start + i];
+		}
+		GetWarpedNoise3DBatch(params, warpedX, warpedY, warpedZ, out + start, count);
+	}
+}
+
+void FFastNoise::FillNoiseGrid2D(const FVector2D& origin, const FVector2D& step, const FIntPoint& extent, float* outValues, float footprint, int32 seedOffset) const
+{
+	if (seedOffset != 0)
+	{
+		WithSeedOffset(seedOffset).FillNoiseGrid2D(origin, step, extent, outValues, footprint);
+		return;
+	}
+
+	if (!m_kernels.IsBound())
+	{
+		for (int32 y = 0; y < extent.Y; y++)
+		{
+			for (int32 x = 0; x < extent.X; x++)
+			{
+				*outValues++ = GetNoise2DAdaptive(origin.X + x * step.X, origin.Y + y * step.Y, footprint);
+			}
+		}
+		return;
+	}
+
+	const FFastNoiseBatchParams params = MakeBatchParams(footprint);
+	if (m_positionWarpType == EPositionWarpType::None)
+	{
+		m_kernels.FillGrid2D(params, origin.X, origin.Y, step.X, step.Y, extent.X, extent.Y, outValues);
+		return;
+	}
+
+	// Warped points are off the grid, so nothing is shared along a row and they take the point path
+	float warpedX[WARP_CHUNK];
+	float warpedY[WARP_CHUNK];
+	for (int32 y = 0; y < extent.Y; y++)
+	{
+		for (int32 start = 0; start < extent.X; start += WARP_CHUNK)
+		{
+			const int32 count = FMath::Min(WARP_CHUNK, extent.X - start);
+			for (int32 i = 0; i < count; i++)
+			{
+				warpedX[i] = origin.X + (start + i) * step.X;
+				warpedY[i] = origin.Y + y * step.Y;
+			}
+			GetWarpedNoise2DBatch(params, warpedX, warpedY, outValues, count);
+			outValues += count;
+		}
+	}
+}
+
+void FFastNoise::FillNoiseGrid3D(const FVector& origin, const FVector& step, const FIntVector& extent, float* outValues, float footprint, int32 seedOffset) const
+{
+	if (seedOffset != 0)
+	{
+		WithSeedOffset(seedOffset).FillNoiseGrid3D(origin, step, extent, outValues, footprint);
+		return;
+	}
+
+	if (!m_kernels.IsBound())
+	{
+		for (int32 z = 0; z < extent.Z; z++)
+		{
+			for (int32 y = 0; y < extent.Y; y++)
+			{
+				for (int32 x = 0; x < extent.X; x++)
+				{
+					*outValues++ = GetNoise3DAdaptive(origin.X + x * step.X, origin.Y + y * step.Y, origin.Z + z * step.Z, footprint);
+				}
+			}
+		}
+		return;
+	}
+
+	const FFastNoiseBatchParams params = MakeBatchParams(footprint);
+	if (m_positionWarpType == EPositionWarpType::None)
+	{
+		m_kernels.FillGrid3D(params, origin.X, origin.Y, origin.Z, step.X, step.Y, step.Z, extent.X, extent.Y, extent.Z, outValues);
+		return;
+	}
+
+	float warpedX[WARP_CHUNK];
+	float warpedY[WARP_CHUNK];
+	float warpedZ[WARP_CHUNK];
+	for (int32 z = 0; z < extent.Z; z++)
+	{
+		for (int32 y = 0; y < extent.Y; y++)
+		{
+			for (int32 start = 0; start < extent.X; start += WARP_CHUNK)
+			{
+				const int32 count = FMath::Min(WARP_CHUNK, extent.X - start);
+				for (int32 i = 0; i < count; i++)
+				{
+					warpedX[i] = origin.X + (start + i) * step.X;
+					warpedY[i] = origin.Y + y * step.Y;
+					warpedZ[i] = origin.Z + z * step.Z;
+				}
+				GetWarpedNoise3DBatch(params, warpedX, warpedY, warpedZ, outValues, count);
+				outValues += count;
+			}
+		}
+	}
+}
+
+void FFastNoise::PositionWarpBatch(float* x, float* y, int32 n) const
+{
+	PositionWarpBatch(EPositionWarpType::Regular, x, y, n);
+}
+
+void FFastNoise::PositionWarpFractalBatch(float* x, float* y, int32 n) const
+{
+	PositionWarpBatch(EPositionWarpType::Fractal, x, y, n);
+}
+
+void FFastNoise::PositionWarpBatch(float* x, float* y, float* z, int32 n) const
+{
+	PositionWarpBatch(EPositionWarpType::Regular, x, y, z, n);
+}
+
+void FFastNoise::PositionWarpFractalBatch(float* x, float* y, float* z, int32 n) const
+{
+	PositionWarpBatch(EPositionWarpType::Fractal, x, y, z, n);
+}
+
+void FFastNoise::PositionWarpBatch(EPositionWarpType positionWarpType, float* x, float* y, int32 n) const
+{
+	FFastNoiseBatchParams params = MakeBatchParams(0.0f);
+	params.PositionWarpType = positionWarpType;
+	m_kernels.PositionWarp2D(params, x, y, n);
+}
+
+void FFastNoise::PositionWarpBatch(EPositionWarpType positionWarpType, float* x, float* y, float* z, int32 n) const
+{
+	FFastNoiseBatchParams params = MakeBatchParams(0.0f);
+	params.PositionWarpType = positionWarpType;
+	m_kernels.PositionWarp3D(params, x, y, z, n);
+}
+
+FFastNoise FFastNoise::WithSeedOffset(int32 seedOffset) const
+{
+	// Only the seed dependent state changes, the bound kernels and everything else carry over from the copy
+	FFastNoise noise(*this);
+	noise.SetSeed(m_seed + seedOffset);
+	return noise;
+}
+
+UFastNoise::UFastNoise(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+}
+
+int32 UFastNoise::CompileNoise(FUFNNoiseCompiler& compiler, const FUFNNoiseCoordinates& coords)
+{
+	return compiler.FastNoise(Noise, coords);
+}
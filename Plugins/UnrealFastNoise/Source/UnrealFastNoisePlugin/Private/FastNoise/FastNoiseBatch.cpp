@@ -0,0 +1,340 @@
+// FastNoiseBatch.cpp
+//
+// Instantiates FastNoiseBatchKernels.inl for scalar, SSE4.1 and AVX2 and binds the best one at runtime.
+// The SIMD versions are compiled with per function target attributes, so the module doesn't need to be built
+// for AVX2 to use it and CPUs without it still get the scalar or SSE4.1 kernels.
+//
+
+#include "FastNoiseBatch.h"
+#include "FastNoise.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define FASTNOISE_BATCH_X86 1
+#else
+#define FASTNOISE_BATCH_X86 0
+#endif
+
+#if FASTNOISE_BATCH_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define FASTNOISE_TARGET_SSE41
+#define FASTNOISE_TARGET_AVX2
+#else
+#include <cpuid.h>
+#define FASTNOISE_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define FASTNOISE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// Scalar, also the fallback on CPUs without SSE4.1 and on other architectures
+namespace FastNoiseBatchScalar
+{
+#define FN_INLINE static FORCEINLINE
+#define FN_FUNC static
+
+	typedef float FVec;
+	typedef int32 IVec;
+	typedef bool FMask;
+	static const int32 Lanes = 1;
+
+	FN_INLINE FVec VLoad(const float* p) { return *p; }
+	FN_INLINE void VStore(float* p, FVec v) { *p = v; }
+	FN_INLINE FVec VSet(float f) { return f; }
+	FN_INLINE IVec ISet(int32 i) { return i; }
+	FN_INLINE IVec ILaneIndex() { return 0; }
+
+	FN_INLINE FVec VAdd(FVec a, FVec b) { return a + b; }
+	FN_INLINE FVec VSub(FVec a, FVec b) { return a - b; }
+	FN_INLINE FVec VMul(FVec a, FVec b) { return a * b; }
+	FN_INLINE FVec VDiv(FVec a, FVec b) { return a / b; }
+	FN_INLINE FVec VMin(FVec a, FVec b) { return a < b ? a : b; }
+	FN_INLINE FVec VMax(FVec a, FVec b) { return a > b ? a : b; }
+	FN_INLINE FVec VAbs(FVec a) { return fabsf(a); }
+	FN_INLINE FVec VSelect(FMask m, FVec a, FVec b) { return m ? a : b; }
+	FN_INLINE FVec VNegateIf(FVec a, FMask m) { return m ? -a : a; }
+
+	FN_INLINE FMask VGreater(FVec a, FVec b) { return a > b; }
+	FN_INLINE FMask VGreaterEq(FVec a, FVec b) { return a >= b; }
+	FN_INLINE FMask MAnd(FMask a, FMask b) { return a && b; }
+	FN_INLINE FMask MOr(FMask a, FMask b) { return a || b; }
+	FN_INLINE FMask MNot(FMask a) { return !a; }
+	FN_INLINE IVec MaskToOne(FMask m) { return m ? 1 : 0; }
+	FN_INLINE bool MAll(FMask m) { return m; }
+
+	FN_INLINE IVec IAdd(IVec a, IVec b) { return a + b; }
+	FN_INLINE IVec IAnd(IVec a, IVec b) { return a & b; }
+	FN_INLINE IVec IXor(IVec a, IVec b) { return a ^ b; }
+	FN_INLINE IVec IMul(IVec a, IVec b) { return (int32)((uint32)a * (uint32)b); }
+	FN_INLINE IVec IShiftRight(IVec a, int32 bits) { return (int32)((uint32)a >> bits); }
+	FN_INLINE IVec ISelect(FMask m, IVec a, IVec b) { return m ? a : b; }
+	FN_INLINE FMask ILessMask(IVec a, IVec b) { return a < b; }
+	FN_INLINE FMask IBitMask(IVec a, int32 bit) { return (a & bit) != 0; }
+
+	FN_INLINE FVec IToF(IVec i) { return (float)i; }
+	FN_INLINE IVec VFastFloor(FVec f) { return f >= 0.0f ? (int32)f : (int32)f - 1; }
+	FN_INLINE IVec VFastRound(FVec f) { return f >= 0.0f ? (int32)(f + 0.5f) : (int32)(f - 0.5f); }
+
+	FN_INLINE IVec IGather(const int32* table, IVec i) { return table[i]; }
+	FN_INLINE FVec VGather(const float* table, IVec i) { return table[i]; }
+
+#include "FastNoiseBatchKernels.inl"
+
+#undef FN_INLINE
+#undef FN_FUNC
+}
+
+#if FASTNOISE_BATCH_X86
+
+// SSE4.1, 4 lanes
+namespace FastNoiseBatchSSE41
+{
+#define FN_INLINE static FORCEINLINE FASTNOISE_TARGET_SSE41
+#define FN_FUNC static FASTNOISE_TARGET_SSE41
+
+	typedef __m128 FVec;
+	typedef __m128i IVec;
+	typedef __m128 FMask;
+	static const int32 Lanes = 4;
+
+	FN_INLINE FVec VLoad(const float* p) { return _mm_loadu_ps(p); }
+	FN_INLINE void VStore(float* p, FVec v) { _mm_storeu_ps(p, v); }
+	FN_INLINE FVec VSet(float f) { return _mm_set1_ps(f); }
+	FN_INLINE IVec ISet(int32 i) { return _mm_set1_epi32(i); }
+	FN_INLINE IVec ILaneIndex() { return _mm_setr_epi32(0, 1, 2, 3); }
+
+	FN_INLINE FVec VAdd(FVec a, FVec b) { return _mm_add_ps(a, b); }
+	FN_INLINE FVec VSub(FVec a, FVec b) { return _mm_sub_ps(a, b); }
+	FN_INLINE FVec VMul(FVec a, FVec b) { return _mm_mul_ps(a, b); }
+	FN_INLINE FVec VDiv(FVec a, FVec b) { return _mm_div_ps(a, b); }
+	FN_INLINE FVec VMin(FVec a, FVec b) { return _mm_min_ps(a, b); }
+	FN_INLINE FVec VMax(FVec a, FVec b) { return _mm_max_ps(a, b); }
+	FN_INLINE FVec VAbs(FVec a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+	FN_INLINE FVec VSelect(FMask m, FVec a, FVec b) { return _mm_blendv_ps(b, a, m); }
+	FN_INLINE FVec VNegateIf(FVec a, FMask m) { return _mm_xor_ps(a, _mm_and_ps(m, _mm_set1_ps(-0.0f))); }
+
+	FN_INLINE FMask VGreater(FVec a, FVec b) { return _mm_cmpgt_ps(a, b); }
+	FN_INLINE FMask VGreaterEq(FVec a, FVec b) { return _mm_cmpge_ps(a, b); }
+	FN_INLINE FMask MAnd(FMask a, FMask b) { return _mm_and_ps(a, b); }
+	FN_INLINE FMask MOr(FMask a, FMask b) { return _mm_or_ps(a, b); }
+	FN_INLINE FMask MNot(FMask a) { return _mm_xor_ps(a, _mm_castsi128_ps(_mm_set1_epi32(-1))); }
+	FN_INLINE IVec MaskToOne(FMask m) { return _mm_and_si128(_mm_castps_si128(m), _mm_set1_epi32(1)); }
+	FN_INLINE bool MAll(FMask m) { return _mm_movemask_ps(m) == 0xf; }
+
+	FN_INLINE IVec IAdd(IVec a, IVec b) { return _mm_add_epi32(a, b); }
+	FN_INLINE IVec IAnd(IVec a, IVec b) { return _mm_and_si128(a, b); }
+	FN_INLINE IVec IXor(IVec a, IVec b) { return _mm_xor_si128(a, b); }
+	FN_INLINE IVec IMul(IVec a, IVec b) { return _mm_mullo_epi32(a, b); }
+	FN_INLINE IVec IShiftRight(IVec a, int32 bits) { return _mm_srli_epi32(a, bits); }
+	FN_INLINE IVec ISelect(FMask m, IVec a, IVec b) { return _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(b), _mm_castsi128_ps(a), m)); }
+	FN_INLINE FMask ILessMask(IVec a, IVec b) { return _mm_castsi128_ps(_mm_cmplt_epi32(a, b)); }
+	FN_INLINE FMask IBitMask(IVec a, int32 bit) { return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(a, _mm_set1_epi32(bit)), _mm_set1_epi32(bit))); }
+
+	FN_INLINE FVec IToF(IVec i) { return _mm_cvtepi32_ps(i); }
+
+	// Truncate, then step down for negative values to match FastFloor, including its result for negative integers
+	FN_INLINE IVec VFastFloor(FVec f) { return _mm_add_epi32(_mm_cvttps_epi32(f), _mm_castps_si128(_mm_cmplt_ps(f, _mm_setzero_ps()))); }
+
+	// Add 0.5 with the sign of f and truncate, like FastRound. -0 gets -0.5, which truncates to 0 all the same
+	FN_INLINE IVec VFastRound(FVec f) { return _mm_cvttps_epi32(_mm_add_ps(f, _mm_or_ps(_mm_and_ps(f, _mm_set1_ps(-0.0f)), _mm_set1_ps(0.5f)))); }
+
+	FN_INLINE IVec IGather(const int32* table, IVec i)
+	{
+		return _mm_setr_epi32(table[_mm_cvtsi128_si32(i)], table[_mm_extract_epi32(i, 1)], table[_mm_extract_epi32(i, 2)], table[_mm_extract_epi32(i, 3)]);
+	}
+	FN_INLINE FVec VGather(const float* table, IVec i)
+	{
+		return _mm_setr_ps(table[_mm_cvtsi128_si32(i)], table[_mm_extract_epi32(i, 1)], table[_mm_extract_epi32(i, 2)], table[_mm_extract_epi32(i, 3)]);
+	}
+
+#include "FastNoiseBatchKernels.inl"
+
+#undef FN_INLINE
+#undef FN_FUNC
+}
+
+// AVX2, 8 lanes with hardware gathers
+namespace FastNoiseBatchAVX2
+{
+#define FN_INLINE static FORCEINLINE FASTNOISE_TARGET_AVX2
+#define FN_FUNC static FASTNOISE_TARGET_AVX2
+
+	typedef __m256 FVec;
+	typedef __m256i IVec;
+	typedef __m256 FMask;
+	static const int32 Lanes = 8;
+
+	FN_INLINE FVec VLoad(const float* p) { return _mm256_loadu_ps(p); }
+	FN_INLINE void VStore(float* p, FVec v) { _mm256_storeu_ps(p, v); }
+	FN_INLINE FVec VSet(float f) { return _mm256_set1_ps(f); }
+	FN_INLINE IVec ISet(int32 i) { return _mm256_set1_epi32(i); }
+	FN_INLINE IVec ILaneIndex() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+
+	FN_INLINE FVec VAdd(FVec a, FVec b) { return _mm256_add_ps(a, b); }
+	FN_INLINE FVec VSub(FVec a, FVec b) { return _mm256_sub_ps(a, b); }
+	FN_INLINE FVec VMul(FVec a, FVec b) { return _mm256_mul_ps(a, b); }
+	FN_INLINE FVec VDiv(FVec a, FVec b) { return _mm256_div_ps(a, b); }
+	FN_INLINE FVec VMin(FVec a, FVec b) { return _mm256_min_ps(a, b); }
+	FN_INLINE FVec VMax(FVec a, FVec b) { return _mm256_max_ps(a, b); }
+	FN_INLINE FVec VAbs(FVec a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+	FN_INLINE FVec VSelect(FMask m, FVec a, FVec b) { return _mm256_blendv_ps(b, a, m); }
+	FN_INLINE FVec VNegateIf(FVec a, FMask m) { return _mm256_xor_ps(a, _mm256_and_ps(m, _mm256_set1_ps(-0.0f))); }
+
+	FN_INLINE FMask VGreater(FVec a, FVec b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	FN_INLINE FMask VGreaterEq(FVec a, FVec b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+	FN_INLINE FMask MAnd(FMask a, FMask b) { return _mm256_and_ps(a, b); }
+	FN_INLINE FMask MOr(FMask a, FMask b) { return _mm256_or_ps(a, b); }
+	FN_INLINE FMask MNot(FMask a) { return _mm256_xor_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(-1))); }
+	FN_INLINE IVec MaskToOne(FMask m) { return _mm256_and_si256(_mm256_castps_si256(m), _mm256_set1_epi32(1)); }
+	FN_INLINE bool MAll(FMask m) { return _mm256_movemask_ps(m) == 0xff; }
+
+	FN_INLINE IVec IAdd(IVec a, IVec b) { return _mm256_add_epi32(a, b); }
+	FN_INLINE IVec IAnd(IVec a, IVec b) { return _mm256_and_si256(a, b); }
+	FN_INLINE IVec IXor(IVec a, IVec b) { return _mm256_xor_si256(a, b); }
+	FN_INLINE IVec IMul(IVec a, IVec b) { return _mm256_mullo_epi32(a, b); }
+	FN_INLINE IVec IShiftRight(IVec a, int32 bits) { return _mm256_srli_epi32(a, bits); }
+	FN_INLINE IVec ISelect(FMask m, IVec a, IVec b) { return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(b), _mm256_castsi256_ps(a), m)); }
+	FN_INLINE FMask ILessMask(IVec a, IVec b) { return _mm256_castsi256_ps(_mm256_cmpgt_epi32(b, a)); }
+	FN_INLINE FMask IBitMask(IVec a, int32 bit) { return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(a, _mm256_set1_epi32(bit)), _mm256_set1_epi32(bit))); }
+
+	FN_INLINE FVec IToF(IVec i) { return _mm256_cvtepi32_ps(i); }
+	FN_INLINE IVec VFastFloor(FVec f) { return _mm256_add_epi32(_mm256_cvttps_epi32(f), _mm256_castps_si256(_mm256_cmp_ps(f, _mm256_setzero_ps(), _CMP_LT_OQ))); }
+	FN_INLINE IVec VFastRound(FVec f) { return _mm256_cvttps_epi32(_mm256_add_ps(f, _mm256_or_ps(_mm256_and_ps(f, _mm256_set1_ps(-0.0f)), _mm256_set1_ps(0.5f)))); }
+
+	FN_INLINE IVec IGather(const int32* table, IVec i) { return _mm256_i32gather_epi32(table, i, 4); }
+	FN_INLINE FVec VGather(const float* table, IVec i) { return _mm256_i32gather_ps(table, i, 4); }
+
+#include "FastNoiseBatchKernels.inl"
+
+#undef FN_INLINE
+#undef FN_FUNC
+}
+
+#endif // FASTNOISE_BATCH_X86
+
+namespace FastNoiseBatch
+{
+#if FASTNOISE_BATCH_X86
+	static void CpuId(uint32 info[4], uint32 leaf)
+	{
+#if defined(_MSC_VER)
+		__cpuidex((int*)info, (int)leaf, 0);
+#else
+		__cpuid_count(leaf, 0, info[0], info[1], info[2], info[3]);
+#endif
+	}
+
+	// The register state the OS saves on context switches, AVX is only usable if it saves the YMM registers
+	static uint64 GetEnabledXSaveFeatures()
+	{
+#if defined(_MSC_VER)
+		return _xgetbv(0);
+#else
+		uint32 eax, edx;
+		__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+		return ((uint64)edx << 32) | eax;
+#endif
+	}
+#endif
+
+	static EInstructionSet DetectInstructionSet()
+	{
+#if FASTNOISE_BATCH_X86
+		uint32 info[4];
+		CpuId(info, 0);
+		const uint32 maxLeaf = info[0];
+
+		CpuId(info, 1);
+		const bool bSSE41 = (info[2] & (1 << 19)) != 0;
+		const bool bOSXSave = (info[2] & (1 << 27)) != 0;
+		const bool bAVX = (info[2] & (1 << 28)) != 0;
+
+		if (bAVX && bOSXSave && (GetEnabledXSaveFeatures() & 0x6) == 0x6 && maxLeaf >= 7)
+		{
+			CpuId(info, 7);
+			if ((info[1] & (1 << 5)) != 0)
+			{
+				return EInstructionSet::AVX2;
+			}
+		}
+
+		if (bSSE41)
+		{
+			return EInstructionSet::SSE41;
+		}
+#endif
+		return EInstructionSet::Scalar;
+	}
+
+	EInstructionSet GetInstructionSet()
+	{
+		static const EInstructionSet instructionSet = DetectInstructionSet();
+		return instructionSet;
+	}
+
+	const TCHAR* GetInstructionSetName(EInstructionSet instructionSet)
+	{
+		switch (instructionSet)
+		{
+		case EInstructionSet::SSE41:
+			return TEXT("SSE4.1");
+		case EInstructionSet::AVX2:
+			return TEXT("AVX2");
+		default:
+			return TEXT("Scalar");
+		}
+	}
+
+	bool SupportsConfiguration(const FFastNoiseBatchParams& params)
+	{
+		switch (params.NoiseType)
+		{
+		case ENoiseType::Value:
+		case ENoiseType::ValueFractal:
+		case ENoiseType::Gradient:
+		case ENoiseType::GradientFractal:
+		case ENoiseType::Simplex:
+		case ENoiseType::SimplexFractal:
+			return true;
+		case ENoiseType::Cellular:
+			// The lookup is another generator, evaluated a point at a time
+			return params.CellularReturnType != ECellularReturnType::NoiseLookup;
+		default:
+			return false;
+		}
+	}
+
+	void BindKernels(const FFastNoiseBatchParams& params, FFastNoiseBatchKernels& outKernels)
+	{
+		outKernels = FFastNoiseBatchKernels();
+		const bool bSupported = SupportsConfiguration(params);
+
+		// Warping works for every configuration, so it's bound even when the noise itself isn't
+		switch (GetInstructionSet())
+		{
+#if FASTNOISE_BATCH_X86
+		case EInstructionSet::AVX2:
+			FastNoiseBatchAVX2::BindPositionWarp(outKernels, params);
+			if (bSupported)
+			{
+				FastNoiseBatchAVX2::BindKernels(outKernels, params);
+			}
+			return;
+		case EInstructionSet::SSE41:
+			FastNoiseBatchSSE41::BindPositionWarp(outKernels, params);
+			if (bSupported)
+			{
+				FastNoiseBatchSSE41::BindKernels(outKernels, params);
+			}
+			return;
+#endif
+		default:
+			FastNoiseBatchScalar::BindPositionWarp(outKernels, params);
+			if (bSupported)
+			{
+				FastNoiseBatchScalar::BindKernels(outKernels, params);
+			}
+			return;
+		}
+	}
+}
@@ -0,0 +1,1528 @@
+// FastNoiseBatchKernels.inl
+//
+// The batch noise kernels, written once against a small set of vector primitives.
+// FastNoiseBatch.cpp includes this file once per instruction set, inside a namespace that defines:
+//
+//   FVec, IVec, FMask      float vector, int32 vector and float comparison mask
+//   Lanes                  the number of points in a vector
+//   FN_INLINE, FN_FUNC     qualifiers for small and large kernel functions, including any target attribute
+//   the primitives         VLoad, VStore, VSet, ISet, ILaneIndex, VAdd, VSub, VMul, VDiv, VMin, VMax, VAbs, VSelect,
+//                          VGreater, VGreaterEq, MAnd, MOr, MNot, MaskToOne, MAll, IAdd, IAnd, IXor, IMul, IShiftRight,
+//                          ISelect, ILessMask, IBitMask, VNegateIf, IToF, VFastFloor, VFastRound, IGather, VGather
+//
+// The operations and their order follow FastNoise.cpp exactly, so the results match the single point functions.
+//
+// The kernels are templated on the noise type, fractal type, interpolation and lattice hash, or the distance function and
+// lattice hash for Cellular, so every switch on them is resolved at compile time. BindKernels at the end picks the
+// instantiation for a configuration.
+//
+
+// Interpolation
+
+FN_INLINE FVec Lerp(FVec a, FVec b, FVec t)
+{
+	return VAdd(a, VMul(t, VSub(b, a)));
+}
+
+FN_INLINE FVec InterpHermite(FVec t)
+{
+	return VMul(VMul(t, t), VSub(VSet(3.0f), VMul(VSet(2.0f), t)));
+}
+
+FN_INLINE FVec InterpQuintic(FVec t)
+{
+	return VMul(VMul(VMul(t, t), t), VAdd(VMul(t, VSub(VMul(t, VSet(6.0f)), VSet(15.0f))), VSet(10.0f)));
+}
+
+template<EInterp Interp>
+FN_INLINE FVec ApplyInterp(FVec t)
+{
+	switch (Interp)
+	{
+	case EInterp::InterpHermite:
+		return InterpHermite(t);
+	case EInterp::InterpQuintic:
+		return InterpQuintic(t);
+	default:
+		return t;
+	}
+}
+
+// Gradients, equivalent to the GRAD_X/GRAD_Y/GRAD_Z tables for a hash in 0..11
+
+FN_INLINE FVec Grad3D(IVec hash, FVec x, FVec y, FVec z)
+{
+	FVec a = VSelect(ILessMask(hash, ISet(8)), x, y);
+	FVec b = VSelect(ILessMask(hash, ISet(4)), y, z);
+	return VAdd(VNegateIf(a, IBitMask(hash, 1)), VNegateIf(b, IBitMask(hash, 2)));
+}
+
+FN_INLINE FVec Grad2D(IVec hash, FVec x, FVec y)
+{
+	FVec a = VSelect(ILessMask(hash, ISet(8)), x, y);
+	FVec b = VSelect(ILessMask(hash, ISet(4)), y, VSet(0.0f));
+	return VAdd(VNegateIf(a, IBitMask(hash, 1)), VNegateIf(b, IBitMask(hash, 2)));
+}
+
+// Hashing, the same as FFastNoise::Index2D/Index3D. Corners are hashed an axis at a time, z then y then x, so the
+// partial hash of the z and y coordinates is shared by the corners that only differ in x. With Permutation hashing
+// each axis is a table lookup, with Integer hashing it's a multiply and xor and the x axis finishes the hash
+
+FN_INLINE IVec PermLookup(const int32* table, IVec coord, IVec offset)
+{
+	return IGather(table, IAdd(IAnd(coord, ISet(0xff)), offset));
+}
+
+template<ELatticeHash Hash>
+FN_INLINE IVec HashStart(const FFastNoiseBatchParams& p, IVec offset)
+{
+	switch (Hash)
+	{
+	case ELatticeHash::Integer:
+		return IAdd(ISet(p.Seed), IMul(offset, ISet((int32)FASTNOISE_HASH_OFFSET_MULTIPLIER)));
+	default:
+		return offset;
+	}
+}
+
+template<ELatticeHash Hash>
+FN_INLINE IVec HashAxis(const FFastNoiseBatchParams& p, IVec partial, IVec coord, int32 prime)
+{
+	switch (Hash)
+	{
+	case ELatticeHash::Integer:
+		return IXor(partial, IMul(coord, ISet(prime)));
+	default:
+		return PermLookup(p.Perm, coord, partial);
+	}
+}
+
+FN_INLINE IVec HashFinish(IVec partial, IVec x)
+{
+	IVec hash = IMul(IXor(partial, IMul(x, ISet(FASTNOISE_HASH_PRIME_X))), ISet(FASTNOISE_HASH_MULTIPLIER));
+	return IXor(hash, IShiftRight(hash, 15));
+}
+
+// The gradient of a 3D corner, 0..11 from the permutation tables or from 16 bits of the integer hash scaled down to 12,
+// see FFastNoise::Index3D_12
+template<ELatticeHash Hash>
+FN_INLINE IVec HashGradIndex3D(const FFastNoiseBatchParams& p, IVec partial, IVec x)
+{
+	switch (Hash)
+	{
+	case ELatticeHash::Integer:
+		return IShiftRight(IMul(IAnd(HashFinish(partial, x), ISet(0xffff)), ISet(12)), 16);
+	default:
+		return PermLookup(p.Perm12, x, partial);
+	}
+}
+
+// The gradient of a 2D corner. The integer hash picks one of the 8 directions 0..5 and 8..9, so the axes are picked
+// as often as each other, see FFastNoise::Index2D_12
+template<ELatticeHash Hash>
+FN_INLINE IVec HashGradIndex2D(const FFastNoiseBatchParams& p, IVec partial, IVec x)
+{
+	switch (Hash)
+	{
+	case ELatticeHash::Integer:
+	{
+		IVec hash = IAnd(HashFinish(partial, x), ISet(7));
+		return IAdd(hash, IAnd(IShiftRight(IAdd(hash, ISet(2)), 2), ISet(2)));
+	}
+	default:
+		return PermLookup(p.Perm12, x, partial);
+	}
+}
+
+// The value of a corner, integer hashes are turned into a value directly rather than through the lookup table
+template<ELatticeHash Hash>
+FN_INLINE FVec HashValue(const FFastNoiseBatchParams& p, IVec partial, IVec x)
+{
+	switch (Hash)
+	{
+	case ELatticeHash::Integer:
+		return VMul(IToF(HashFinish(partial, x)), VSet(1.0f / 2147483648.0f));
+	default:
+		return VGather(p.ValueLUT, PermLookup(p.Perm, x, partial));
+	}
+}
+
+template<ELatticeHash Hash>
+FN_INLINE IVec Index2D(const FFastNoiseBatchParams& p, IVec offset, IVec x, IVec y)
+{
+	return HashGradIndex2D<Hash>(p, HashAxis<Hash>(p, HashStart<Hash>(p, offset), y, FASTNOISE_HASH_PRIME_Y), x);
+}
+
+template<ELatticeHash Hash>
+FN_INLINE IVec Index3D(const FFastNoiseBatchParams& p, IVec offset, IVec x, IVec y, IVec z)
+{
+	IVec partial = HashAxis<Hash>(p, HashStart<Hash>(p, offset), z, FASTNOISE_HASH_PRIME_Z);
+	return HashGradIndex3D<Hash>(p, HashAxis<Hash>(p, partial, y, FASTNOISE_HASH_PRIME_Y), x);
+}
+
+// Value
+
+template<EInterp Interp, ELatticeHash Hash>
+FN_FUNC FVec SingleValue(const FFastNoiseBatchParams& p, IVec offset, FVec x, FVec y)
+{
+	IVec x0 = VFastFloor(x);
+	IVec y0 = VFastFloor(y);
+	IVec x1 = IAdd(x0, ISet(1));
+	IVec y1 = IAdd(y0, ISet(1));
+
+	FVec xs = ApplyInterp<Interp>(VSub(x, IToF(x0)));
+	FVec ys = ApplyInterp<Interp>(VSub(y, IToF(y0)));
+
+	// The row lookups are shared by both corners of the row
+	IVec seed = HashStart<Hash>(p, offset);
+	IVec py0 = HashAxis<Hash>(p, seed, y0, FASTNOISE_HASH_PRIME_Y);
+	IVec py1 = HashAxis<Hash>(p, seed, y1, FASTNOISE_HASH_PRIME_Y);
+
+	FVec xf0 = Lerp(HashValue<Hash>(p, py0, x0), HashValue<Hash>(p, py0, x1), xs);
+	FVec xf1 = Lerp(HashValue<Hash>(p, py1, x0), HashValue<Hash>(p, py1, x1), xs);
+
+	return Lerp(xf0, xf1, ys);
+}
+
+template<EInterp Interp, ELatticeHash Hash>
+FN_FUNC FVec SingleValue(const FFastNoiseBatchParams& p, IVec offset, FVec x, FVec y, FVec z)
+{
+	IVec x0 = VFastFloor(x);
+	IVec y0 = VFastFloor(y);
+	IVec z0 = VFastFloor(z);
+	IVec x1 = IAdd(x0, ISet(1));
+	IVec y1 = IAdd(y0, ISet(1));
+	IVec z1 = IAdd(z0, ISet(1));
+
+	FVec xs = ApplyInterp<Interp>(VSub(x, IToF(x0)));
+	FVec ys = ApplyInterp<Interp>(VSub(y, IToF(y0)));
+	FVec zs = ApplyInterp<Interp>(VSub(z, IToF(z0)));
+
+	IVec seed = HashStart<Hash>(p, offset);
+	IVec pz0 = HashAxis<Hash>(p, seed, z0, FASTNOISE_HASH_PRIME_Z);
+	IVec pz1 = HashAxis<Hash>(p, seed, z1, FASTNOISE_HASH_PRIME_Z);
+	IVec py0z0 = HashAxis<Hash>(p, pz0, y0, FASTNOISE_HASH_PRIME_Y);
+	IVec py1z0 = HashAxis<Hash>(p, pz0, y1, FASTNOISE_HASH_PRIME_Y);
+	IVec py0z1 = HashAxis<Hash>(p, pz1, y0, FASTNOISE_HASH_PRIME_Y);
+	IVec py1z1 = HashAxis<Hash>(p, pz1, y1, FASTNOISE_HASH_PRIME_Y);
+
+	FVec xf00 = Lerp(HashValue<Hash>(p, py0z0, x0), HashValue<Hash>(p, py0z0, x1), xs);
+	FVec xf10 = Lerp(HashValue<Hash>(p, py1z0, x0), HashValue<Hash>(p, py1z0, x1), xs);
+	FVec xf01 = Lerp(HashValue<Hash>(p, py0z1, x0), HashValue<Hash>(p, py0z1, x1), xs);
+	FVec xf11 = Lerp(HashValue<Hash>(p, py1z1, x0), HashValue<Hash>(p, py1z1, x1), xs);
+
+	FVec yf0 = Lerp(xf00, xf10, ys);
+	FVec yf1 = Lerp(xf01, xf11, ys);
+
+	return Lerp(yf0, yf1, zs);
+}
+
+// Gradient
+
+template<EInterp Interp, ELatticeHash Hash>
+FN_FUNC FVec SingleGradient(const FFastNoiseBatchParams& p, IVec offset, FVec x, FVec y)
+{
+	IVec x0 = VFastFloor(x);
+	IVec y0 = VFastFloor(y);
+	IVec x1 = IAdd(x0, ISet(1));
+	IVec y1 = IAdd(y0, ISet(1));
+
+	FVec xd0 = VSub(x, IToF(x0));
+	FVec yd0 = VSub(y, IToF(y0));
+	FVec xd1 = VSub(xd0, VSet(1.0f));
+	FVec yd1 = VSub(yd0, VSet(1.0f));
+
+	FVec xs = ApplyInterp<Interp>(xd0);
+	FVec ys = ApplyInterp<Interp>(yd0);
+
+	IVec seed = HashStart<Hash>(p, offset);
+	IVec py0 = HashAxis<Hash>(p, seed, y0, FASTNOISE_HASH_PRIME_Y);
+	IVec py1 = HashAxis<Hash>(p, seed, y1, FASTNOISE_HASH_PRIME_Y);
+
+	FVec xf0 = Lerp(Grad2D(HashGradIndex2D<Hash>(p, py0, x0), xd0, yd0), Grad2D(HashGradIndex2D<Hash>(p, py0, x1), xd1, yd0), xs);
+	FVec xf1 = Lerp(Grad2D(HashGradIndex2D<Hash>(p, py1, x0), xd0, yd1), Grad2D(HashGradIndex2D<Hash>(p, py1, x1), xd1, yd1), xs);
+
+	return Lerp(xf0, xf1, ys);
+}
+
+template<EInterp Interp, ELatticeHash Hash>
+FN_FUNC FVec SingleGradient(const FFastNoiseBatchParams& p, IVec offset, FVec x, FVec y, FVec z)
+{
+	IVec x0 = VFastFloor(x);
+	IVec y0 = VFastFloor(y);
+	IVec z0 = VFastFloor(z);
+	IVec x1 = IAdd(x0, ISet(1));
+	IVec y1 = IAdd(y0, ISet(1));
+	IVec z1 = IAdd(z0, ISet(1));
+
+	FVec xd0 = VSub(x, IToF(x0));
+	FVec yd0 = VSub(y, IToF(y0));
+	FVec zd0 = VSub(z, IToF(z0));
+	FVec xd1 = VSub(xd0, VSet(1.0f));
+	FVec yd1 = VSub(yd0, VSet(1.0f));
+	FVec zd1 = VSub(zd0, VSet(1.0f));
+
+	FVec xs = ApplyInterp<Interp>(xd0);
+	FVec ys = ApplyInterp<Interp>(yd0);
+	FVec zs = ApplyInterp<Interp>(zd0);
+
+	IVec seed = HashStart<Hash>(p, offset);
+	IVec pz0 = HashAxis<Hash>(p, seed, z0, FASTNOISE_HASH_PRIME_Z);
+	IVec pz1 = HashAxis<Hash>(p, seed, z1, FASTNOISE_HASH_PRIME_Z);
+	IVec py0z0 = HashAxis<Hash>(p, pz0, y0, FASTNOISE_HASH_PRIME_Y);
+	IVec py1z0 = HashAxis<Hash>(p, pz0, y1, FASTNOISE_HASH_PRIME_Y);
+	IVec py0z1 = HashAxis<Hash>(p, pz1, y0, FASTNOISE_HASH_PRIME_Y);
+	IVec py1z1 = HashAxis<Hash>(p, pz1, y1, FASTNOISE_HASH_PRIME_Y);
+
+	FVec xf00 = Lerp(Grad3D(HashGradIndex3D<Hash>(p, py0z0, x0), xd0, yd0, zd0), Grad3D(HashGradIndex3D<Hash>(p, py0z0, x1), xd1, yd0, zd0), xs);
+	FVec xf10 = Lerp(Grad3D(HashGradIndex3D<Hash>(p, py1z0, x0), xd0, yd1, zd0), Grad3D(HashGradIndex3D<Hash>(p, py1z0, x1), xd1, yd1, zd0), xs);
+	FVec xf01 = Lerp(Grad3D(HashGradIndex3D<Hash>(p, py0z1, x0), xd0, yd0, zd1), Grad3D(HashGradIndex3D<Hash>(p, py0z1, x1), xd1, yd0, zd1), xs);
+	FVec xf11 = Lerp(Grad3D(HashGradIndex3D<Hash>(p, py1z1, x0), xd0, yd1, zd1), Grad3D(HashGradIndex3D<Hash>(p, py1z1, x1), xd1, yd1, zd1), xs);
+
+	FVec yf0 = Lerp(xf00, xf10, ys);
+	FVec yf1 = Lerp(xf01, xf11, ys);
+
+	return Lerp(yf0, yf1, zs);
+}
+
+// Simplex
+
+template<ELatticeHash Hash>
+FN_INLINE FVec SimplexCorner2D(const FFastNoiseBatchParams& p, IVec offset, IVec i, IVec j, FVec x, FVec y)
+{
+	// Corners out of range contribute nothing, clamping t to 0 does that without a branch
+	FVec t = VMax(VSub(VSub(VSet(0.5f), VMul(x, x)), VMul(y, y)), VSet(0.0f));
+	t = VMul(t, t);
+	return VMul(VMul(t, t), Grad2D(Index2D<Hash>(p, offset, i, j), x, y));
+}
+
+template<ELatticeHash Hash>
+FN_FUNC FVec SingleSimplex(const FFastNoiseBatchParams& p, IVec offset, FVec x, FVec y)
+{
+	const float F2 = 1.f / 2.f;
+	const float G2 = 1.f / 4.f;
+
+	FVec t = VMul(VAdd(x, y), VSet(F2));
+	IVec i = VFastFloor(VAdd(x, t));
+	IVec j = VFastFloor(VAdd(y, t));
+
+	t = VMul(IToF(IAdd(i, j)), VSet(G2));
+	FVec x0 = VSub(x, VSub(IToF(i), t));
+	FVec y0 = VSub(y, VSub(IToF(j), t));
+
+	FMask xy = VGreater(x0, y0);
+	IVec i1 = MaskToOne(xy);
+	IVec j1 = MaskToOne(MNot(xy));
+
+	FVec x1 = VAdd(VSub(x0, IToF(i1)), VSet(G2));
+	FVec y1 = VAdd(VSub(y0, IToF(j1)), VSet(G2));
+	FVec x2 = VAdd(VSub(x0, VSet(1.0f)), VSet(2.0f * G2));
+	FVec y2 = VAdd(VSub(y0, VSet(1.0f)), VSet(2.0f * G2));
+
+	FVec n0 = SimplexCorner2D<Hash>(p, offset, i, j, x0, y0);
+	FVec n1 = SimplexCorner2D<Hash>(p, offset, IAdd(i, i1), IAdd(j, j1), x1, y1);
+	FVec n2 = SimplexCorner2D<Hash>(p, offset, IAdd(i, ISet(1)), IAdd(j, ISet(1)), x2, y2);
+
+	return VMul(VSet(50.0f), VAdd(VAdd(n0, n1), n2));
+}
+
+template<ELatticeHash Hash>
+FN_INLINE FVec SimplexCorner3D(const FFastNoiseBatchParams& p, IVec offset, IVec i, IVec j, IVec k, FVec x, FVec y, FVec z)
+{
+	FVec t = VMax(VSub(VSub(VSub(VSet(0.6f), VMul(x, x)), VMul(y, y)), VMul(z, z)), VSet(0.0f));
+	t = VMul(t, t);
+	return VMul(VMul(t, t), Grad3D(Index3D<Hash>(p, offset, i, j, k), x, y, z));
+}
+
+template<ELatticeHash Hash>
+FN_FUNC FVec SingleSimplex(const FFastNoiseBatchParams& p, IVec offset, FVec x, FVec y, FVec z)
+{
+	const float F3 = 1.0f / 3.0f;
+	const float G3 = 1.0f / 6.0f;
+
+	FVec t = VMul(VAdd(VAdd(x, y), z), VSet(F3));
+	IVec i = VFastFloor(VAdd(x, t));
+	IVec j = VFastFloor(VAdd(y, t));
+	IVec k = VFastFloor(VAdd(z, t));
+
+	t = VMul(IToF(IAdd(IAdd(i, j), k)), VSet(G3));
+	FVec x0 = VSub(x, VSub(IToF(i), t));
+	FVec y0 = VSub(y, VSub(IToF(j), t));
+	FVec z0 = VSub(z, VSub(IToF(k), t));
+
+	// The branches in FFastNoise::SingleSimplex picking the simplex, reduced to masks
+	FMask xy = VGreaterEq(x0, y0);
+	FMask yz = VGreaterEq(y0, z0);
+	FMask xz = VGreaterEq(x0, z0);
+
+	IVec i1 = MaskToOne(MAnd(xy, xz));
+	IVec j1 = MaskToOne(MAnd(MNot(xy), yz));
+	IVec k1 = MaskToOne(MNot(MOr(xz, yz)));
+	IVec i2 = MaskToOne(MOr(xy, xz));
+	IVec j2 = MaskToOne(MOr(MNot(xy), yz));
+	IVec k2 = MaskToOne(MNot(MAnd(xz, yz)));
+
+	FVec x1 = VAdd(VSub(x0, IToF(i1)), VSet(G3));
+	FVec y1 = VAdd(VSub(y0, IToF(j1)), VSet(G3));
+	FVec z1 = VAdd(VSub(z0, IToF(k1)), VSet(G3));
+	FVec x2 = VAdd(VSub(x0, IToF(i2)), VSet(2.0f * G3));
+	FVec y2 = VAdd(VSub(y0, IToF(j2)), VSet(2.0f * G3));
+	FVec z2 = VAdd(VSub(z0, IToF(k2)), VSet(2.0f * G3));
+	FVec x3 = VAdd(VSub(x0, VSet(1.0f)), VSet(3.0f * G3));
+	FVec y3 = VAdd(VSub(y0, VSet(1.0f)), VSet(3.0f * G3));
+	FVec z3 = VAdd(VSub(z0, VSet(1.0f)), VSet(3.0f * G3));
+
+	FVec n0 = SimplexCorner3D<Hash>(p, offset, i, j, k, x0, y0, z0);
+	FVec n1 = SimplexCorner3D<Hash>(p, offset, IAdd(i, i1), IAdd(j, j1), IAdd(k, k1), x1, y1, z1);
+	FVec n2 = SimplexCorner3D<Hash>(p, offset, IAdd(i, i2), IAdd(j, j2), IAdd(k, k2), x2, y2, z2);
+	FVec n3 = SimplexCorner3D<Hash>(p, offset, IAdd(i, ISet(1)), IAdd(j, ISet(1)), IAdd(k, ISet(1)), x3, y3, z3);
+
+	return VMul(VSet(32.0f), VAdd(VAdd(VAdd(n0, n1), n2), n3));
+}
+
+// Cellular, matching FFastNoise::SingleCellular. Each lane searches the cells around its own nearest one, all lanes
+// walk the same offsets together in the same order as the single point code. Planes, rows and cells are skipped
+// when the FASTNOISE_CELL_JITTER_BOUND bound shows no lane can find a closer, or second closest, feature point there
+
+static const int32 CellularSearchOrder[3] = { 0, -1, 1 };
+
+template<ECellularDistanceFunction Distance>
+FN_INLINE FVec CellularDistance(FVec x, FVec y)
+{
+	switch (Distance)
+	{
+	case ECellularDistanceFunction::Manhattan:
+		return VAdd(VAbs(x), VAbs(y));
+	case ECellularDistanceFunction::Natural:
+		return VAdd(VAdd(VAbs(x), VAbs(y)), VAdd(VMul(x, x), VMul(y, y)));
+	default:
+		return VAdd(VMul(x, x), VMul(y, y));
+	}
+}
+
+template<ECellularDistanceFunction Distance>
+FN_INLINE FVec CellularDistance(FVec x, FVec y, FVec z)
+{
+	switch (Distance)
+	{
+	case ECellularDistanceFunction::Manhattan:
+		return VAdd(VAdd(VAbs(x), VAbs(y)), VAbs(z));
+	case ECellularDistanceFunction::Natural:
+		return VAdd(VAdd(VAdd(VAbs(x), VAbs(y)), VAbs(z)), VAdd(VAdd(VMul(x, x), VMul(y, y)), VMul(z, z)));
+	default:
+		return VAdd(VAdd(VMul(x, x), VMul(y, y)), VMul(z, z));
+	}
+}
+
+// Lower bound of the distance along an axis from x to the feature point of cell xi
+FN_INLINE FVec CellularAxisBound(IVec xi, FVec x)
+{
+	return VMax(VSub(VAbs(VSub(IToF(xi), x)), VSet(FASTNOISE_CELL_JITTER_BOUND)), VSet(0.0f));
+}
+
+// True when no lane can improve on the threshold with a cell, plane or row this far away
+FN_INLINE bool CellularSkip(FVec bound, FVec threshold)
+{
+	return MAll(VGreater(bound, threshold));
+}
+
+// The cell's entry in the CELL_* tables, the same as FFastNoise::Index2D_256/Index3D_256
+template<ELatticeHash Hash>
+FN_INLINE IVec HashIndex256(const FFastNoiseBatchParams& p, IVec partial, IVec x)
+{
+	switch (Hash)
+	{
+	case ELatticeHash::Integer:
+		return IAnd(HashFinish(partial, x), ISet(0xff));
+	default:
+		return PermLookup(p.Perm, x, partial);
+	}
+}
+
+// The rest of ValCoord2D/ValCoord3D in FastNoise.cpp, from the sum of the primed coordinates with a seed of 0
+FN_INLINE FVec CellValue(IVec n)
+{
+	n = IAnd(n, ISet(0x7fffffff));
+	n = IXor(IShiftRight(n, 13), n);
+	IVec v = IAdd(IMul(n, IAdd(IMul(IMul(n, n), ISet(60493)), ISet(19990303))), ISet(1376312589));
+	v = IAdd(IAnd(v, ISet(0x7fffffff)), ISet(-1073891824));
+	return VMul(VSet(9.311924889611565e-10f), IToF(v));
+}
+
+// The value for the return type from the search results, cellPrimed is the closest cell's coordinates times the
+// ValCoord primes
+FN_INLINE FVec CellularReturn(const FFastNoiseBatchParams& p, FVec distance, FVec distance2, IVec cellPrimed)
+{
+	switch (p.CellularReturnType)
+	{
+	case ECellularReturnType::CellValue:
+		return CellValue(cellPrimed);
+	case ECellularReturnType::Distance:
+		return VSub(distance, VSet(1.0f));
+	case ECellularReturnType::Distance2:
+		return VSub(distance2, VSet(1.0f));
+	case ECellularReturnType::Distance2Add:
+		return VSub(VAdd(distance2, distance), VSet(1.0f));
+	case ECellularReturnType::Distance2Sub:
+		return VSub(VSub(distance2, distance), VSet(1.0f));
+	case ECellularReturnType::Distance2Mul:
+		return VSub(VMul(distance2, distance), VSet(1.0f));
+	case ECellularReturnType::Distance2Div:
+		return VSub(VDiv(distance, distance2), VSet(1.0f));
+	default:
+		return VSet(0.0f);
+	}
+}
+
+template<ECellularDistanceFunction Distance, ELatticeHash Hash>
+FN_FUNC FVec SingleCellular(const FFastNoiseBatchParams& p, FVec x, FVec y)
+{
+	const IVec xr = VFastRound(x);
+	const IVec yr = VFastRound(y);
+	const IVec start = HashStart<Hash>(p, ISet(0));
+
+	// The F1 only return types can't be changed by a cell that isn't closer than the closest so far
+	const bool bDistance2 = p.CellularReturnType >= ECellularReturnType::Distance2;
+
+	FVec distance = VSet(999999.f);
+	FVec distance2 = VSet(999999.f);
+	IVec xc = xr;
+	IVec yc = yr;
+
+	for (int32 yo : CellularSearchOrder)
+	{
+		const IVec yi = IAdd(yr, ISet(yo));
+		const FVec boundY = CellularAxisBound(yi, y);
+		if (CellularSkip(CellularDistance<Distance>(VSet(0.0f), boundY), bDistance2 ? distance2 : distance))
+		{
+			continue;
+		}
+
+		const IVec partial = HashAxis<Hash>(p, start, yi, FASTNOISE_HASH_PRIME_Y);
+
+		for (int32 xo : CellularSearchOrder)
+		{
+			const IVec xi = IAdd(xr, ISet(xo));
+			if (CellularSkip(CellularDistance<Distance>(CellularAxisBound(xi, x), boundY), bDistance2 ? distance2 : distance))
+			{
+				continue;
+			}
+
+			const IVec lutPos = HashIndex256<Hash>(p, partial, xi);
+			FVec vecX = VAdd(VSub(IToF(xi), x), VGather(p.Cell2DX, lutPos));
+			FVec vecY = VAdd(VSub(IToF(yi), y), VGather(p.Cell2DY, lutPos));
+			FVec newDistance = CellularDistance<Distance>(vecX, vecY);
+
+			distance2 = VMax(VMin(distance2, newDistance), distance);
+
+			FMask closer = VGreater(distance, newDistance);
+			distance = VSelect(closer, newDistance, distance);
+			xc = ISelect(closer, xi, xc);
+			yc = ISelect(closer, yi, yc);
+		}
+	}
+
+	return CellularReturn(p, distance, distance2, IAdd(IMul(xc, ISet(1619)), IMul(yc, ISet(31337))));
+}
+
+template<ECellularDistanceFunction Distance, ELatticeHash Hash>
+FN_FUNC FVec SingleCellular(const FFastNoiseBatchParams& p, FVec x, FVec y, FVec z)
+{
+	const IVec xr = VFastRound(x);
+	const IVec yr = VFastRound(y);
+	const IVec zr = VFastRound(z);
+	const IVec start = HashStart<Hash>(p, ISet(0));
+	const bool bDistance2 = p.CellularReturnType >= ECellularReturnType::Distance2;
+	const FVec zero = VSet(0.0f);
+
+	FVec distance = VSet(999999.f);
+	FVec distance2 = VSet(999999.f);
+	IVec xc = xr;
+	IVec yc = yr;
+	IVec zc = zr;
+
+	for (int32 zo : CellularSearchOrder)
+	{
+		const IVec zi = IAdd(zr, ISet(zo));
+		const FVec boundZ = CellularAxisBound(zi, z);
+		if (CellularSkip(CellularDistance<Distance>(zero, zero, boundZ), bDistance2 ? distance2 : distance))
+		{
+			continue;
+		}
+
+		const IVec partialZ = HashAxis<Hash>(p, start, zi, FASTNOISE_HASH_PRIME_Z);
+
+		for (int32 yo : CellularSearchOrder)
+		{
+			const IVec yi = IAdd(yr, ISet(yo));
+			const FVec boundY = CellularAxisBound(yi, y);
+			if (CellularSkip(CellularDistance<Distance>(zero, boundY, boundZ), bDistance2 ? distance2 : distance))
+			{
+				continue;
+			}
+
+			const IVec partial = HashAxis<Hash>(p, partialZ, yi, FASTNOISE_HASH_PRIME_Y);
+
+			for (int32 xo : CellularSearchOrder)
+			{
+				const IVec xi = IAdd(xr, ISet(xo));
+				if (CellularSkip(CellularDistance<Distance>(CellularAxisBound(xi, x), boundY, boundZ), bDistance2 ? distance2 : distance))
+				{
+					continue;
+				}
+
+				const IVec lutPos = HashIndex256<Hash>(p, partial, xi);
+				FVec vecX = VAdd(VSub(IToF(xi), x), VGather(p.Cell3DX, lutPos));
+				FVec vecY = VAdd(VSub(IToF(yi), y), VGather(p.Cell3DY, lutPos));
+				FVec vecZ = VAdd(VSub(IToF(zi), z), VGather(p.Cell3DZ, lutPos));
+				FVec newDistance = CellularDistance<Distance>(vecX, vecY, vecZ);
+
+				distance2 = VMax(VMin(distance2, newDistance), distance);
+
+				FMask closer = VGreater(distance, newDistance);
+				distance = VSelect(closer, newDistance, distance);
+				xc = ISelect(closer, xi, xc);
+				yc = ISelect(closer, yi, yc);
+				zc = ISelect(closer, zi, zc);
+			}
+		}
+	}
+
+	return CellularReturn(p, distance, distance2, IAdd(IAdd(IMul(xc, ISet(1619)), IMul(yc, ISet(31337))), IMul(zc, ISet(6971))));
+}
+
+template<ECellularDistanceFunction Distance, ELatticeHash Hash>
+FN_FUNC FVec CellularNoise(const FFastNoiseBatchParams& p, FVec x, FVec y)
+{
+	return SingleCellular<Distance, Hash>(p, VMul(x, VSet(p.Frequency)), VMul(y, VSet(p.Frequency)));
+}
+
+template<ECellularDistanceFunction Distance, ELatticeHash Hash>
+FN_FUNC FVec CellularNoise(const FFastNoiseBatchParams& p, FVec x, FVec y, FVec z)
+{
+	return SingleCellular<Distance, Hash>(p, VMul(x, VSet(p.Frequency)), VMul(y, VSet(p.Frequency)), VMul(z, VSet(p.Frequency)));
+}
+
+// Single octave of the configured noise type
+
+template<ENoiseType NoiseType, EInterp Interp, ELatticeHash Hash>
+FN_INLINE FVec SingleNoise(const FFastNoiseBatchParams& p, IVec offset, FVec x, FVec y)
+{
+	switch (NoiseType)
+	{
+	case ENoiseType::Value:
+	case ENoiseType::ValueFractal:
+		return SingleValue<Interp, Hash>(p, offset, x, y);
+	case ENoiseType::Gradient:
+	case ENoiseType::GradientFractal:
+		return SingleGradient<Interp, Hash>(p, offset, x, y);
+	default:
+		return SingleSimplex<Hash>(p, offset, x, y);
+	}
+}
+
+template<ENoiseType NoiseType, EInterp Interp, ELatticeHash Hash>
+FN_INLINE FVec SingleNoise(const FFastNoiseBatchParams& p, IVec offset, FVec x, FVec y, FVec z)
+{
+	switch (NoiseType)
+	{
+	case ENoiseType::Value:
+	case ENoiseType::ValueFractal:
+		return SingleValue<Interp, Hash>(p, offset, x, y, z);
+	case ENoiseType::Gradient:
+	case ENoiseType::GradientFractal:
+		return SingleGradient<Interp, Hash>(p, offset, x, y, z);
+	default:
+		return SingleSimplex<Hash>(p, offset, x, y, z);
+	}
+}
+
+// Fractals, matching FFastNoise::Single*FractalFBM/Billow/RigidMulti
+
+template<EFractalType FractalType>
+FN_INLINE FVec OctaveValue(FVec noise)
+{
+	switch (FractalType)
+	{
+	case EFractalType::Billow:
+		return VSub(VMul(VAbs(noise), VSet(2.0f)), VSet(1.0f));
+	case EFractalType::RigidMulti:
+		return VSub(VSet(1.0f), VAbs(noise));
+	default:
+		return noise;
+	}
+}
+
+template<ENoiseType NoiseType, EFractalType FractalType, EInterp Interp, ELatticeHash Hash>
+FN_FUNC FVec FractalNoise(const FFastNoiseBatchParams& p, FVec x, FVec y)
+{
+	FVec sum = OctaveValue<FractalType>(SingleNoise<NoiseType, Interp, Hash>(p, ISet(p.Perm[0]), x, y));
+	float amp = 1.0f;
+
+	for (int32 i = 1; i < p.Octaves; i++)
+	{
+		x = VMul(x, VSet(p.Lacunarity));
+		y = VMul(y, VSet(p.Lacunarity));
+
+		amp *= p.Gain;
+		if (i + 1 == p.Octaves)
+		{
+			amp *= p.LastOctaveWeight;
+		}
+		FVec octave = VMul(OctaveValue<FractalType>(SingleNoise<NoiseType, Interp, Hash>(p, ISet(p.Perm[i]), x, y)), VSet(amp));
+		sum = FractalType == EFractalType::RigidMulti ? VSub(sum, octave) : VAdd(sum, octave);
+	}
+
+	return FractalType == EFractalType::RigidMulti ? sum : VMul(sum, VSet(p.FractalBounding));
+}
+
+template<ENoiseType NoiseType, EFractalType FractalType, EInterp Interp, ELatticeHash Hash>
+FN_FUNC FVec FractalNoise(const FFastNoiseBatchParams& p, FVec x, FVec y, FVec z)
+{
+	FVec sum = OctaveValue<FractalType>(SingleNoise<NoiseType, Interp, Hash>(p, ISet(p.Perm[0]), x, y, z));
+	float amp = 1.0f;
+
+	for (int32 i = 1; i < p.Octaves; i++)
+	{
+		x = VMul(x, VSet(p.Lacunarity));
+		y = VMul(y, VSet(p.Lacunarity));
+		z = VMul(z, VSet(p.Lacunarity));
+
+		amp *= p.Gain;
+		if (i + 1 == p.Octaves)
+		{
+			amp *= p.LastOctaveWeight;
+		}
+		FVec octave = VMul(OctaveValue<FractalType>(SingleNoise<NoiseType, Interp, Hash>(p, ISet(p.Perm[i]), x, y, z)), VSet(amp));
+		sum = FractalType == EFractalType::RigidMulti ? VSub(sum, octave) : VAdd(sum, octave);
+	}
+
+	return FractalType == EFractalType::RigidMulti ? sum : VMul(sum, VSet(p.FractalBounding));
+}
+
+static constexpr bool IsFractal(ENoiseType noiseType)
+{
+	return noiseType == ENoiseType::ValueFractal || noiseType == ENoiseType::GradientFractal || noiseType == ENoiseType::SimplexFractal;
+}
+
+// Entry points
+
+template<ENoiseType NoiseType, EFractalType FractalType, EInterp Interp, ELatticeHash Hash>
+FN_FUNC FVec Noise(const FFastNoiseBatchParams& p, FVec x, FVec y)
+{
+	x = VMul(x, VSet(p.Frequency));
+	y = VMul(y, VSet(p.Frequency));
+	return IsFractal(NoiseType) ? FractalNoise<NoiseType, FractalType, Interp, Hash>(p, x, y) : SingleNoise<NoiseType, Interp, Hash>(p, ISet(0), x, y);
+}
+
+template<ENoiseType NoiseType, EFractalType FractalType, EInterp Interp, ELatticeHash Hash>
+FN_FUNC FVec Noise(const FFastNoiseBatchParams& p, FVec x, FVec y, FVec z)
+{
+	x = VMul(x, VSet(p.Frequency));
+	y = VMul(y, VSet(p.Frequency));
+	z = VMul(z, VSet(p.Frequency));
+	return IsFractal(NoiseType) ? FractalNoise<NoiseType, FractalType, Interp, Hash>(p, x, y, z) : SingleNoise<NoiseType, Interp, Hash>(p, ISet(0), x, y, z);
+}
+
+// Evaluates n points with NoiseFunc, Noise or CellularNoise for a configuration
+template<FVec (*NoiseFunc)(const FFastNoiseBatchParams&, FVec, FVec)>
+FN_FUNC void GetNoise2D(const FFastNoiseBatchParams& p, const float* x, const float* y, float* out, int32 n)
+{
+	int32 i = 0;
+	for (; i + Lanes <= n; i += Lanes)
+	{
+		VStore(out + i, NoiseFunc(p, VLoad(x + i), VLoad(y + i)));
+	}
+
+	// The last partial vector is padded out to a full one
+	if (i < n)
+	{
+		float tailX[Lanes] = {};
+		float tailY[Lanes] = {};
+		float tailOut[Lanes];
+		for (int32 lane = 0; lane < n - i; lane++)
+		{
+			tailX[lane] = x[i + lane];
+			tailY[lane] = y[i + lane];
+		}
+
+		VStore(tailOut, NoiseFunc(p, VLoad(tailX), VLoad(tailY)));
+
+		for (int32 lane = 0; lane < n - i; lane++)
+		{
+			out[i + lane] = tailOut[lane];
+		}
+	}
+}
+
+template<FVec (*NoiseFunc)(const FFastNoiseBatchParams&, FVec, FVec, FVec)>
+FN_FUNC void GetNoise3D(const FFastNoiseBatchParams& p, const float* x, const float* y, const float* z, float* out, int32 n)
+{
+	int32 i = 0;
+	for (; i + Lanes <= n; i += Lanes)
+	{
+		VStore(out + i, NoiseFunc(p, VLoad(x + i), VLoad(y + i), VLoad(z + i)));
+	}
+
+	if (i < n)
+	{
+		float tailX[Lanes] = {};
+		float tailY[Lanes] = {};
+		float tailZ[Lanes] = {};
+		float tailOut[Lanes];
+		for (int32 lane = 0; lane < n - i; lane++)
+		{
+			tailX[lane] = x[i + lane];
+			tailY[lane] = y[i + lane];
+			tailZ[lane] = z[i + lane];
+		}
+
+		VStore(tailOut, NoiseFunc(p, VLoad(tailX), VLoad(tailY), VLoad(tailZ)));
+
+		for (int32 lane = 0; lane < n - i; lane++)
+		{
+			out[i + lane] = tailOut[lane];
+		}
+	}
+}
+
+// Grids, filled a row at a time. Along a row y and z are the same for every sample, so their lattice cells,
+// distances, interpolation weights and the hashes of the y/z corners are worked out once per row and octave.
+// Only the x lookups are left per sample, vectorised along the row
+
+FN_INLINE int32 FastFloorScalar(float f)
+{
+	return f >= 0.0f ? (int32)f : (int32)f - 1;
+}
+
+// HashStart and HashAxis for a single value, for the row lattices
+template<ELatticeHash Hash>
+FN_INLINE int32 HashStartScalar(const FFastNoiseBatchParams& p, int32 offset)
+{
+	switch (Hash)
+	{
+	case ELatticeHash::Integer:
+		return (int32)((uint32)p.Seed + (uint32)offset * (uint32)FASTNOISE_HASH_OFFSET_MULTIPLIER);
+	default:
+		return offset;
+	}
+}
+
+template<ELatticeHash Hash>
+FN_INLINE int32 HashAxisScalar(const FFastNoiseBatchParams& p, int32 partial, int32 coord, int32 prime)
+{
+	switch (Hash)
+	{
+	case ELatticeHash::Integer:
+		return (int32)((uint32)partial ^ ((uint32)coord * (uint32)prime));
+	default:
+		return p.Perm[(coord & 0xff) + partial];
+	}
+}
+
+struct FRowLattice2D
+{
+	// Partial hashes of the two y corners, what Index2D finishes with the x coordinate
+	int32 HashY0;
+	int32 HashY1;
+
+	FVec YD0;
+	FVec YD1;
+	FVec YS;
+};
+
+struct FRowLattice3D
+{
+	int32 HashY0Z0;
+	int32 HashY1Z0;
+	int32 HashY0Z1;
+	int32 HashY1Z1;
+
+	FVec YD0;
+	FVec YD1;
+	FVec YS;
+	FVec ZD0;
+	FVec ZD1;
+	FVec ZS;
+};
+
+template<EInterp Interp, ELatticeHash Hash>
+FN_INLINE FRowLattice2D MakeRowLattice(const FFastNoiseBatchParams& p, int32 offset, float y)
+{
+	FRowLattice2D row;
+	int32 y0 = FastFloorScalar(y);
+	int32 seed = HashStartScalar<Hash>(p, offset);
+	row.HashY0 = HashAxisScalar<Hash>(p, seed, y0, FASTNOISE_HASH_PRIME_Y);
+	row.HashY1 = HashAxisScalar<Hash>(p, seed, y0 + 1, FASTNOISE_HASH_PRIME_Y);
+
+	row.YD0 = VSet(y - (float)y0);
+	row.YD1 = VSub(row.YD0, VSet(1.0f));
+	row.YS = ApplyInterp<Interp>(row.YD0);
+	return row;
+}
+
+template<EInterp Interp, ELatticeHash Hash>
+FN_INLINE FRowLattice3D MakeRowLattice(const FFastNoiseBatchParams& p, int32 offset, float y, float z)
+{
+	FRowLattice3D row;
+	int32 y0 = FastFloorScalar(y);
+	int32 z0 = FastFloorScalar(z);
+	int32 seed = HashStartScalar<Hash>(p, offset);
+	int32 pz0 = HashAxisScalar<Hash>(p, seed, z0, FASTNOISE_HASH_PRIME_Z);
+	int32 pz1 = HashAxisScalar<Hash>(p, seed, z0 + 1, FASTNOISE_HASH_PRIME_Z);
+	row.HashY0Z0 = HashAxisScalar<Hash>(p, pz0, y0, FASTNOISE_HASH_PRIME_Y);
+	row.HashY1Z0 = HashAxisScalar<Hash>(p, pz0, y0 + 1, FASTNOISE_HASH_PRIME_Y);
+	row.HashY0Z1 = HashAxisScalar<Hash>(p, pz1, y0, FASTNOISE_HASH_PRIME_Y);
+	row.HashY1Z1 = HashAxisScalar<Hash>(p, pz1, y0 + 1, FASTNOISE_HASH_PRIME_Y);
+
+	row.YD0 = VSet(y - (float)y0);
+	row.YD1 = VSub(row.YD0, VSet(1.0f));
+	row.YS = ApplyInterp<Interp>(row.YD0);
+	row.ZD0 = VSet(z - (float)z0);
+	row.ZD1 = VSub(row.ZD0, VSet(1.0f));
+	row.ZS = ApplyInterp<Interp>(row.ZD0);
+	return row;
+}
+
+template<EInterp Interp, ELatticeHash Hash>
+FN_FUNC FVec RowValue(const FFastNoiseBatchParams& p, const FRowLattice2D& row, FVec x)
+{
+	IVec x0 = VFastFloor(x);
+	IVec x1 = IAdd(x0, ISet(1));
+	FVec xs = ApplyInterp<Interp>(VSub(x, IToF(x0)));
+
+	FVec xf0 = Lerp(HashValue<Hash>(p, ISet(row.HashY0), x0), HashValue<Hash>(p, ISet(row.HashY0), x1), xs);
+	FVec xf1 = Lerp(HashValue<Hash>(p, ISet(row.HashY1), x0), HashValue<Hash>(p, ISet(row.HashY1), x1), xs);
+
+	return Lerp(xf0, xf1, row.YS);
+}
+
+template<EInterp Interp, ELatticeHash Hash>
+FN_FUNC FVec RowValue(const FFastNoiseBatchParams& p, const FRowLattice3D& row, FVec x)
+{
+	IVec x0 = VFastFloor(x);
+	IVec x1 = IAdd(x0, ISet(1));
+	FVec xs = ApplyInterp<Interp>(VSub(x, IToF(x0)));
+
+	FVec xf00 = Lerp(HashValue<Hash>(p, ISet(row.HashY0Z0), x0), HashValue<Hash>(p, ISet(row.HashY0Z0), x1), xs);
+	FVec xf10 = Lerp(HashValue<Hash>(p, ISet(row.HashY1Z0), x0), HashValue<Hash>(p, ISet(row.HashY1Z0), x1), xs);
+	FVec xf01 = Lerp(HashValue<Hash>(p, ISet(row.HashY0Z1), x0), HashValue<Hash>(p, ISet(row.HashY0Z1), x1), xs);
+	FVec xf11 = Lerp(HashValue<Hash>(p, ISet(row.HashY1Z1), x0), HashValue<Hash>(p, ISet(row.HashY1Z1), x1), xs);
+
+	FVec yf0 = Lerp(xf00, xf10, row.YS);
+	FVec yf1 = Lerp(xf01, xf11, row.YS);
+
+	return Lerp(yf0, yf1, row.ZS);
+}
+
+template<EInterp Interp, ELatticeHash Hash>
+FN_FUNC FVec RowGradient(const FFastNoiseBatchParams& p, const FRowLattice2D& row, FVec x)
+{
+	IVec x0 = VFastFloor(x);
+	IVec x1 = IAdd(x0, ISet(1));
+	FVec xd0 = VSub(x, IToF(x0));
+	FVec xd1 = VSub(xd0, VSet(1.0f));
+	FVec xs = ApplyInterp<Interp>(xd0);
+
+	FVec xf0 = Lerp(Grad2D(HashGradIndex2D<Hash>(p, ISet(row.HashY0), x0), xd0, row.YD0), Grad2D(HashGradIndex2D<Hash>(p, ISet(row.HashY0), x1), xd1, row.YD0), xs);
+	FVec xf1 = Lerp(Grad2D(HashGradIndex2D<Hash>(p, ISet(row.HashY1), x0), xd0, row.YD1), Grad2D(HashGradIndex2D<Hash>(p, ISet(row.HashY1), x1), xd1, row.YD1), xs);
+
+	return Lerp(xf0, xf1, row.YS);
+}
+
+template<EInterp Interp, ELatticeHash Hash>
+FN_FUNC FVec RowGradient(const FFastNoiseBatchParams& p, const FRowLattice3D& row, FVec x)
+{
+	IVec x0 = VFastFloor(x);
+	IVec x1 = IAdd(x0, ISet(1));
+	FVec xd0 = VSub(x, IToF(x0));
+	FVec xd1 = VSub(xd0, VSet(1.0f));
+	FVec xs = ApplyInterp<Interp>(xd0);
+
+	FVec xf00 = Lerp(Grad3D(HashGradIndex3D<Hash>(p, ISet(row.HashY0Z0), x0), xd0, row.YD0, row.ZD0), Grad3D(HashGradIndex3D<Hash>(p, ISet(row.HashY0Z0), x1), xd1, row.YD0, row.ZD0), xs);
+	FVec xf10 = Lerp(Grad3D(HashGradIndex3D<Hash>(p, ISet(row.HashY1Z0), x0), xd0, row.YD1, row.ZD0), Grad3D(HashGradIndex3D<Hash>(p, ISet(row.HashY1Z0), x1), xd1, row.YD1, row.ZD0), xs);
+	FVec xf01 = Lerp(Grad3D(HashGradIndex3D<Hash>(p, ISet(row.HashY0Z1), x0), xd0, row.YD0, row.ZD1), Grad3D(HashGradIndex3D<Hash>(p, ISet(row.HashY0Z1), x1), xd1, row.YD0, row.ZD1), xs);
+	FVec xf11 = Lerp(Grad3D(HashGradIndex3D<Hash>(p, ISet(row.HashY1Z1), x0), xd0, row.YD1, row.ZD1), Grad3D(HashGradIndex3D<Hash>(p, ISet(row.HashY1Z1), x1), xd1, row.YD1, row.ZD1), xs);
+
+	FVec yf0 = Lerp(xf00, xf10, row.YS);
+	FVec yf1 = Lerp(xf01, xf11, row.YS);
+
+	return Lerp(yf0, yf1, row.ZS);
+}
+
+// Simplex cells are skewed, so nothing is shared along a row and it takes the plain path
+template<ENoiseType NoiseType, EInterp Interp, ELatticeHash Hash>
+FN_INLINE FVec RowNoise(const FFastNoiseBatchParams& p, const FRowLattice2D& row, int32 offset, FVec x, float y)
+{
+	switch (NoiseType)
+	{
+	case ENoiseType::Value:
+	case ENoiseType::ValueFractal:
+		return RowValue<Interp, Hash>(p, row, x);
+	case ENoiseType::Gradient:
+	case ENoiseType::GradientFractal:
+		return RowGradient<Interp, Hash>(p, row, x);
+	default:
+		return SingleSimplex<Hash>(p, ISet(offset), x, VSet(y));
+	}
+}
+
+template<ENoiseType NoiseType, EInterp Interp, ELatticeHash Hash>
+FN_INLINE FVec RowNoise(const FFastNoiseBatchParams& p, const FRowLattice3D& row, int32 offset, FVec x, float y, float z)
+{
+	switch (NoiseType)
+	{
+	case ENoiseType::Value:
+	case ENoiseType::ValueFractal:
+		return RowValue<Interp, Hash>(p, row, x);
+	case ENoiseType::Gradient:
+	case ENoiseType::GradientFractal:
+		return RowGradient<Interp, Hash>(p, row, x);
+	default:
+		return SingleSimplex<Hash>(p, ISet(offset), x, VSet(y), VSet(z));
+	}
+}
+
+// The x coordinates of the row from sample i, scaled by the frequency and the lacunarity of the octave
+FN_INLINE FVec RowX(const FFastNoiseBatchParams& p, float originX, float stepX, int32 i, int32 octave)
+{
+	FVec x = VMul(VAdd(VSet(originX), VMul(IToF(IAdd(ISet(i), ILaneIndex())), VSet(stepX))), VSet(p.Frequency));
+	for (int32 o = 0; o < octave; o++)
+	{
+		x = VMul(x, VSet(p.Lacunarity));
+	}
+	return x;
+}
+
+FN_INLINE FVec VLoadPartial(const float* in, int32 count)
+{
+	if (count == Lanes)
+	{
+		return VLoad(in);
+	}
+
+	float lanes[Lanes] = {};
+	for (int32 lane = 0; lane < count; lane++)
+	{
+		lanes[lane] = in[lane];
+	}
+	return VLoad(lanes);
+}
+
+FN_INLINE void VStorePartial(float* out, FVec v, int32 count)
+{
+	if (count == Lanes)
+	{
+		VStore(out, v);
+		return;
+	}
+
+	float lanes[Lanes];
+	VStore(lanes, v);
+	for (int32 lane = 0; lane < count; lane++)
+	{
+		out[lane] = lanes[lane];
+	}
+}
+
+// Adds an octave into the sums in out, the first octave initialises them
+template<ENoiseType NoiseType, EFractalType FractalType>
+FN_INLINE void AccumulateOctave(int32 octave, float amp, FVec noise, float* out, int32 count)
+{
+	if (!IsFractal(NoiseType))
+	{
+		VStorePartial(out, noise, count);
+	}
+	else if (octave == 0)
+	{
+		VStorePartial(out, OctaveValue<FractalType>(noise), count);
+	}
+	else
+	{
+		FVec sum = VLoadPartial(out, count);
+		FVec value = VMul(OctaveValue<FractalType>(noise), VSet(amp));
+		VStorePartial(out, FractalType == EFractalType::RigidMulti ? VSub(sum, value) : VAdd(sum, value), count);
+	}
+}
+
+template<ENoiseType NoiseType, EFractalType FractalType>
+FN_INLINE void FinishFractalRow(const FFastNoiseBatchParams& p, float* out, int32 n)
+{
+	if (IsFractal(NoiseType) && FractalType != EFractalType::RigidMulti)
+	{
+		for (int32 i = 0; i < n; i++)
+		{
+			out[i] *= p.FractalBounding;
+		}
+	}
+}
+
+template<ENoiseType NoiseType, EFractalType FractalType, EInterp Interp, ELatticeHash Hash>
+FN_FUNC void FillRow2D(const FFastNoiseBatchParams& p, float originX, float stepX, float y, float* out, int32 n)
+{
+	const bool bFractal = IsFractal(NoiseType);
+	const int32 octaves = bFractal ? p.Octaves : 1;
+
+	y *= p.Frequency;
+	float amp = 1.0f;
+
+	for (int32 octave = 0; octave < octaves; octave++)
+	{
+		if (octave > 0)
+		{
+			y *= p.Lacunarity;
+			amp *= p.Gain;
+			if (octave + 1 == octaves)
+			{
+				amp *= p.LastOctaveWeight;
+			}
+		}
+
+		const int32 offset = bFractal ? p.Perm[octave] : 0;
+		const FRowLattice2D row = MakeRowLattice<Interp, Hash>(p, offset, y);
+
+		for (int32 i = 0; i < n; i += Lanes)
+		{
+			FVec noise = RowNoise<NoiseType, Interp, Hash>(p, row, offset, RowX(p, originX, stepX, i, octave), y);
+			AccumulateOctave<NoiseType, FractalType>(octave, amp, noise, out + i, FMath::Min(Lanes, n - i));
+		}
+	}
+
+	FinishFractalRow<NoiseType, FractalType>(p, out, n);
+}
+
+template<ENoiseType NoiseType, EFractalType FractalType, EInterp Interp, ELatticeHash Hash>
+FN_FUNC void FillRow3D(const FFastNoiseBatchParams& p, float originX, float stepX, float y, float z, float* out, int32 n)
+{
+	const bool bFractal = IsFractal(NoiseType);
+	const int32 octaves = bFractal ? p.Octaves : 1;
+
+	y *= p.Frequency;
+	z *= p.Frequency;
+	float amp = 1.0f;
+
+	for (int32 octave = 0; octave < octaves; octave++)
+	{
+		if (octave > 0)
+		{
+			y *= p.Lacunarity;
+			z *= p.Lacunarity;
+			amp *= p.Gain;
+			if (octave + 1 == octaves)
+			{
+				amp *= p.LastOctaveWeight;
+			}
+		}
+
+		const int32 offset = bFractal ? p.Perm[octave] : 0;
+		const FRowLattice3D row = MakeRowLattice<Interp, Hash>(p, offset, y, z);
+
+		for (int32 i = 0; i < n; i += Lanes)
+		{
+			FVec noise = RowNoise<NoiseType, Interp, Hash>(p, row, offset, RowX(p, originX, stepX, i, octave), y, z);
+			AccumulateOctave<NoiseType, FractalType>(octave, amp, noise, out + i, FMath::Min(Lanes, n - i));
+		}
+	}
+
+	FinishFractalRow<NoiseType, FractalType>(p, out, n);
+}
+
+template<ENoiseType NoiseType, EFractalType FractalType, EInterp Interp, ELatticeHash Hash>
+FN_FUNC void FillGrid2D(const FFastNoiseBatchParams& p, float originX, float originY, float stepX, float stepY, int32 sizeX, int32 sizeY, float* out)
+{
+	for (int32 y = 0; y < sizeY; y++)
+	{
+		FillRow2D<NoiseType, FractalType, Interp, Hash>(p, originX, stepX, originY + y * stepY, out + y * sizeX, sizeX);
+	}
+}
+
+template<ENoiseType NoiseType, EFractalType FractalType, EInterp Interp, ELatticeHash Hash>
+FN_FUNC void FillGrid3D(const FFastNoiseBatchParams& p, float originX, float originY, float originZ, float stepX, float stepY, float stepZ, int32 sizeX, int32 sizeY, int32 sizeZ, float* out)
+{
+	for (int32 z = 0; z < sizeZ; z++)
+	{
+		for (int32 y = 0; y < sizeY; y++)
+		{
+			FillRow3D<NoiseType, FractalType, Interp, Hash>(p, originX, stepX, originY + y * stepY, originZ + z * stepZ, out + (z * sizeY + y) * sizeX, sizeX);
+		}
+	}
+}
+
+// Cellular has no lattice corners to share along a row, the row only saves working out y and z per sample
+template<ECellularDistanceFunction Distance, ELatticeHash Hash>
+FN_FUNC void FillCellularGrid2D(const FFastNoiseBatchParams& p, float originX, float originY, float stepX, float stepY, int32 sizeX, int32 sizeY, float* out)
+{
+	for (int32 y = 0; y < sizeY; y++)
+	{
+		const FVec rowY = VSet((originY + y * stepY) * p.Frequency);
+		for (int32 i = 0; i < sizeX; i += Lanes)
+		{
+			VStorePartial(out + y * sizeX + i, SingleCellular<Distance, Hash>(p, RowX(p, originX, stepX, i, 0), rowY), FMath::Min(Lanes, sizeX - i));
+		}
+	}
+}
+
+template<ECellularDistanceFunction Distance, ELatticeHash Hash>
+FN_FUNC void FillCellularGrid3D(const FFastNoiseBatchParams& p, float originX, float originY, float originZ, float stepX, float stepY, float stepZ, int32 sizeX, int32 sizeY, int32 sizeZ, float* out)
+{
+	for (int32 z = 0; z < sizeZ; z++)
+	{
+		const FVec rowZ = VSet((originZ + z * stepZ) * p.Frequency);
+		for (int32 y = 0; y < sizeY; y++)
+		{
+			const FVec rowY = VSet((originY + y * stepY) * p.Frequency);
+			float* row = out + (z * sizeY + y) * sizeX;
+			for (int32 i = 0; i < sizeX; i += Lanes)
+			{
+				VStorePartial(row + i, SingleCellular<Distance, Hash>(p, RowX(p, originX, stepX, i, 0), rowY, rowZ), FMath::Min(Lanes, sizeX - i));
+			}
+		}
+	}
+}
+
+// Position warp, matching FFastNoise::PositionWarp/PositionWarpFractal. Points are moved by the CELL_* offsets of
+// their lattice corners, interpolated like value noise. Warping is independent of the noise type, so it has its own
+// kernels that work on the coordinate arrays in place
+
+template<EInterp Interp, ELatticeHash Hash>
+FN_INLINE void SinglePositionWarp(const FFastNoiseBatchParams& p, IVec offset, float warpAmp, float frequency, FVec& x, FVec& y)
+{
+	FVec xf = VMul(x, VSet(frequency));
+	FVec yf = VMul(y, VSet(frequency));
+
+	IVec x0 = VFastFloor(xf);
+	IVec y0 = VFastFloor(yf);
+	IVec x1 = IAdd(x0, ISet(1));
+	IVec y1 = IAdd(y0, ISet(1));
+
+	FVec xs = ApplyInterp<Interp>(VSub(xf, IToF(x0)));
+	FVec ys = ApplyInterp<Interp>(VSub(yf, IToF(y0)));
+
+	IVec seed = HashStart<Hash>(p, offset);
+	IVec py0 = HashAxis<Hash>(p, seed, y0, FASTNOISE_HASH_PRIME_Y);
+	IVec py1 = HashAxis<Hash>(p, seed, y1, FASTNOISE_HASH_PRIME_Y);
+
+	IVec lutPos0 = HashIndex256<Hash>(p, py0, x0);
+	IVec lutPos1 = HashIndex256<Hash>(p, py0, x1);
+
+	FVec lx0x = Lerp(VGather(p.Cell2DX, lutPos0), VGather(p.Cell2DX, lutPos1), xs);
+	FVec ly0x = Lerp(VGather(p.Cell2DY, lutPos0), VGather(p.Cell2DY, lutPos1), xs);
+
+	lutPos0 = HashIndex256<Hash>(p, py1, x0);
+	lutPos1 = HashIndex256<Hash>(p, py1, x1);
+
+	FVec lx1x = Lerp(VGather(p.Cell2DX, lutPos0), VGather(p.Cell2DX, lutPos1), xs);
+	FVec ly1x = Lerp(VGather(p.Cell2DY, lutPos0), VGather(p.Cell2DY, lutPos1), xs);
+
+	x = VAdd(x, VMul(Lerp(lx0x, lx1x, ys), VSet(warpAmp)));
+	y = VAdd(y, VMul(Lerp(ly0x, ly1x, ys), VSet(warpAmp)));
+}
+
+template<EInterp Interp, ELatticeHash Hash>
+FN_INLINE void SinglePositionWarp(const FFastNoiseBatchParams& p, IVec offset, float warpAmp, float frequency, FVec& x, FVec& y, FVec& z)
+{
+	FVec xf = VMul(x, VSet(frequency));
+	FVec yf = VMul(y, VSet(frequency));
+	FVec zf = VMul(z, VSet(frequency));
+
+	IVec x0 = VFastFloor(xf);
+	IVec y0 = VFastFloor(yf);
+	IVec z0 = VFastFloor(zf);
+	IVec x1 = IAdd(x0, ISet(1));
+	IVec y1 = IAdd(y0, ISet(1));
+	IVec z1 = IAdd(z0, ISet(1));
+
+	FVec xs = ApplyInterp<Interp>(VSub(xf, IToF(x0)));
+	FVec ys = ApplyInterp<Interp>(VSub(yf, IToF(y0)));
+	FVec zs = ApplyInterp<Interp>(VSub(zf, IToF(z0)));
+
+	IVec seed = HashStart<Hash>(p, offset);
+	IVec pz0 = HashAxis<Hash>(p, seed, z0, FASTNOISE_HASH_PRIME_Z);
+	IVec pz1 = HashAxis<Hash>(p, seed, z1, FASTNOISE_HASH_PRIME_Z);
+	IVec py0z0 = HashAxis<Hash>(p, pz0, y0, FASTNOISE_HASH_PRIME_Y);
+	IVec py1z0 = HashAxis<Hash>(p, pz0, y1, FASTNOISE_HASH_PRIME_Y);
+	IVec py0z1 = HashAxis<Hash>(p, pz1, y0, FASTNOISE_HASH_PRIME_Y);
+	IVec py1z1 = HashAxis<Hash>(p, pz1, y1, FASTNOISE_HASH_PRIME_Y);
+
+	IVec lutPos0 = HashIndex256<Hash>(p, py0z0, x0);
+	IVec lutPos1 = HashIndex256<Hash>(p, py0z0, x1);
+
+	FVec lx0x = Lerp(VGather(p.Cell3DX, lutPos0), VGather(p.Cell3DX, lutPos1), xs);
+	FVec ly0x = Lerp(VGather(p.Cell3DY, lutPos0), VGather(p.Cell3DY, lutPos1), xs);
+	FVec lz0x = Lerp(VGather(p.Cell3DZ, lutPos0), VGather(p.Cell3DZ, lutPos1), xs);
+
+	lutPos0 = HashIndex256<Hash>(p, py1z0, x0);
+	lutPos1 = HashIndex256<Hash>(p, py1z0, x1);
+
+	FVec lx1x = Lerp(VGather(p.Cell3DX, lutPos0), VGather(p.Cell3DX, lutPos1), xs);
+	FVec ly1x = Lerp(VGather(p.Cell3DY, lutPos0), VGather(p.Cell3DY, lutPos1), xs);
+	FVec lz1x = Lerp(VGather(p.Cell3DZ, lutPos0), VGather(p.Cell3DZ, lutPos1), xs);
+
+	FVec lx0y = Lerp(lx0x, lx1x, ys);
+	FVec ly0y = Lerp(ly0x, ly1x, ys);
+	FVec lz0y = Lerp(lz0x, lz1x, ys);
+
+	lutPos0 = HashIndex256<Hash>(p, py0z1, x0);
+	lutPos1 = HashIndex256<Hash>(p, py0z1, x1);
+
+	lx0x = Lerp(VGather(p.Cell3DX, lutPos0), VGather(p.Cell3DX, lutPos1), xs);
+	ly0x = Lerp(VGather(p.Cell3DY, lutPos0), VGather(p.Cell3DY, lutPos1), xs);
+	lz0x = Lerp(VGather(p.Cell3DZ, lutPos0), VGather(p.Cell3DZ, lutPos1), xs);
+
+	lutPos0 = HashIndex256<Hash>(p, py1z1, x0);
+	lutPos1 = HashIndex256<Hash>(p, py1z1, x1);
+
+	lx1x = Lerp(VGather(p.Cell3DX, lutPos0), VGather(p.Cell3DX, lutPos1), xs);
+	ly1x = Lerp(VGather(p.Cell3DY, lutPos0), VGather(p.Cell3DY, lutPos1), xs);
+	lz1x = Lerp(VGather(p.Cell3DZ, lutPos0), VGather(p.Cell3DZ, lutPos1), xs);
+
+	x = VAdd(x, VMul(Lerp(lx0y, Lerp(lx0x, lx1x, ys), zs), VSet(warpAmp)));
+	y = VAdd(y, VMul(Lerp(ly0y, Lerp(ly0x, ly1x, ys), zs), VSet(warpAmp)));
+	z = VAdd(z, VMul(Lerp(lz0y, Lerp(lz0x, lz1x, ys), zs), VSet(warpAmp)));
+}
+
+// Regular warps once at the base frequency, Fractal warps once per octave with the offsets, frequencies and
+// amplitudes of a fractal. Warping always uses all WarpOctaves, the footprint cut off only applies to the noise
+template<EInterp Interp, ELatticeHash Hash>
+FN_INLINE void PositionWarp(const FFastNoiseBatchParams& p, FVec& x, FVec& y)
+{
+	if (p.PositionWarpType != EPositionWarpType::Fractal)
+	{
+		SinglePositionWarp<Interp, Hash>(p, ISet(0), p.PositionWarpAmp, p.Frequency, x, y);
+		return;
+	}
+
+	float amp = p.PositionWarpAmp * p.FractalBounding;
+	float freq = p.Frequency;
+	SinglePositionWarp<Interp, Hash>(p, ISet(p.Perm[0]), amp, freq, x, y);
+
+	for (int32 i = 1; i < p.WarpOctaves; i++)
+	{
+		freq *= p.Lacunarity;
+		amp *= p.Gain;
+		SinglePositionWarp<Interp, Hash>(p, ISet(p.Perm[i]), amp, freq, x, y);
+	}
+}
+
+template<EInterp Interp, ELatticeHash Hash>
+FN_INLINE void PositionWarp(const FFastNoiseBatchParams& p, FVec& x, FVec& y, FVec& z)
+{
+	if (p.PositionWarpType != EPositionWarpType::Fractal)
+	{
+		SinglePositionWarp<Interp, Hash>(p, ISet(0), p.PositionWarpAmp, p.Frequency, x, y, z);
+		return;
+	}
+
+	float amp = p.PositionWarpAmp * p.FractalBounding;
+	float freq = p.Frequency;
+	SinglePositionWarp<Interp, Hash>(p, ISet(p.Perm[0]), amp, freq, x, y, z);
+
+	for (int32 i = 1; i < p.WarpOctaves; i++)
+	{
+		freq *= p.Lacunarity;
+		amp *= p.Gain;
+		SinglePositionWarp<Interp, Hash>(p, ISet(p.Perm[i]), amp, freq, x, y, z);
+	}
+}
+
+template<EInterp Interp, ELatticeHash Hash>
+FN_FUNC void PositionWarp2D(const FFastNoiseBatchParams& p, float* x, float* y, int32 n)
+{
+	for (int32 i = 0; i < n; i += Lanes)
+	{
+		const int32 count = FMath::Min(Lanes, n - i);
+		FVec vx = VLoadPartial(x + i, count);
+		FVec vy = VLoadPartial(y + i, count);
+		PositionWarp<Interp, Hash>(p, vx, vy);
+		VStorePartial(x + i, vx, count);
+		VStorePartial(y + i, vy, count);
+	}
+}
+
+template<EInterp Interp, ELatticeHash Hash>
+FN_FUNC void PositionWarp3D(const FFastNoiseBatchParams& p, float* x, float* y, float* z, int32 n)
+{
+	for (int32 i = 0; i < n; i += Lanes)
+	{
+		const int32 count = FMath::Min(Lanes, n - i);
+		FVec vx = VLoadPartial(x + i, count);
+		FVec vy = VLoadPartial(y + i, count);
+		FVec vz = VLoadPartial(z + i, count);
+		PositionWarp<Interp, Hash>(p, vx, vy, vz);
+		VStorePartial(x + i, vx, count);
+		VStorePartial(y + i, vy, count);
+		VStorePartial(z + i, vz, count);
+	}
+}
+
+// Binding. Settings a noise type doesn't use are folded to one value, so they don't add identical instantiations
+
+static constexpr EFractalType UsedFractalType(ENoiseType noiseType, EFractalType fractalType)
+{
+	return IsFractal(noiseType) ? fractalType : EFractalType::FBM;
+}
+
+static constexpr EInterp UsedInterp(ENoiseType noiseType, EInterp interp)
+{
+	return noiseType == ENoiseType::Simplex || noiseType == ENoiseType::SimplexFractal ? EInterp::InterpLinear : interp;
+}
+
+template<ENoiseType NoiseType, EFractalType FractalType, EInterp Interp, ELatticeHash Hash>
+FN_INLINE void BindConfiguration(FFastNoiseBatchKernels& kernels)
+{
+	kernels.GetNoise2D = &GetNoise2D<&Noise<NoiseType, FractalType, Interp, Hash>>;
+	kernels.GetNoise3D = &GetNoise3D<&Noise<NoiseType, FractalType, Interp, Hash>>;
+	kernels.FillGrid2D = &FillGrid2D<NoiseType, FractalType, Interp, Hash>;
+	kernels.FillGrid3D = &FillGrid3D<NoiseType, FractalType, Interp, Hash>;
+}
+
+template<ENoiseType NoiseType, EFractalType FractalType, EInterp Interp>
+FN_INLINE void BindLatticeHash(FFastNoiseBatchKernels& kernels, ELatticeHash latticeHash)
+{
+	switch (latticeHash)
+	{
+	case ELatticeHash::Integer:
+		BindConfiguration<NoiseType, FractalType, Interp, ELatticeHash::Integer>(kernels);
+		return;
+	default:
+		BindConfiguration<NoiseType, FractalType, Interp, ELatticeHash::Permutation>(kernels);
+		return;
+	}
+}
+
+template<ENoiseType NoiseType, EFractalType FractalType>
+FN_INLINE void BindInterp(FFastNoiseBatchKernels& kernels, EInterp interp, ELatticeHash latticeHash)
+{
+	switch (interp)
+	{
+	case EInterp::InterpLinear:
+		BindLatticeHash<NoiseType, FractalType, UsedInterp(NoiseType, EInterp::InterpLinear)>(kernels, latticeHash);
+		return;
+	case EInterp::InterpHermite:
+		BindLatticeHash<NoiseType, FractalType, UsedInterp(NoiseType, EInterp::InterpHermite)>(kernels, latticeHash);
+		return;
+	default:
+		BindLatticeHash<NoiseType, FractalType, UsedInterp(NoiseType, EInterp::InterpQuintic)>(kernels, latticeHash);
+		return;
+	}
+}
+
+template<ENoiseType NoiseType>
+FN_INLINE void BindFractalType(FFastNoiseBatchKernels& kernels, EFractalType fractalType, EInterp interp, ELatticeHash latticeHash)
+{
+	switch (fractalType)
+	{
+	case EFractalType::Billow:
+		BindInterp<NoiseType, UsedFractalType(NoiseType, EFractalType::Billow)>(kernels, interp, latticeHash);
+		return;
+	case EFractalType::RigidMulti:
+		BindInterp<NoiseType, UsedFractalType(NoiseType, EFractalType::RigidMulti)>(kernels, interp, latticeHash);
+		return;
+	default:
+		BindInterp<NoiseType, UsedFractalType(NoiseType, EFractalType::FBM)>(kernels, interp, latticeHash);
+		return;
+	}
+}
+
+template<ECellularDistanceFunction Distance, ELatticeHash Hash>
+FN_INLINE void BindCellularConfiguration(FFastNoiseBatchKernels& kernels)
+{
+	kernels.GetNoise2D = &GetNoise2D<&CellularNoise<Distance, Hash>>;
+	kernels.GetNoise3D = &GetNoise3D<&CellularNoise<Distance, Hash>>;
+	kernels.FillGrid2D = &FillCellularGrid2D<Distance, Hash>;
+	kernels.FillGrid3D = &FillCellularGrid3D<Distance, Hash>;
+}
+
+// The return type is switched on once per vector rather than compiled in, it's cheap next to the search
+template<ECellularDistanceFunction Distance>
+FN_INLINE void BindCellularLatticeHash(FFastNoiseBatchKernels& kernels, ELatticeHash latticeHash)
+{
+	switch (latticeHash)
+	{
+	case ELatticeHash::Integer:
+		BindCellularConfiguration<Distance, ELatticeHash::Integer>(kernels);
+		return;
+	default:
+		BindCellularConfiguration<Distance, ELatticeHash::Permutation>(kernels);
+		return;
+	}
+}
+
+FN_INLINE void BindCellular(FFastNoiseBatchKernels& kernels, const FFastNoiseBatchParams& p)
+{
+	switch (p.CellularDistanceFunction)
+	{
+	case ECellularDistanceFunction::Manhattan:
+		BindCellularLatticeHash<ECellularDistanceFunction::Manhattan>(kernels, p.LatticeHash);
+		return;
+	case ECellularDistanceFunction::Natural:
+		BindCellularLatticeHash<ECellularDistanceFunction::Natural>(kernels, p.LatticeHash);
+		return;
+	default:
+		BindCellularLatticeHash<ECellularDistanceFunction::Euclidean>(kernels, p.LatticeHash);
+		return;
+	}
+}
+
+// Points kernels at the instantiation for the configuration in p, which has to be one the kernels implement
+FN_FUNC void BindKernels(FFastNoiseBatchKernels& kernels, const FFastNoiseBatchParams& p)
+{
+	switch (p.NoiseType)
+	{
+	case ENoiseType::Cellular:
+		BindCellular(kernels, p);
+		return;
+	case ENoiseType::Value:
+		BindFractalType<ENoiseType::Value>(kernels, p.FractalType, p.Interp, p.LatticeHash);
+		return;
+	case ENoiseType::ValueFractal:
+		BindFractalType<ENoiseType::ValueFractal>(kernels, p.FractalType, p.Interp, p.LatticeHash);
+		return;
+	case ENoiseType::Gradient:
+		BindFractalType<ENoiseType::Gradient>(kernels, p.FractalType, p.Interp, p.LatticeHash);
+		return;
+	case ENoiseType::GradientFractal:
+		BindFractalType<ENoiseType::GradientFractal>(kernels, p.FractalType, p.Interp, p.LatticeHash);
+		return;
+	case ENoiseType::Simplex:
+		BindFractalType<ENoiseType::Simplex>(kernels, p.FractalType, p.Interp, p.LatticeHash);
+		return;
+	default:
+		BindFractalType<ENoiseType::SimplexFractal>(kernels, p.FractalType, p.Interp, p.LatticeHash);
+		return;
+	}
+}
+
+template<ELatticeHash Hash>
+FN_INLINE void BindPositionWarpInterp(FFastNoiseBatchKernels& kernels, EInterp interp)
+{
+	switch (interp)
+	{
+	case EInterp::InterpLinear:
+		kernels.PositionWarp2D = &PositionWarp2D<EInterp::InterpLinear, Hash>;
+		kernels.PositionWarp3D = &PositionWarp3D<EInterp::InterpLinear, Hash>;
+		return;
+	case EInterp::InterpHermite:
+		kernels.PositionWarp2D = &PositionWarp2D<EInterp::InterpHermite, Hash>;
+		kernels.PositionWarp3D = &PositionWarp3D<EInterp::InterpHermite, Hash>;
+		return;
+	default:
+		kernels.PositionWarp2D = &PositionWarp2D<EInterp::InterpQuintic, Hash>;
+		kernels.PositionWarp3D = &PositionWarp3D<EInterp::InterpQuintic, Hash>;
+		return;
+	}
+}
+
+// The warp kernels for the interpolation and lattice hash in p, whatever the noise type
+FN_FUNC void BindPositionWarp(FFastNoiseBatchKernels& kernels, const FFastNoiseBatchParams& p)
+{
+	switch (p.LatticeHash)
+	{
+	case ELatticeHash::Integer:
+		BindPositionWarpInterp<ELatticeHash::Integer>(kernels, p.Interp);
+		return;
+	default:
+		BindPositionWarpInterp<ELatticeHash::Permutation>(kernels, p.Interp);
+		return;
+	}
+}
@@ -0,0 +1,46 @@
+// FastNoisePermutation.cpp
+//
+
+#include "FastNoisePermutation.h"
+
+#include <random>
+
+FFastNoisePermutation::FFastNoisePermutation(int seed)
+{
+	std::mt19937 gen(seed);
+
+	for (int i = 0; i < 256; i++)
+		Perm[i] = i;
+
+	for (int j = 0; j < 256; j++)
+	{
+		std::uniform_int_distribution<> dis(0, 256 - j);
+		int k = dis(gen) + j;
+		int l = Perm[j];
+		Perm[j] = Perm[j + 256] = Perm[k];
+		Perm[k] = l;
+		Perm12[j] = Perm12[j + 256] = Perm[j] % 12;
+	}
+
+	for (int i = 0; i < 512; i++)
+	{
+		PermBatch[i] = Perm[i];
+		Perm12Batch[i] = Perm12[i];
+	}
+}
+
+FFastNoisePermutationCache& FFastNoisePermutationCache::Get()
+{
+	static FFastNoisePermutationCache Instance;
+	return Instance;
+}
+
+FFastNoisePermutationPtr FFastNoisePermutationCache::FindOrCreate(int seed)
+{
+	return Tables.FindOrCreate(seed, [seed]() { return FFastNoisePermutationPtr(MakeShareable(new FFastNoisePermutation(seed))); });
+}
+
+int32 FFastNoisePermutationCache::Num()
+{
+	return Tables.Num();
+}
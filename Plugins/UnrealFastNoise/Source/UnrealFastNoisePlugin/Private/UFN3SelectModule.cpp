@@ -1,5 +1,7 @@
 #include "UFN3SelectModule.h"
 #include "UFNNoiseGenerator.h"
+#include "UFNNoiseProgram.h"
+#include "UFNNoiseProfiler.h"
 
 
 UUFN3SelectModule::UUFN3SelectModule(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
@@ -9,6 +11,7 @@ UUFN3SelectModule::UUFN3SelectModule(const FObjectInitializer& ObjectInitializer
 
 float UUFN3SelectModule::GetNoise3D(float aX, float aY, float aZ)
 {
+	UFN_NOISE_PROFILE_SCOPE(this);
 	if (!(inputModule1 && inputModule2 && inputModule3 && selectModule)) {
 		return 0.0f;
 	}
@@ -32,6 +35,7 @@ float UUFN3SelectModule::GetNoise3D(float aX, float aY, float aZ)
 
 float UUFN3SelectModule::GetNoise2D(float aX, float aY)
 {
+	UFN_NOISE_PROFILE_SCOPE(this);
 	if (!(inputModule1 && inputModule2 && inputModule3 && selectModule)) {
 		return 0.0f;
 	}
@@ -53,3 +57,30 @@ float UUFN3SelectModule::GetNoise2D(float aX, float aY)
 
 }
 
+int32 UUFN3SelectModule::CompileNoise(FUFNNoiseCompiler& compiler, const FUFNNoiseCoordinates& coords)
+{
+	if (!(inputModule1 && inputModule2 && inputModule3 && selectModule)) {
+		return compiler.Constant(0.0f);
+	}
+
+	int32 control = compiler.Compile(selectModule, coords);
+	return compiler.Select3(compiler.Compile(inputModule1, coords), compiler.Compile(inputModule2, coords), compiler.Compile(inputModule3, coords), control, upperThreshold, lowerThreshold);
+}
+
+FFloatInterval UUFN3SelectModule::GetNoiseBounds2D(const FBox2D& region)
+{
+	if (!(inputModule1 && inputModule2 && inputModule3 && selectModule)) {
+		return FUFNNoiseBounds::Point(0.0f);
+	}
+
+	return FUFNNoiseBounds::Select3(inputModule1->GetNoiseBounds2D(region), inputModule2->GetNoiseBounds2D(region), inputModule3->GetNoiseBounds2D(region), selectModule->GetNoiseBounds2D(region), upperThreshold, lowerThreshold);
+}
+
+FFloatInterval UUFN3SelectModule::GetNoiseBounds3D(const FBox& region)
+{
+	if (!(inputModule1 && inputModule2 && inputModule3 && selectModule)) {
+		return FUFNNoiseBounds::Point(0.0f);
+	}
+
+	return FUFNNoiseBounds::Select3(inputModule1->GetNoiseBounds3D(region), inputModule2->GetNoiseBounds3D(region), inputModule3->GetNoiseBounds3D(region), selectModule->GetNoiseBounds3D(region), upperThreshold, lowerThreshold);
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "UFNAddModule.h"
 #include "UFNNoiseGenerator.h"
+#include "UFNNoiseProgram.h"
+#include "UFNNoiseProfiler.h"
 
 
 UUFNAddModule::UUFNAddModule(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
@@ -9,6 +11,7 @@ UUFNAddModule::UUFNAddModule(const FObjectInitializer& ObjectInitializer) : Supe
 
 float UUFNAddModule::GetNoise3D(float aX, float aY, float aZ)
 {
+	UFN_NOISE_PROFILE_SCOPE(this);
 
 	if (!(inputModule1 || inputModule2)) {
 		return 0.0f;
@@ -38,3 +41,53 @@ float UUFNAddModule::GetNoise2D(float aX, float aY)
 	return GetNoise3D(aX, aY, 0.0f);
 }
 
+int32 UUFNAddModule::CompileNoise(FUFNNoiseCompiler& compiler, const FUFNNoiseCoordinates& coords)
+{
+	if (!(inputModule1 || inputModule2)) {
+		return compiler.Constant(0.0f);
+	}
+
+	// GetNoise3D reads whichever input is missing, leave that to it
+	if (!(inputModule1 && inputModule2)) {
+		return Super::CompileNoise(compiler, coords);
+	}
+
+	// GetNoise2D samples the inputs in 3D at z = 0
+	FUFNNoiseCoordinates coords3D = coords.Is2D() ? FUFNNoiseCoordinates(coords.X, coords.Y, compiler.Constant(0.0f)) : coords;
+
+	int32 input1 = compiler.Compile(inputModule1, coords3D);
+	int32 input2 = compiler.Compile(inputModule2, coords3D);
+	if (maskModule)
+	{
+		// The mask's proven bounds wherever it is sampled, one that can never reach the threshold drops the sum altogether
+		const FFloatInterval maskBounds = maskModule->GetNoiseBounds3D(FUFNNoiseBounds::UnboundedRegion());
+		return compiler.MaskedAdd(input1, input2, compiler.Compile(maskModule, coords3D), threshold, maskBounds);
+	}
+
+	return compiler.Add(input1, input2);
+}
+
+FFloatInterval UUFNAddModule::GetNoiseBounds2D(const FBox2D& region)
+{
+	return GetNoiseBounds3D(FBox(FVector(region.Min, 0.0f), FVector(region.Max, 0.0f)));
+}
+
+FFloatInterval UUFNAddModule::GetNoiseBounds3D(const FBox& region)
+{
+	if (!(inputModule1 || inputModule2)) {
+		return FUFNNoiseBounds::Point(0.0f);
+	}
+
+	if (!(inputModule1 && inputModule2)) {
+		return FUFNNoiseBounds::Unbounded();
+	}
+
+	FFloatInterval input1 = inputModule1->GetNoiseBounds3D(region);
+	FFloatInterval input2 = inputModule2->GetNoiseBounds3D(region);
+	if (maskModule)
+	{
+		return FUFNNoiseBounds::MaskedAdd(input1, input2, maskModule->GetNoiseBounds3D(region), threshold);
+	}
+
+	return FUFNNoiseBounds::Add(input1, input2);
+}
\ No newline at end of file
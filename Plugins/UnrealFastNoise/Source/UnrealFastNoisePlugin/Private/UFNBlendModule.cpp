@@ -1,5 +1,7 @@
 #include "UFNBlendModule.h"
 #include "UFNNoiseGenerator.h"
+#include "UFNNoiseProgram.h"
+#include "UFNNoiseProfiler.h"
 
 
 UUFNBlendModule::UUFNBlendModule(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
@@ -9,6 +11,7 @@ UUFNBlendModule::UUFNBlendModule(const FObjectInitializer& ObjectInitializer) :
 
 float UUFNBlendModule::GetNoise3D(float aX, float aY, float aZ)
 {
+	UFN_NOISE_PROFILE_SCOPE(this);
 
 	if (!(inputModule1 && inputModule2 && selectModule)) {
 		return 0.0f;
@@ -26,6 +29,7 @@ float UUFNBlendModule::GetNoise3D(float aX, float aY, float aZ)
 
 float UUFNBlendModule::GetNoise2D(float aX, float aY)
 {
+	UFN_NOISE_PROFILE_SCOPE(this);
 	if (!(inputModule1 && inputModule2 && selectModule)) {
 		return 0.0f;
 	}
@@ -40,3 +44,30 @@ float UUFNBlendModule::GetNoise2D(float aX, float aY)
 	return FMath::Lerp(inputModule1->GetNoise2D(aX, aY), inputModule2->GetNoise2D(aX, aY), control);
 }
 
+int32 UUFNBlendModule::CompileNoise(FUFNNoiseCompiler& compiler, const FUFNNoiseCoordinates& coords)
+{
+	if (!(inputModule1 && inputModule2 && selectModule)) {
+		return compiler.Constant(0.0f);
+	}
+
+	int32 control = compiler.Compile(selectModule, coords);
+	return compiler.Blend(compiler.Compile(inputModule1, coords), compiler.Compile(inputModule2, coords), control, blendCurve);
+}
+
+FFloatInterval UUFNBlendModule::GetNoiseBounds2D(const FBox2D& region)
+{
+	if (!(inputModule1 && inputModule2 && selectModule)) {
+		return FUFNNoiseBounds::Point(0.0f);
+	}
+
+	return FUFNNoiseBounds::Blend(inputModule1->GetNoiseBounds2D(region), inputModule2->GetNoiseBounds2D(region), selectModule->GetNoiseBounds2D(region), blendCurve);
+}
+
+FFloatInterval UUFNBlendModule::GetNoiseBounds3D(const FBox& region)
+{
+	if (!(inputModule1 && inputModule2 && selectModule)) {
+		return FUFNNoiseBounds::Point(0.0f);
+	}
+
+	return FUFNNoiseBounds::Blend(inputModule1->GetNoiseBounds3D(region), inputModule2->GetNoiseBounds3D(region), selectModule->GetNoiseBounds3D(region), blendCurve);
+}
\ No newline at end of file
@@ -226,6 +226,7 @@ UUFNNoiseGenerator* UUFNBlueprintFunctionLibrary::CreateSplineGenerator(UObject*
 	newSplineGenerator->MinimumDistance = MinDistance;
 	newSplineGenerator->Splines = Splines;
 	newSplineGenerator->FalloffCurve = falloffCurve;
+	newSplineGenerator->RebuildSplineIndex();
 
 	return newSplineGenerator;
 }
@@ -1,5 +1,7 @@
 #include "UFNConstantModule.h"
 #include "UFNNoiseGenerator.h"
+#include "UFNNoiseProgram.h"
+#include "UFNNoiseProfiler.h"
 
 
 UUFNConstantModule::UUFNConstantModule(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
@@ -9,11 +11,27 @@ UUFNConstantModule::UUFNConstantModule(const FObjectInitializer& ObjectInitializ
 
 float UUFNConstantModule::GetNoise3D(float aX, float aY, float aZ)
 {
+	UFN_NOISE_PROFILE_SCOPE(this);
 	return constantValue;
 }
 
 float UUFNConstantModule::GetNoise2D(float aX, float aY)
 {
+	UFN_NOISE_PROFILE_SCOPE(this);
 	return constantValue;
 }
 
+int32 UUFNConstantModule::CompileNoise(FUFNNoiseCompiler& compiler, const FUFNNoiseCoordinates& coords)
+{
+	return compiler.Constant(constantValue);
+}
+
+FFloatInterval UUFNConstantModule::GetNoiseBounds2D(const FBox2D& region)
+{
+	return FUFNNoiseBounds::Point(constantValue);
+}
+
+FFloatInterval UUFNConstantModule::GetNoiseBounds3D(const FBox& region)
+{
+	return FUFNNoiseBounds::Point(constantValue);
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "UFNNoiseGenerator.h"
+#include "UFNNoiseProgram.h"
 
 
 UUFNNoiseGenerator::UUFNNoiseGenerator(const class FObjectInitializer& ObjectInitializer)
@@ -15,4 +16,19 @@ float UUFNNoiseGenerator::GetNoise2D(float aX, float aY)
 float UUFNNoiseGenerator::GetNoise3D(float aX, float aY, float aZ)
 {
 	return -2.0f;
+}
+
+int32 UUFNNoiseGenerator::CompileNoise(FUFNNoiseCompiler& compiler, const FUFNNoiseCoordinates& coords)
+{
+	return compiler.Generator(this, coords);
+}
+
+FFloatInterval UUFNNoiseGenerator::GetNoiseBounds2D(const FBox2D& region)
+{
+	return FUFNNoiseBounds::Unbounded();
+}
+
+FFloatInterval UUFNNoiseGenerator::GetNoiseBounds3D(const FBox& region)
+{
+	return FUFNNoiseBounds::Unbounded();
 }
\ No newline at end of file
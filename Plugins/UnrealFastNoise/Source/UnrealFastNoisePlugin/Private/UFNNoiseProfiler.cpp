@@ -0,0 +1,339 @@
+#include "UFNNoiseProfiler.h"
+
+#if UFN_NOISE_PROFILING
+
+#include "UFNNoiseGenerator.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogUFNNoiseProfiler, Log, All);
+
+int32 FUFNNoiseProfiler::Enabled = 0;
+
+namespace UFNNoiseProfiler
+{
+	struct FEntry
+	{
+		// Only compared once recorded, names are taken while the node is known to be alive
+		UUFNNoiseGenerator* Generator;
+		FString Name;
+		FString Class;
+		int32 Parent;
+		TArray<int32> Children;
+		int64 Calls;
+		uint64 InclusiveCycles;
+		uint64 ExclusiveCycles;
+	};
+
+	// The call tree of one thread, entry 0 is the root every outermost call is entered from
+	struct FThreadProfile
+	{
+		// Held by the thread while it adds or clears entries and by merging while it reads them, counts are added without it
+		FCriticalSection Lock;
+		TArray<FEntry> Entries;
+		int32 Generation;
+		FUFNNoiseProfileScope* Scope;
+		int32 Current;
+
+		void Clear(int32 InGeneration)
+		{
+			FScopeLock EntriesLock(&Lock);
+			Entries.Reset();
+			Entries.AddDefaulted();
+			Entries[0].Generator = nullptr;
+			Entries[0].Parent = INDEX_NONE;
+			Entries[0].Calls = 0;
+			Entries[0].InclusiveCycles = 0;
+			Entries[0].ExclusiveCycles = 0;
+			Generation = InGeneration;
+			Scope = nullptr;
+			Current = 0;
+		}
+
+		int32 FindOrAddChild(int32 Parent, UUFNNoiseGenerator* Generator)
+		{
+			for (int32 Child : Entries[Parent].Children)
+			{
+				if (Entries[Child].Generator == Generator)
+				{
+					return Child;
+				}
+			}
+
+			FScopeLock EntriesLock(&Lock);
+			const int32 Child = Entries.AddDefaulted();
+			FEntry& Entry = Entries[Child];
+			Entry.Generator = Generator;
+			Entry.Name = Generator ? Generator->GetName() : TEXT("None");
+			Entry.Class = Generator ? Generator->GetClass()->GetName() : TEXT("None");
+			Entry.Parent = Parent;
+			Entry.Calls = 0;
+			Entry.InclusiveCycles = 0;
+			Entry.ExclusiveCycles = 0;
+			Entries[Parent].Children.Add(Child);
+			return Child;
+		}
+	};
+
+	// Every thread's tree lives until shutdown, Reset bumps the generation and each thread clears its own
+	FCriticalSection ThreadProfilesLock;
+	TArray<TUniquePtr<FThreadProfile>> ThreadProfiles;
+	FThreadSafeCounter Generation;
+
+	thread_local FThreadProfile* ThreadProfile = nullptr;
+
+	FThreadProfile& GetThreadProfile()
+	{
+		if (!ThreadProfile)
+		{
+			TUniquePtr<FThreadProfile> Profile(new FThreadProfile);
+			Profile->Clear(Generation.GetValue());
+			ThreadProfile = Profile.Get();
+
+			FScopeLock Lock(&ThreadProfilesLock);
+			ThreadProfiles.Add(MoveTemp(Profile));
+		}
+		return *ThreadProfile;
+	}
+
+	// The trees of all threads merged by node path
+	struct FMergedEntry
+	{
+		UUFNNoiseGenerator* Generator;
+		FString Name;
+		FString Class;
+		int64 Calls;
+		uint64 InclusiveCycles;
+		uint64 ExclusiveCycles;
+		TArray<FMergedEntry> Children;
+	};
+
+	void Merge(FMergedEntry& Into, const FThreadProfile& Profile, int32 Entry)
+	{
+		for (int32 Child : Profile.Entries[Entry].Children)
+		{
+			const FEntry& Source = Profile.Entries[Child];
+			FMergedEntry* Target = Into.Children.FindByPredicate([&](const FMergedEntry& Merged) { return Merged.Generator == Source.Generator; });
+			if (!Target)
+			{
+				Target = &Into.Children[Into.Children.AddDefaulted()];
+				Target->Generator = Source.Generator;
+				Target->Name = Source.Name;
+				Target->Class = Source.Class;
+				Target->Calls = 0;
+				Target->InclusiveCycles = 0;
+				Target->ExclusiveCycles = 0;
+			}
+
+			Target->Calls += Source.Calls;
+			Target->InclusiveCycles += Source.InclusiveCycles;
+			Target->ExclusiveCycles += Source.ExclusiveCycles;
+			Merge(*Target, Profile, Child);
+		}
+	}
+
+	void Sort(FMergedEntry& Entry)
+	{
+		Entry.Children.Sort([](const FMergedEntry& A, const FMergedEntry& B) { return A.InclusiveCycles > B.InclusiveCycles; });
+		for (FMergedEntry& Child : Entry.Children)
+		{
+			Sort(Child);
+		}
+	}
+
+	FMergedEntry GetMergedProfile()
+	{
+		FMergedEntry Root;
+		Root.Generator = nullptr;
+		Root.Calls = 0;
+		Root.InclusiveCycles = 0;
+		Root.ExclusiveCycles = 0;
+
+		const int32 CurrentGeneration = Generation.GetValue();
+		FScopeLock Lock(&ThreadProfilesLock);
+		for (const TUniquePtr<FThreadProfile>& Profile : ThreadProfiles)
+		{
+			// A thread that has not evaluated anything since the last reset still holds the previous results
+			FScopeLock EntriesLock(&Profile->Lock);
+			if (Profile->Generation == CurrentGeneration)
+			{
+				Merge(Root, *Profile, 0);
+			}
+		}
+
+		for (const FMergedEntry& Child : Root.Children)
+		{
+			Root.Calls += Child.Calls;
+			Root.InclusiveCycles += Child.InclusiveCycles;
+		}
+		Sort(Root);
+		return Root;
+	}
+
+	double ToMilliseconds(uint64 Cycles)
+	{
+		return Cycles * FPlatformTime::GetSecondsPerCycle64() * 1000.0;
+	}
+
+	void DumpEntry(const FMergedEntry& Entry, int32 Depth)
+	{
+		UE_LOG(LogUFNNoiseProfiler, Display, TEXT("%12.3f %12.3f %12lld  %s%s (%s)"), ToMilliseconds(Entry.InclusiveCycles), ToMilliseconds(Entry.ExclusiveCycles), Entry.Calls,
+			*FString::ChrN(Depth * 2, TEXT(' ')), *Entry.Name, *Entry.Class);
+		for (const FMergedEntry& Child : Entry.Children)
+		{
+			DumpEntry(Child, Depth + 1);
+		}
+	}
+
+	TSharedPtr<FJsonObject> EntryToJson(const FMergedEntry& Entry)
+	{
+		TSharedPtr<FJsonObject> Json = MakeShareable(new FJsonObject);
+		Json->SetStringField(TEXT("name"), Entry.Name);
+		Json->SetStringField(TEXT("class"), Entry.Class);
+		Json->SetNumberField(TEXT("calls"), Entry.Calls);
+		Json->SetNumberField(TEXT("inclusiveMs"), ToMilliseconds(Entry.InclusiveCycles));
+		Json->SetNumberField(TEXT("exclusiveMs"), ToMilliseconds(Entry.ExclusiveCycles));
+
+		TArray<TSharedPtr<FJsonValue>> Children;
+		for (const FMergedEntry& Child : Entry.Children)
+		{
+			Children.Add(MakeShareable(new FJsonValueObject(EntryToJson(Child))));
+		}
+		Json->SetArrayField(TEXT("children"), Children);
+		return Json;
+	}
+
+	void ExportCommand(const TArray<FString>& Args)
+	{
+		const FString Path = Args.Num() > 0 ? Args[0] : FPaths::ProfilingDir() / TEXT("UFNNoiseProfile.json");
+		if (FUFNNoiseProfiler::Export(Path))
+		{
+			UE_LOG(LogUFNNoiseProfiler, Display, TEXT("Wrote noise profile to %s"), *Path);
+		}
+		else
+		{
+			UE_LOG(LogUFNNoiseProfiler, Error, TEXT("Failed to write noise profile to %s"), *Path);
+		}
+	}
+
+	FAutoConsoleVariableRef CVarProfile(
+		TEXT("ufn.Profile"),
+		FUFNNoiseProfiler::Enabled,
+		TEXT("Records time and calls per node of noise graph evaluation, read with ufn.Profile.Dump or ufn.Profile.Export.\n")
+		TEXT("0: off (default)\n")
+		TEXT("1: on"));
+
+	FAutoConsoleCommand DumpCommand(
+		TEXT("ufn.Profile.Dump"),
+		TEXT("Logs the noise graph profile as a tree of inclusive ms, exclusive ms and calls per node."),
+		FConsoleCommandDelegate::CreateStatic(&FUFNNoiseProfiler::Dump));
+
+	FAutoConsoleCommand ResetCommand(
+		TEXT("ufn.Profile.Reset"),
+		TEXT("Clears the noise graph profile."),
+		FConsoleCommandDelegate::CreateStatic(&FUFNNoiseProfiler::Reset));
+
+	FAutoConsoleCommand ExportJsonCommand(
+		TEXT("ufn.Profile.Export"),
+		TEXT("Writes the noise graph profile as JSON, to the path given or Saved/Profiling/UFNNoiseProfile.json."),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&ExportCommand));
+}
+
+void FUFNNoiseProfiler::Begin(FUFNNoiseProfileScope& Scope, UUFNNoiseGenerator* const* Path, int32 PathLength)
+{
+	using namespace UFNNoiseProfiler;
+
+	FThreadProfile& Profile = GetThreadProfile();
+	if (!Profile.Scope && Profile.Generation != Generation.GetValue())
+	{
+		Profile.Clear(Generation.GetValue());
+	}
+
+	Scope.ParentEntry = Profile.Current;
+	Scope.Entry = Profile.Current;
+	for (int32 Index = 0; Index < PathLength; Index++)
+	{
+		Scope.Entry = Profile.FindOrAddChild(Scope.Entry, Path[Index]);
+	}
+	Scope.Parent = Profile.Scope;
+	Scope.ChildCycles = 0;
+
+	Profile.Scope = &Scope;
+	Profile.Current = Scope.Entry;
+	Scope.StartCycles = FPlatformTime::Cycles64();
+}
+
+void FUFNNoiseProfiler::End(FUFNNoiseProfileScope& Scope)
+{
+	using namespace UFNNoiseProfiler;
+
+	const uint64 Cycles = FPlatformTime::Cycles64() - Scope.StartCycles;
+	FThreadProfile& Profile = *ThreadProfile;
+
+	// A path entered in one go has no scopes of its own for the nodes above the last, they include its time here
+	if (Scope.Entry != Scope.ParentEntry)
+	{
+		FEntry& Entry = Profile.Entries[Scope.Entry];
+		Entry.Calls += Scope.Calls;
+		Entry.ExclusiveCycles += Cycles - FMath::Min(Scope.ChildCycles, Cycles);
+		for (int32 Index = Scope.Entry; Index != Scope.ParentEntry; Index = Profile.Entries[Index].Parent)
+		{
+			Profile.Entries[Index].InclusiveCycles += Cycles;
+		}
+	}
+
+	if (Scope.Parent)
+	{
+		Scope.Parent->ChildCycles += Cycles;
+	}
+	Profile.Scope = Scope.Parent;
+	Profile.Current = Scope.ParentEntry;
+}
+
+void FUFNNoiseProfiler::Reset()
+{
+	UFNNoiseProfiler::Generation.Increment();
+}
+
+void FUFNNoiseProfiler::Dump()
+{
+	using namespace UFNNoiseProfiler;
+
+	const FMergedEntry Root = GetMergedProfile();
+	UE_LOG(LogUFNNoiseProfiler, Display, TEXT("Noise profile, %.3f ms in %lld outermost calls%s"), ToMilliseconds(Root.InclusiveCycles), Root.Calls,
+		IsEnabled() ? TEXT("") : TEXT(", ufn.Profile is off"));
+	UE_LOG(LogUFNNoiseProfiler, Display, TEXT("%12s %12s %12s  %s"), TEXT("Incl ms"), TEXT("Excl ms"), TEXT("Calls"), TEXT("Node"));
+	for (const FMergedEntry& Child : Root.Children)
+	{
+		DumpEntry(Child, 0);
+	}
+}
+
+TSharedRef<FJsonObject> FUFNNoiseProfiler::ToJson()
+{
+	using namespace UFNNoiseProfiler;
+
+	const FMergedEntry Root = GetMergedProfile();
+	TSharedPtr<FJsonObject> Json = EntryToJson(Root);
+	Json->RemoveField(TEXT("name"));
+	Json->RemoveField(TEXT("class"));
+	Json->RemoveField(TEXT("exclusiveMs"));
+	return Json.ToSharedRef();
+}
+
+bool FUFNNoiseProfiler::Export(const FString& Path)
+{
+	FString Text;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Text);
+	FJsonSerializer::Serialize(ToJson(), Writer);
+	return FFileHelper::SaveStringToFile(Text, *Path);
+}
+
+#endif
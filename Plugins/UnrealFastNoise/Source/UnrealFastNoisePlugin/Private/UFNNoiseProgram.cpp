@@ -0,0 +1,1689 @@
+#include "UFNNoiseProgram.h"
+#include "UFNNoiseGenerator.h"
+#include "UFNNoiseProfiler.h"
+#include "Curves/CurveFloat.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogUFNNoiseProgram, Log, All);
+
+// FMath's interpolations are templates, wrap them so instructions can point at them
+static float InterpCircularIn(float A, float B, float Alpha, int32 Steps) { return FMath::InterpCircularIn(A, B, Alpha); }
+static float InterpCircularOut(float A, float B, float Alpha, int32 Steps) { return FMath::InterpCircularOut(A, B, Alpha); }
+static float InterpCircularInOut(float A, float B, float Alpha, int32 Steps) { return FMath::InterpCircularInOut(A, B, Alpha); }
+static float InterpExpoIn(float A, float B, float Alpha, int32 Steps) { return FMath::InterpExpoIn(A, B, Alpha); }
+static float InterpExpoOut(float A, float B, float Alpha, int32 Steps) { return FMath::InterpExpoOut(A, B, Alpha); }
+static float InterpExpoInOut(float A, float B, float Alpha, int32 Steps) { return FMath::InterpExpoInOut(A, B, Alpha); }
+static float InterpSinIn(float A, float B, float Alpha, int32 Steps) { return FMath::InterpSinIn(A, B, Alpha); }
+static float InterpSinOut(float A, float B, float Alpha, int32 Steps) { return FMath::InterpSinOut(A, B, Alpha); }
+static float InterpSinInOut(float A, float B, float Alpha, int32 Steps) { return FMath::InterpSinInOut(A, B, Alpha); }
+static float InterpStep(float A, float B, float Alpha, int32 Steps) { return FMath::InterpStep(A, B, Alpha, Steps); }
+static float InterpLinear(float A, float B, float Alpha, int32 Steps) { return FMath::Lerp(A, B, Alpha); }
+
+struct FUFNNoiseProgram::FBlock
+{
+	float* Registers;
+	int32 Count;
+	// From the block's bounds, null to evaluate everything
+	const bool* Run;
+	const EUFNNoiseBranch* Branches;
+	// BlockSize points per scope, scope 0 holding every point in order. Counts are INDEX_NONE until a scope is entered
+	int32* Lanes;
+	int32* LaneCounts;
+	// Gathered arguments and result of a compacted instruction
+	float* Scratch;
+	FUFNNoiseEvaluationStats* Stats;
+
+	FBlock(float* InRegisters, int32 InCount)
+		: Registers(InRegisters), Count(InCount), Run(nullptr), Branches(nullptr), Lanes(nullptr), LaneCounts(nullptr), Scratch(nullptr), Stats(nullptr)
+	{
+	}
+};
+
+// The argument holding a select's control, and those only read for some of its points
+static int32 GetControlArg(EUFNNoiseOp Op)
+{
+	return Op == EUFNNoiseOp::Select3 ? 3 : 2;
+}
+
+static bool IsBranchArg(EUFNNoiseOp Op, int32 Arg)
+{
+	switch (Op)
+	{
+	case EUFNNoiseOp::Select:
+	case EUFNNoiseOp::SelectInterp:
+	case EUFNNoiseOp::RadialInterp:
+		return Arg == 0 || Arg == 1;
+	case EUFNNoiseOp::Select3:
+		return Arg <= 2;
+	case EUFNNoiseOp::MaskedAdd:
+	case EUFNNoiseOp::Blend:
+		return Arg == 1;
+	default:
+		return false;
+	}
+}
+
+// Whether a select going the same way for the whole block reads an argument
+static bool IsBranchRead(EUFNNoiseOp Op, EUFNNoiseBranch Branch, int32 Arg)
+{
+	if (Branch == EUFNNoiseBranch::Falloff)
+	{
+		return Arg == 0 || Arg == 1;
+	}
+	if (Op == EUFNNoiseOp::MaskedAdd)
+	{
+		return Branch == EUFNNoiseBranch::Second;
+	}
+	return Arg == (int32)Branch - (int32)EUFNNoiseBranch::First;
+}
+
+// Worth evaluating on a scope's points alone rather than the whole block
+static bool IsCompacted(const FUFNNoiseInstruction& Instruction)
+{
+	return Instruction.IsLeaf() || Instruction.Op == EUFNNoiseOp::SelectInterp || Instruction.Op == EUFNNoiseOp::RadialInterp ||
+		(Instruction.Op == EUFNNoiseOp::BlendAlpha && Instruction.Curve);
+}
+
+// The parent's points whose control passes, without branching per point
+template<typename PredicateType>
+static int32 PartitionLanes(const int32* RESTRICT ParentLanes, int32 ParentCount, const float* RESTRICT Control, int32* RESTRICT Lanes, PredicateType Predicate)
+{
+	int32 Count = 0;
+	for (int32 i = 0; i < ParentCount; i++)
+	{
+		const int32 Lane = ParentLanes[i];
+		Lanes[Count] = Lane;
+		Count += Predicate(Control[Lane]) ? 1 : 0;
+	}
+	return Count;
+}
+
+TSharedRef<FUFNNoiseProgram> FUFNNoiseProgram::Compile2D(UUFNNoiseGenerator* Root)
+{
+	FUFNNoiseCompiler Compiler(true);
+	return Compiler.Finish(Compiler.Compile(Root, Compiler.GetInputCoordinates()));
+}
+
+TSharedRef<FUFNNoiseProgram> FUFNNoiseProgram::Compile3D(UUFNNoiseGenerator* Root)
+{
+	FUFNNoiseCompiler Compiler(false);
+	return Compiler.Finish(Compiler.Compile(Root, Compiler.GetInputCoordinates()));
+}
+
+void FUFNNoiseProgram::Evaluate2D(const float* X, const float* Y, float* Out, int32 Count, FUFNNoiseEvaluationStats* OutStats) const
+{
+	check(bIs2D);
+	Evaluate(X, Y, nullptr, Out, Count, OutStats);
+}
+
+void FUFNNoiseProgram::Evaluate3D(const float* X, const float* Y, const float* Z, float* Out, int32 Count, FUFNNoiseEvaluationStats* OutStats) const
+{
+	check(!bIs2D);
+	Evaluate(X, Y, Z, Out, Count, OutStats);
+}
+
+FFloatInterval FUFNNoiseProgram::GetBounds2D(const FBox2D& Region) const
+{
+	check(bIs2D);
+	const FFloatInterval InputBounds[2] = { FFloatInterval(Region.Min.X, Region.Max.X), FFloatInterval(Region.Min.Y, Region.Max.Y) };
+
+	TArray<FFloatInterval> RegisterBounds;
+	TArray<EUFNNoiseBranch> Branches;
+	RegisterBounds.SetNumUninitialized(NumRegisters);
+	Branches.SetNumUninitialized(Instructions.Num());
+	return ComputeBounds(InputBounds, RegisterBounds.GetData(), Branches.GetData());
+}
+
+FFloatInterval FUFNNoiseProgram::GetBounds3D(const FBox& Region) const
+{
+	check(!bIs2D);
+	const FFloatInterval InputBounds[3] = { FFloatInterval(Region.Min.X, Region.Max.X), FFloatInterval(Region.Min.Y, Region.Max.Y), FFloatInterval(Region.Min.Z, Region.Max.Z) };
+
+	TArray<FFloatInterval> RegisterBounds;
+	TArray<EUFNNoiseBranch> Branches;
+	RegisterBounds.SetNumUninitialized(NumRegisters);
+	Branches.SetNumUninitialized(Instructions.Num());
+	return ComputeBounds(InputBounds, RegisterBounds.GetData(), Branches.GetData());
+}
+
+// Range of a block of coordinates, anything holding a NaN is unbounded
+static FFloatInterval GetBlockBounds(const float* Values, int32 Count)
+{
+	FFloatInterval Bounds(Values[0], Values[0]);
+	for (int32 i = 0; i < Count; i++)
+	{
+		if (FMath::IsNaN(Values[i]))
+		{
+			return FUFNNoiseBounds::Unbounded();
+		}
+		Bounds.Min = FMath::Min(Bounds.Min, Values[i]);
+		Bounds.Max = FMath::Max(Bounds.Max, Values[i]);
+	}
+	return Bounds;
+}
+
+void FUFNNoiseProgram::Evaluate(const float* X, const float* Y, const float* Z, float* Out, int32 Count, FUFNNoiseEvaluationStats* OutStats) const
+{
+	TArray<float> Registers;
+	Registers.SetNumUninitialized(NumRegisters * BlockSize);
+	float* RegisterData = Registers.GetData();
+
+	// Scratch for splitting blocks between the inputs of selects
+	TArray<int32> Lanes;
+	TArray<int32> LaneCounts;
+	TArray<float> Scratch;
+	if (Scopes.Num() > 1)
+	{
+		Lanes.SetNumUninitialized(Scopes.Num() * BlockSize);
+		LaneCounts.SetNumUninitialized(Scopes.Num());
+		Scratch.SetNumUninitialized(5 * BlockSize);
+		for (int32 Lane = 0; Lane < BlockSize; Lane++)
+		{
+			Lanes[Lane] = Lane;
+		}
+	}
+
+	// Per block bounds only pay off when there is a branch to skip
+	TArray<FFloatInterval> RegisterBounds;
+	TArray<EUFNNoiseBranch> Branches;
+	TArray<bool> Run;
+	if (bHasBranches)
+	{
+		RegisterBounds.SetNumUninitialized(NumRegisters);
+		Branches.SetNumUninitialized(Instructions.Num());
+		Run.SetNumUninitialized(Instructions.Num());
+	}
+
+	for (int32 Start = 0; Start < Count; Start += BlockSize)
+	{
+		const int32 BlockCount = FMath::Min(BlockSize, Count - Start);
+
+		// The coordinates always live in the first registers
+		FMemory::Memcpy(RegisterData, X + Start, BlockCount * sizeof(float));
+		FMemory::Memcpy(RegisterData + BlockSize, Y + Start, BlockCount * sizeof(float));
+		if (!bIs2D)
+		{
+			FMemory::Memcpy(RegisterData + 2 * BlockSize, Z + Start, BlockCount * sizeof(float));
+		}
+
+		FBlock Block(RegisterData, BlockCount);
+		Block.Stats = OutStats;
+		if (bHasBranches)
+		{
+			FFloatInterval InputBounds[3];
+			for (int32 Input = 0; Input < (bIs2D ? 2 : 3); Input++)
+			{
+				InputBounds[Input] = GetBlockBounds(RegisterData + Input * BlockSize, BlockCount);
+			}
+
+			ComputeBounds(InputBounds, RegisterBounds.GetData(), Branches.GetData());
+			ComputeRun(Branches.GetData(), Run.GetData());
+			Block.Run = Run.GetData();
+			Block.Branches = Branches.GetData();
+		}
+		if (Scopes.Num() > 1)
+		{
+			for (int32& LaneCount : LaneCounts)
+			{
+				LaneCount = INDEX_NONE;
+			}
+			LaneCounts[0] = BlockCount;
+			Block.Lanes = Lanes.GetData();
+			Block.LaneCounts = LaneCounts.GetData();
+			Block.Scratch = Scratch.GetData();
+		}
+
+		EvaluateBlock(Block);
+
+		FMemory::Memcpy(Out + Start, RegisterData + ResultRegister * BlockSize, BlockCount * sizeof(float));
+
+		if (OutStats)
+		{
+			OutStats->Points += BlockCount;
+		}
+	}
+}
+
+FFloatInterval FUFNNoiseProgram::ComputeBounds(const FFloatInterval* InputBounds, FFloatInterval* RegisterBounds, EUFNNoiseBranch* Branches) const
+{
+	// Registers are only reused once their value is dead, so walking the program in order each register's bounds are
+	// those of the value it holds at that point
+	for (int32 Input = 0; Input < (bIs2D ? 2 : 3); Input++)
+	{
+		RegisterBounds[Input] = InputBounds[Input];
+	}
+
+	for (int32 Index = 0; Index < Instructions.Num(); Index++)
+	{
+		const FUFNNoiseInstruction& Instruction = Instructions[Index];
+		const FFloatInterval& A = RegisterBounds[FMath::Max(Instruction.Args[0], 0)];
+		const FFloatInterval& B = RegisterBounds[FMath::Max(Instruction.Args[1], 0)];
+		const FFloatInterval& C = RegisterBounds[FMath::Max(Instruction.Args[2], 0)];
+		const FFloatInterval& D = RegisterBounds[FMath::Max(Instruction.Args[3], 0)];
+		const float Value0 = Instruction.Values[0];
+		const float Value1 = Instruction.Values[1];
+		const float Value2 = Instruction.Values[2];
+
+		EUFNNoiseBranch& Branch = Branches[Index];
+		Branch = EUFNNoiseBranch::Any;
+
+		FFloatInterval Bounds;
+		switch (Instruction.Op)
+		{
+		case EUFNNoiseOp::Constant:
+			Bounds = FUFNNoiseBounds::Point(Value0);
+			break;
+		case EUFNNoiseOp::AddConstant:
+			Bounds = FUFNNoiseBounds::AddConstant(A, Value0);
+			break;
+		case EUFNNoiseOp::MultiplyAdd:
+			Bounds = FUFNNoiseBounds::MultiplyAdd(A, B, Value0);
+			break;
+		case EUFNNoiseOp::ScaleBias:
+			Bounds = FUFNNoiseBounds::ScaleBias(A, Value0, Value1);
+			break;
+		case EUFNNoiseOp::Add:
+			Bounds = FUFNNoiseBounds::Add(A, B);
+			break;
+		case EUFNNoiseOp::MaskedAdd:
+			Branch = FUFNNoiseBounds::GetMaskedAddBranch(C, Value0);
+			Bounds = FUFNNoiseBounds::MaskedAdd(A, B, C, Value0);
+			break;
+		case EUFNNoiseOp::Select:
+			Branch = FUFNNoiseBounds::GetSelectBranch(C, Value0);
+			Bounds = FUFNNoiseBounds::Select(A, B, C, Value0);
+			break;
+		case EUFNNoiseOp::SelectInterp:
+			Branch = FUFNNoiseBounds::GetSelectInterpBranch(C, Value0, Value1);
+			Bounds = FUFNNoiseBounds::SelectInterp(A, B, C, Value0, Value1, Value2, Instruction.Interp);
+			break;
+		case EUFNNoiseOp::Select3:
+			Branch = FUFNNoiseBounds::GetSelect3Branch(D, Value0, Value1);
+			Bounds = FUFNNoiseBounds::Select3(A, B, C, D, Value0, Value1);
+			break;
+		case EUFNNoiseOp::BlendAlpha:
+			Bounds = FUFNNoiseBounds::BlendAlpha(A, Instruction.Curve);
+			break;
+		case EUFNNoiseOp::Blend:
+			Bounds = FUFNNoiseBounds::Lerp(A, B, C);
+			break;
+		case EUFNNoiseOp::Distance2D:
+			Bounds = FUFNNoiseBounds::Distance2D(A, B, Value0, Value1);
+			break;
+		case EUFNNoiseOp::Distance3D:
+			Bounds = FUFNNoiseBounds::Distance3D(A, B, C, FVector(Value0, Value1, Value2));
+			break;
+		case EUFNNoiseOp::RadialInterp:
+			Branch = FUFNNoiseBounds::GetRadialInterpBranch(C, Value0, Value1);
+			Bounds = FUFNNoiseBounds::RadialInterp(A, B, C, Value0, Value1, Value2, Instruction.Interp);
+			break;
+		case EUFNNoiseOp::FastNoise2D:
+		case EUFNNoiseOp::FastNoise3D:
+			Bounds = Instruction.Noise->GetNoiseBounds();
+			break;
+		case EUFNNoiseOp::Generator2D:
+			Bounds = Instruction.Generator->GetNoiseBounds2D(FBox2D(FVector2D(A.Min, B.Min), FVector2D(A.Max, B.Max)));
+			break;
+		case EUFNNoiseOp::Generator3D:
+			Bounds = Instruction.Generator->GetNoiseBounds3D(FBox(FVector(A.Min, B.Min, C.Min), FVector(A.Max, B.Max, C.Max)));
+			break;
+		}
+
+		RegisterBounds[Instruction.Out] = Bounds;
+	}
+
+	return RegisterBounds[ResultRegister];
+}
+
+void FUFNNoiseProgram::ComputeRun(const EUFNNoiseBranch* Branches, bool* Run) const
+{
+	// Backwards from the result, a register is needed from the instruction assigning it until its last needed read
+	TArray<bool, TInlineAllocator<64>> Needed;
+	Needed.Init(false, NumRegisters);
+	Needed[ResultRegister] = true;
+
+	for (int32 Index = Instructions.Num() - 1; Index >= 0; Index--)
+	{
+		const FUFNNoiseInstruction& Instruction = Instructions[Index];
+		Run[Index] = Needed[Instruction.Out];
+		Needed[Instruction.Out] = false;
+		if (!Run[Index])
+		{
+			continue;
+		}
+
+		// A select going one way only reads that input, a masked add whose mask never passes only the first
+		const EUFNNoiseBranch Branch = Branches[Index];
+		const bool bTakesOne = Branch == EUFNNoiseBranch::First || Branch == EUFNNoiseBranch::Third || (Branch == EUFNNoiseBranch::Second && Instruction.Op != EUFNNoiseOp::MaskedAdd);
+		if (bTakesOne)
+		{
+			Needed[Instruction.Args[(int32)Branch - (int32)EUFNNoiseBranch::First]] = true;
+			continue;
+		}
+
+		for (int32 Arg : Instruction.Args)
+		{
+			if (Arg != INDEX_NONE)
+			{
+				Needed[Arg] = true;
+			}
+		}
+	}
+}
+
+// Runs one instruction over Count points
+static void EvaluateInstruction(const FUFNNoiseInstruction& Instruction, EUFNNoiseBranch Branch, float* RESTRICT Out, const float* RESTRICT A, const float* RESTRICT B, const float* RESTRICT C, const float* RESTRICT D, int32 Count)
+{
+	const float Value0 = Instruction.Values[0];
+	const float Value1 = Instruction.Values[1];
+	const float Value2 = Instruction.Values[2];
+
+	switch (Instruction.Op)
+	{
+	case EUFNNoiseOp::Constant:
+		for (int32 i = 0; i < Count; i++)
+		{
+			Out[i] = Value0;
+		}
+		break;
+
+	case EUFNNoiseOp::AddConstant:
+		for (int32 i = 0; i < Count; i++)
+		{
+			Out[i] = A[i] + Value0;
+		}
+		break;
+
+	case EUFNNoiseOp::MultiplyAdd:
+		for (int32 i = 0; i < Count; i++)
+		{
+			Out[i] = A[i] + (Value0 * B[i]);
+		}
+		break;
+
+	case EUFNNoiseOp::ScaleBias:
+		for (int32 i = 0; i < Count; i++)
+		{
+			Out[i] = (A[i] * Value0) + Value1;
+		}
+		break;
+
+	case EUFNNoiseOp::Add:
+		for (int32 i = 0; i < Count; i++)
+		{
+			Out[i] = A[i] + B[i];
+		}
+		break;
+
+	case EUFNNoiseOp::MaskedAdd:
+		if (Branch == EUFNNoiseBranch::Second)
+		{
+			for (int32 i = 0; i < Count; i++)
+			{
+				Out[i] = C[i] * (A[i] + B[i]);
+			}
+			break;
+		}
+
+		for (int32 i = 0; i < Count; i++)
+		{
+			Out[i] = C[i] >= Value0 ? C[i] * (A[i] + B[i]) : A[i];
+		}
+		break;
+
+	case EUFNNoiseOp::Select:
+		for (int32 i = 0; i < Count; i++)
+		{
+			Out[i] = C[i] > Value0 ? A[i] : B[i];
+		}
+		break;
+
+	case EUFNNoiseOp::SelectInterp:
+		if (Branch == EUFNNoiseBranch::Falloff)
+		{
+			for (int32 i = 0; i < Count; i++)
+			{
+				Out[i] = Instruction.Interp(B[i], A[i], C[i] - Value2, Instruction.Steps);
+			}
+			break;
+		}
+
+		for (int32 i = 0; i < Count; i++)
+		{
+			const float Control = C[i];
+			Out[i] = Control <= Value0 ? B[i] : Control >= Value1 ? A[i] : Instruction.Interp(B[i], A[i], Control - Value2, Instruction.Steps);
+		}
+		break;
+
+	case EUFNNoiseOp::Select3:
+		for (int32 i = 0; i < Count; i++)
+		{
+			Out[i] = D[i] >= Value0 ? A[i] : D[i] >= Value1 ? B[i] : C[i];
+		}
+		break;
+
+	case EUFNNoiseOp::BlendAlpha:
+		if (Instruction.Curve)
+		{
+			for (int32 i = 0; i < Count; i++)
+			{
+				Out[i] = Instruction.Curve->GetFloatValue((A[i] + 1.0f) / 2.0f);
+			}
+		}
+		else
+		{
+			for (int32 i = 0; i < Count; i++)
+			{
+				Out[i] = (A[i] + 1.0f) / 2.0f;
+			}
+		}
+		break;
+
+	case EUFNNoiseOp::Blend:
+		// B is not evaluated for points blended fully to A
+		for (int32 i = 0; i < Count; i++)
+		{
+			Out[i] = C[i] == 0.0f ? A[i] : FMath::Lerp(A[i], B[i], C[i]);
+		}
+		break;
+
+	case EUFNNoiseOp::Distance2D:
+		for (int32 i = 0; i < Count; i++)
+		{
+			const float DX = A[i] - Value0;
+			const float DY = B[i] - Value1;
+			Out[i] = FMath::Sqrt(DX * DX + DY * DY);
+		}
+		break;
+
+	case EUFNNoiseOp::Distance3D:
+		for (int32 i = 0; i < Count; i++)
+		{
+			const float DX = Value0 - A[i];
+			const float DY = Value1 - B[i];
+			const float DZ = Value2 - C[i];
+			Out[i] = FMath::Sqrt(DX * DX + DY * DY + DZ * DZ);
+		}
+		break;
+
+	case EUFNNoiseOp::RadialInterp:
+		if (Branch == EUFNNoiseBranch::Falloff)
+		{
+			for (int32 i = 0; i < Count; i++)
+			{
+				Out[i] = Instruction.Interp(A[i], B[i], (C[i] - Value0) / Value2, Instruction.Steps);
+			}
+			break;
+		}
+
+		for (int32 i = 0; i < Count; i++)
+		{
+			const float Distance = C[i];
+			Out[i] = Distance > Value1 ? B[i] : Distance < Value0 ? A[i] : Instruction.Interp(A[i], B[i], (Distance - Value0) / Value2, Instruction.Steps);
+		}
+		break;
+
+	case EUFNNoiseOp::FastNoise2D:
+		Instruction.Noise->GetNoise2DBatch(A, B, Out, Count);
+		break;
+
+	case EUFNNoiseOp::FastNoise3D:
+		Instruction.Noise->GetNoise3DBatch(A, B, C, Out, Count);
+		break;
+
+	case EUFNNoiseOp::Generator2D:
+		for (int32 i = 0; i < Count; i++)
+		{
+			Out[i] = Instruction.Generator->GetNoise2D(A[i], B[i]);
+		}
+		break;
+
+	case EUFNNoiseOp::Generator3D:
+		for (int32 i = 0; i < Count; i++)
+		{
+			Out[i] = Instruction.Generator->GetNoise3D(A[i], B[i], C[i]);
+		}
+		break;
+	}
+}
+
+void FUFNNoiseProgram::EvaluateBlock(FBlock& Block) const
+{
+	float* Registers = Block.Registers;
+	for (int32 Index = 0; Index < Instructions.Num(); Index++)
+	{
+		const FUFNNoiseInstruction& Instruction = Instructions[Index];
+		const int32 Scope = InstructionScopes.Num() ? InstructionScopes[Index] : 0;
+		const bool bRun = !Block.Run || Block.Run[Index];
+		const int32 LaneCount = !bRun ? 0 : Scope ? GetLanes(Block, Scope) : Block.Count;
+
+		if (Block.Stats && Instruction.IsLeaf())
+		{
+			Block.Stats->LeafEvaluations += LaneCount;
+			Block.Stats->SkippedLeafEvaluations += Block.Count - LaneCount;
+		}
+		if (LaneCount == 0)
+		{
+			continue;
+		}
+
+#if UFN_NOISE_PROFILING
+		// Timed as work of the node that emitted it. A generator times its own calls and is left the loop around them
+		UUFNNoiseGenerator* const* ProfilePath = nullptr;
+		int32 ProfilePathLength = 0;
+		if (ProfilePaths.IsValidIndex(Instruction.ProfilePath))
+		{
+			const TArray<UUFNNoiseGenerator*>& Path = ProfilePaths[Instruction.ProfilePath];
+			ProfilePath = Path.GetData();
+			ProfilePathLength = Path.Num() && Path.Last() == Instruction.Generator ? Path.Num() - 1 : Path.Num();
+		}
+		FUFNNoiseProfileScope ProfileScope(ProfilePath, ProfilePathLength, Instruction.bProfileResult && !Instruction.Generator ? LaneCount : 0);
+#endif
+
+		float* Out = Registers + Instruction.Out * BlockSize;
+		const float* Args[4];
+		for (int32 Arg = 0; Arg < 4; Arg++)
+		{
+			Args[Arg] = Instruction.Args[Arg] != INDEX_NONE ? Registers + Instruction.Args[Arg] * BlockSize : nullptr;
+		}
+
+		// Every point in the block takes the same input, masked adds that always pass still need the sum
+		const EUFNNoiseBranch Branch = Block.Branches ? Block.Branches[Index] : EUFNNoiseBranch::Any;
+		if (Branch == EUFNNoiseBranch::First || Branch == EUFNNoiseBranch::Third || (Branch == EUFNNoiseBranch::Second && Instruction.Op != EUFNNoiseOp::MaskedAdd))
+		{
+			FMemory::Memcpy(Out, Args[(int32)Branch - (int32)EUFNNoiseBranch::First], Block.Count * sizeof(float));
+			continue;
+		}
+
+		if (LaneCount == Block.Count || !IsCompacted(Instruction))
+		{
+			EvaluateInstruction(Instruction, Branch, Out, Args[0], Args[1], Args[2], Args[3], Block.Count);
+			continue;
+		}
+
+		// Gather the scope's points, evaluate them as a batch of their own and scatter the results back
+		const int32* RESTRICT Lanes = Block.Lanes + Scope * BlockSize;
+		const float* Gathered[4];
+		for (int32 Arg = 0; Arg < 4; Arg++)
+		{
+			Gathered[Arg] = nullptr;
+			if (Args[Arg])
+			{
+				const float* RESTRICT Source = Args[Arg];
+				float* RESTRICT Destination = Block.Scratch + Arg * BlockSize;
+				for (int32 i = 0; i < LaneCount; i++)
+				{
+					Destination[i] = Source[Lanes[i]];
+				}
+				Gathered[Arg] = Destination;
+			}
+		}
+
+		float* RESTRICT Compacted = Block.Scratch + 4 * BlockSize;
+		EvaluateInstruction(Instruction, Branch, Compacted, Gathered[0], Gathered[1], Gathered[2], Gathered[3], LaneCount);
+		for (int32 i = 0; i < LaneCount; i++)
+		{
+			Out[Lanes[i]] = Compacted[i];
+		}
+	}
+}
+
+int32 FUFNNoiseProgram::GetLanes(FBlock& Block, int32 ScopeIndex) const
+{
+	if (Block.LaneCounts[ScopeIndex] != INDEX_NONE)
+	{
+		return Block.LaneCounts[ScopeIndex];
+	}
+
+	const FScope& Scope = Scopes[ScopeIndex];
+	const int32 ParentCount = GetLanes(Block, Scope.Parent);
+	const int32* ParentLanes = Block.Lanes + Scope.Parent * BlockSize;
+	int32* Lanes = Block.Lanes + ScopeIndex * BlockSize;
+
+	// When the bounds have settled the select for the whole block its control may not have been evaluated at all
+	const FUFNNoiseInstruction& Select = Instructions[Scope.Instruction];
+	const EUFNNoiseBranch Branch = Block.Branches ? Block.Branches[Scope.Instruction] : EUFNNoiseBranch::Any;
+	if (Branch != EUFNNoiseBranch::Any)
+	{
+		const int32 LaneCount = IsBranchRead(Select.Op, Branch, Scope.Arg) ? ParentCount : 0;
+		FMemory::Memcpy(Lanes, ParentLanes, LaneCount * sizeof(int32));
+		return Block.LaneCounts[ScopeIndex] = LaneCount;
+	}
+
+	// The points that read the argument, mirroring the compares in EvaluateInstruction. Those in a falloff band read both
+	const float* Control = Block.Registers + Select.Args[GetControlArg(Select.Op)] * BlockSize;
+	const float Value0 = Select.Values[0];
+	const float Value1 = Select.Values[1];
+	int32 LaneCount = 0;
+	switch (Select.Op)
+	{
+	case EUFNNoiseOp::MaskedAdd:
+		LaneCount = PartitionLanes(ParentLanes, ParentCount, Control, Lanes, [Value0](float Value) { return Value >= Value0; });
+		break;
+	case EUFNNoiseOp::Select:
+		LaneCount = Scope.Arg == 0 ?
+			PartitionLanes(ParentLanes, ParentCount, Control, Lanes, [Value0](float Value) { return Value > Value0; }) :
+			PartitionLanes(ParentLanes, ParentCount, Control, Lanes, [Value0](float Value) { return !(Value > Value0); });
+		break;
+	case EUFNNoiseOp::SelectInterp:
+		LaneCount = Scope.Arg == 0 ?
+			PartitionLanes(ParentLanes, ParentCount, Control, Lanes, [Value0](float Value) { return !(Value <= Value0); }) :
+			PartitionLanes(ParentLanes, ParentCount, Control, Lanes, [Value0, Value1](float Value) { return Value <= Value0 || !(Value >= Value1); });
+		break;
+	case EUFNNoiseOp::Select3:
+		LaneCount = Scope.Arg == 0 ?
+			PartitionLanes(ParentLanes, ParentCount, Control, Lanes, [Value0](float Value) { return Value >= Value0; }) :
+			Scope.Arg == 1 ?
+			PartitionLanes(ParentLanes, ParentCount, Control, Lanes, [Value0, Value1](float Value) { return !(Value >= Value0) && Value >= Value1; }) :
+			PartitionLanes(ParentLanes, ParentCount, Control, Lanes, [Value0, Value1](float Value) { return !(Value >= Value0) && !(Value >= Value1); });
+		break;
+	case EUFNNoiseOp::RadialInterp:
+		LaneCount = Scope.Arg == 0 ?
+			PartitionLanes(ParentLanes, ParentCount, Control, Lanes, [Value1](float Value) { return !(Value > Value1); }) :
+			PartitionLanes(ParentLanes, ParentCount, Control, Lanes, [Value0, Value1](float Value) { return Value > Value1 || !(Value < Value0); });
+		break;
+	case EUFNNoiseOp::Blend:
+		LaneCount = PartitionLanes(ParentLanes, ParentCount, Control, Lanes, [](float Value) { return Value != 0.0f; });
+		break;
+	default:
+		checkNoEntry();
+		break;
+	}
+
+	return Block.LaneCounts[ScopeIndex] = LaneCount;
+}
+
+FUFNNoiseCompiler::FUFNNoiseCompiler(bool bInIs2D)
+	: ProfilePath(INDEX_NONE)
+	, ExpandedLeafEvaluations(0)
+	, InputCoordinates(0, 1, bInIs2D ? INDEX_NONE : 2)
+	, NumValues(bInIs2D ? 2 : 3)
+	, bIs2D(bInIs2D)
+{
+}
+
+int32 FUFNNoiseCompiler::Compile(UUFNNoiseGenerator* Node, const FUFNNoiseCoordinates& Coordinates)
+{
+	if (!Node)
+	{
+		return Constant(0.0f);
+	}
+
+	const FNodeKey Key(Node, Coordinates);
+	if (const FCompiledNode* Compiled = CompiledNodes.Find(Key))
+	{
+		ExpandedLeafEvaluations += Compiled->ExpandedLeafEvaluations;
+		return Compiled->Value;
+	}
+
+	const int64 ExpandedLeafEvaluationsBefore = ExpandedLeafEvaluations;
+	Nodes.Add(Node);
+
+	// What the node emits is profiled under the path it was first reached through
+	const int32 ParentProfilePath = ProfilePath;
+	NodePath.Push(Node);
+	ProfilePath = ProfilePaths.Add(NodePath);
+
+	FCompiledNode Compiled;
+	Compiled.Value = Node->CompileNoise(*this, Coordinates);
+
+	const int32 NumInputs = bIs2D ? 2 : 3;
+	if (Compiled.Value >= NumInputs && Instructions[Compiled.Value - NumInputs].ProfilePath == ProfilePath)
+	{
+		Instructions[Compiled.Value - NumInputs].bProfileResult = true;
+	}
+	NodePath.Pop(false);
+	ProfilePath = ParentProfilePath;
+
+	Compiled.ExpandedLeafEvaluations = ExpandedLeafEvaluations - ExpandedLeafEvaluationsBefore;
+	CompiledNodes.Add(Key, Compiled);
+	return Compiled.Value;
+}
+
+int32 FUFNNoiseCompiler::Emit(FUFNNoiseInstruction& Instruction)
+{
+	// Anything reading only constants is one itself
+	if (Instruction.Op != EUFNNoiseOp::Constant)
+	{
+		bool bConstantArgs = true;
+		for (int32 Arg : Instruction.Args)
+		{
+			float Value;
+			bConstantArgs &= Arg == INDEX_NONE || GetConstant(Arg, Value);
+		}
+
+		if (bConstantArgs)
+		{
+			Stats.Simplifications++;
+			return Constant(Fold(Instruction));
+		}
+	}
+
+	if (const int32* Existing = EmittedValues.Find(Instruction))
+	{
+		return *Existing;
+	}
+
+	const int32 Value = NumValues++;
+	EmittedValues.Add(Instruction, Value);
+
+	Instruction.Out = Value;
+	Instruction.ProfilePath = ProfilePath;
+	Instructions.Add(Instruction);
+	return Value;
+}
+
+const FUFNNoiseInstruction* FUFNNoiseCompiler::GetInstruction(int32 Value) const
+{
+	// Every emitted instruction assigns the next value
+	const int32 NumInputs = bIs2D ? 2 : 3;
+	return Value >= NumInputs ? &Instructions[Value - NumInputs] : nullptr;
+}
+
+bool FUFNNoiseCompiler::GetConstant(int32 Value, float& OutConstant) const
+{
+	const FUFNNoiseInstruction* Instruction = GetInstruction(Value);
+	if (Instruction && Instruction->Op == EUFNNoiseOp::Constant)
+	{
+		OutConstant = Instruction->Values[0];
+		return true;
+	}
+
+	return false;
+}
+
+float FUFNNoiseCompiler::Fold(const FUFNNoiseInstruction& Instruction) const
+{
+	// Run it for a single point, with the constants it reads in the first registers
+	FUFNNoiseProgram Program;
+	FUFNNoiseInstruction& Folded = Program.Instructions[Program.Instructions.Add(Instruction)];
+	float Registers[5 * FUFNNoiseProgram::BlockSize];
+	for (int32 Arg = 0; Arg < 4; Arg++)
+	{
+		if (Folded.Args[Arg] != INDEX_NONE)
+		{
+			GetConstant(Folded.Args[Arg], Registers[Arg * FUFNNoiseProgram::BlockSize]);
+			Folded.Args[Arg] = Arg;
+		}
+	}
+	Folded.Out = 4;
+
+	FUFNNoiseProgram::FBlock Block(Registers, 1);
+	Program.EvaluateBlock(Block);
+	return Registers[4 * FUFNNoiseProgram::BlockSize];
+}
+
+int32 FUFNNoiseCompiler::Constant(float Value)
+{
+	FUFNNoiseInstruction Instruction(EUFNNoiseOp::Constant);
+	Instruction.Values[0] = Value;
+	return Emit(Instruction);
+}
+
+int32 FUFNNoiseCompiler::AddConstant(int32 A, float Value)
+{
+	if (Value == 0.0f)
+	{
+		Stats.Simplifications++;
+		return A;
+	}
+
+	FUFNNoiseInstruction Instruction(EUFNNoiseOp::AddConstant);
+	Instruction.Args[0] = A;
+	Instruction.Values[0] = Value;
+	return Emit(Instruction);
+}
+
+int32 FUFNNoiseCompiler::MultiplyAdd(int32 A, int32 B, float Scale)
+{
+	float Constant;
+	if (GetConstant(B, Constant))
+	{
+		Stats.Simplifications++;
+		return AddConstant(A, Scale * Constant);
+	}
+
+	FUFNNoiseInstruction Instruction(EUFNNoiseOp::MultiplyAdd);
+	Instruction.Args[0] = A;
+	Instruction.Args[1] = B;
+	Instruction.Values[0] = Scale;
+	return Emit(Instruction);
+}
+
+int32 FUFNNoiseCompiler::ScaleBias(int32 A, float Scale, float Bias)
+{
+	// (a * s1 + b1) * s2 + b2 = a * (s1 * s2) + (b1 * s2 + b2), up to rounding
+	const FUFNNoiseInstruction* Input = GetInstruction(A);
+	if (Input && Input->Op == EUFNNoiseOp::ScaleBias)
+	{
+		const int32 InputA = Input->Args[0];
+		const float InputScale = Input->Values[0];
+		const float InputBias = Input->Values[1];
+		Stats.Simplifications++;
+		return ScaleBias(InputA, InputScale * Scale, InputBias * Scale + Bias);
+	}
+
+	if (Scale == 1.0f && Bias == 0.0f)
+	{
+		Stats.Simplifications++;
+		return A;
+	}
+
+	FUFNNoiseInstruction Instruction(EUFNNoiseOp::ScaleBias);
+	Instruction.Args[0] = A;
+	Instruction.Values[0] = Scale;
+	Instruction.Values[1] = Bias;
+	return Emit(Instruction);
+}
+
+int32 FUFNNoiseCompiler::Add(int32 A, int32 B)
+{
+	float Constant;
+	if (GetConstant(B, Constant))
+	{
+		Stats.Simplifications++;
+		return AddConstant(A, Constant);
+	}
+	if (GetConstant(A, Constant))
+	{
+		Stats.Simplifications++;
+		return AddConstant(B, Constant);
+	}
+
+	FUFNNoiseInstruction Instruction(EUFNNoiseOp::Add);
+	// Addition commutes, order the arguments so A + B and B + A are shared
+	Instruction.Args[0] = FMath::Min(A, B);
+	Instruction.Args[1] = FMath::Max(A, B);
+	return Emit(Instruction);
+}
+
+int32 FUFNNoiseCompiler::MaskedAdd(int32 A, int32 B, int32 Mask, float Threshold, const FFloatInterval& MaskBounds)
+{
+	// A mask that never passes leaves the first input, one that always does only scales the sum
+	float MaskValue;
+	if (GetConstant(Mask, MaskValue))
+	{
+		Stats.Simplifications++;
+		return MaskValue >= Threshold ? ScaleBias(Add(A, B), MaskValue, 0.0f) : A;
+	}
+	if (FUFNNoiseBounds::IsBounded(MaskBounds) && FUFNNoiseBounds::GetMaskedAddBranch(MaskBounds, Threshold) == EUFNNoiseBranch::First)
+	{
+		Stats.Simplifications++;
+		return A;
+	}
+
+	FUFNNoiseInstruction Instruction(EUFNNoiseOp::MaskedAdd);
+	Instruction.Args[0] = A;
+	Instruction.Args[1] = B;
+	Instruction.Args[2] = Mask;
+	Instruction.Values[0] = Threshold;
+	return Emit(Instruction);
+}
+
+int32 FUFNNoiseCompiler::Select(int32 A, int32 B, int32 Control, float Threshold)
+{
+	float ControlValue;
+	if (GetConstant(Control, ControlValue))
+	{
+		Stats.Simplifications++;
+		return ControlValue > Threshold ? A : B;
+	}
+
+	FUFNNoiseInstruction Instruction(EUFNNoiseOp::Select);
+	Instruction.Args[0] = A;
+	Instruction.Args[1] = B;
+	Instruction.Args[2] = Control;
+	Instruction.Values[0] = Threshold;
+	return Emit(Instruction);
+}
+
+int32 FUFNNoiseCompiler::SelectInterp(int32 A, int32 B, int32 Control, float Threshold, float Falloff, ESelectInterpType InterpType, int32 Steps)
+{
+	float ControlValue;
+	if (GetConstant(Control, ControlValue) && (ControlValue <= Threshold - Falloff || ControlValue >= Threshold + Falloff))
+	{
+		Stats.Simplifications++;
+		return ControlValue <= Threshold - Falloff ? B : A;
+	}
+
+	FUFNNoiseInstruction Instruction(EUFNNoiseOp::SelectInterp);
+	Instruction.Args[0] = A;
+	Instruction.Args[1] = B;
+	Instruction.Args[2] = Control;
+	Instruction.Values[0] = Threshold - Falloff;
+	Instruction.Values[1] = Threshold + Falloff;
+	// UUFNSelectModule divides before subtracting, keep that so the results match
+	Instruction.Values[2] = (Threshold - Falloff) / (2.0f * Falloff);
+	Instruction.Interp = GetInterpFunction(InterpType);
+	Instruction.Steps = Steps;
+	return Emit(Instruction);
+}
+
+int32 FUFNNoiseCompiler::Select3(int32 A, int32 B, int32 C, int32 Control, float UpperThreshold, float LowerThreshold)
+{
+	float ControlValue;
+	if (GetConstant(Control, ControlValue))
+	{
+		Stats.Simplifications++;
+		return ControlValue >= UpperThreshold ? A : ControlValue >= LowerThreshold ? B : C;
+	}
+
+	FUFNNoiseInstruction Instruction(EUFNNoiseOp::Select3);
+	Instruction.Args[0] = A;
+	Instruction.Args[1] = B;
+	Instruction.Args[2] = C;
+	Instruction.Args[3] = Control;
+	Instruction.Values[0] = UpperThreshold;
+	Instruction.Values[1] = LowerThreshold;
+	return Emit(Instruction);
+}
+
+int32 FUFNNoiseCompiler::Blend(int32 A, int32 B, int32 Control, UCurveFloat* Curve)
+{
+	// The alpha is a value of its own so the blend can tell which points need B
+	FUFNNoiseInstruction AlphaInstruction(EUFNNoiseOp::BlendAlpha);
+	AlphaInstruction.Args[0] = Control;
+	AlphaInstruction.Curve = Curve;
+	const int32 Alpha = Emit(AlphaInstruction);
+
+	// Only the ends of the blend take a single input, Lerp to 1 matches B up to rounding
+	float AlphaValue;
+	if (GetConstant(Alpha, AlphaValue) && (AlphaValue == 0.0f || AlphaValue == 1.0f))
+	{
+		Stats.Simplifications++;
+		return AlphaValue == 0.0f ? A : B;
+	}
+
+	FUFNNoiseInstruction Instruction(EUFNNoiseOp::Blend);
+	Instruction.Args[0] = A;
+	Instruction.Args[1] = B;
+	Instruction.Args[2] = Alpha;
+	return Emit(Instruction);
+}
+
+int32 FUFNNoiseCompiler::Distance(const FUFNNoiseCoordinates& Coordinates, const FVector& Origin)
+{
+	FUFNNoiseInstruction Instruction(Coordinates.Is2D() ? EUFNNoiseOp::Distance2D : EUFNNoiseOp::Distance3D);
+	Instruction.Args[0] = Coordinates.X;
+	Instruction.Args[1] = Coordinates.Y;
+	Instruction.Args[2] = Coordinates.Z;
+	Instruction.Values[0] = Origin.X;
+	Instruction.Values[1] = Origin.Y;
+	Instruction.Values[2] = Origin.Z;
+	return Emit(Instruction);
+}
+
+int32 FUFNNoiseCompiler::RadialInterp(int32 A, int32 B, int32 Distance, float Radius, float Falloff, ESelectInterpType InterpType, int32 Steps)
+{
+	float DistanceValue;
+	if (GetConstant(Distance, DistanceValue) && (DistanceValue > Radius + Falloff || DistanceValue < Radius))
+	{
+		Stats.Simplifications++;
+		return DistanceValue > Radius + Falloff ? B : A;
+	}
+
+	FUFNNoiseInstruction Instruction(EUFNNoiseOp::RadialInterp);
+	Instruction.Args[0] = A;
+	Instruction.Args[1] = B;
+	Instruction.Args[2] = Distance;
+	Instruction.Values[0] = Radius;
+	Instruction.Values[1] = Radius + Falloff;
+	Instruction.Values[2] = Falloff;
+	Instruction.Interp = GetInterpFunction(InterpType);
+	Instruction.Steps = Steps;
+	return Emit(Instruction);
+}
+
+int32 FUFNNoiseCompiler::FastNoise(const FFastNoise& Noise, const FUFNNoiseCoordinates& Coordinates)
+{
+	FUFNNoiseInstruction Instruction(Coordinates.Is2D() ? EUFNNoiseOp::FastNoise2D : EUFNNoiseOp::FastNoise3D);
+	Instruction.Args[0] = Coordinates.X;
+	Instruction.Args[1] = Coordinates.Y;
+	Instruction.Args[2] = Coordinates.Z;
+	Instruction.Noise = &Noise;
+	ExpandedLeafEvaluations++;
+	return Emit(Instruction);
+}
+
+int32 FUFNNoiseCompiler::Generator(UUFNNoiseGenerator* Node, const FUFNNoiseCoordinates& Coordinates)
+{
+	FUFNNoiseInstruction Instruction(Coordinates.Is2D() ? EUFNNoiseOp::Generator2D : EUFNNoiseOp::Generator3D);
+	Instruction.Args[0] = Coordinates.X;
+	Instruction.Args[1] = Coordinates.Y;
+	Instruction.Args[2] = Coordinates.Z;
+	Instruction.Generator = Node;
+	ExpandedLeafEvaluations++;
+	return Emit(Instruction);
+}
+
+TSharedRef<FUFNNoiseProgram> FUFNNoiseCompiler::Finish(int32 Result)
+{
+	const int32 NumInputs = bIs2D ? 2 : 3;
+
+	// Drop whatever the result doesn't depend on, such as the inputs of a select that was simplified away
+	TArray<bool> Live;
+	Live.Init(false, NumValues);
+	Live[Result] = true;
+	for (int32 Index = Instructions.Num() - 1; Index >= 0; Index--)
+	{
+		if (Live[Instructions[Index].Out])
+		{
+			for (int32 Arg : Instructions[Index].Args)
+			{
+				if (Arg != INDEX_NONE)
+				{
+					Live[Arg] = true;
+				}
+			}
+		}
+	}
+	Instructions.RemoveAll([&Live](const FUFNNoiseInstruction& Instruction) { return !Live[Instruction.Out]; });
+
+	TArray<FUFNNoiseProgram::FScope> Scopes;
+	TArray<int32> InstructionScopes;
+	SplitBranches(Result, Scopes, InstructionScopes);
+
+	// Last instruction reading each value, the result is read after all of them
+	TArray<int32> LastUse;
+	LastUse.Init(INDEX_NONE, NumValues);
+	for (int32 Index = 0; Index < Instructions.Num(); Index++)
+	{
+		for (int32 Arg : Instructions[Index].Args)
+		{
+			if (Arg != INDEX_NONE)
+			{
+				LastUse[Arg] = Index;
+			}
+		}
+	}
+	LastUse[Result] = Instructions.Num();
+
+	// Linear scan, a register is reused once the last reader of its value has run. Outputs are given a register before
+	// the arguments are released, so no instruction writes over its own inputs. The coordinates keep their registers.
+	TArray<int32> ValueRegisters;
+	ValueRegisters.Init(INDEX_NONE, NumValues);
+	for (int32 Input = 0; Input < NumInputs; Input++)
+	{
+		ValueRegisters[Input] = Input;
+	}
+
+	TArray<int32> FreeRegisters;
+	int32 NumRegisters = NumInputs;
+	for (int32 Index = 0; Index < Instructions.Num(); Index++)
+	{
+		FUFNNoiseInstruction& Instruction = Instructions[Index];
+
+		const int32 Out = Instruction.Out;
+		Instruction.Out = ValueRegisters[Out] = FreeRegisters.Num() ? FreeRegisters.Pop(false) : NumRegisters++;
+
+		for (int32& Arg : Instruction.Args)
+		{
+			if (Arg == INDEX_NONE)
+			{
+				continue;
+			}
+
+			const int32 Value = Arg;
+			Arg = ValueRegisters[Value];
+			if (Value >= NumInputs && LastUse[Value] == Index)
+			{
+				// An instruction may read a value more than once, only release it the first time
+				LastUse[Value] = INDEX_NONE;
+				FreeRegisters.Add(Arg);
+			}
+		}
+
+		// Nothing reads it
+		if (LastUse[Out] == INDEX_NONE)
+		{
+			FreeRegisters.Add(Instruction.Out);
+		}
+	}
+
+	TSharedRef<FUFNNoiseProgram> Program = MakeShareable(new FUFNNoiseProgram());
+	Program->ResultRegister = ValueRegisters[Result];
+	Program->NumRegisters = NumRegisters;
+	Program->bIs2D = bIs2D;
+	Program->Instructions = MoveTemp(Instructions);
+	Program->Scopes = MoveTemp(Scopes);
+	Program->InstructionScopes = MoveTemp(InstructionScopes);
+	Program->ProfilePaths = MoveTemp(ProfilePaths);
+	for (const FUFNNoiseInstruction& Instruction : Program->Instructions)
+	{
+		Program->bHasBranches |= Instruction.Op == EUFNNoiseOp::MaskedAdd || Instruction.Op == EUFNNoiseOp::Select || Instruction.Op == EUFNNoiseOp::SelectInterp ||
+			Instruction.Op == EUFNNoiseOp::Select3 || Instruction.Op == EUFNNoiseOp::RadialInterp;
+	}
+
+	Stats.Nodes = Nodes.Num();
+	Stats.ExpandedLeafEvaluations = ExpandedLeafEvaluations;
+	Stats.Instructions = Program->Instructions.Num();
+	Stats.Registers = NumRegisters;
+	for (const FUFNNoiseInstruction& Instruction : Program->Instructions)
+	{
+		Stats.LeafEvaluations += Instruction.IsLeaf() ? 1 : 0;
+	}
+	Program->Stats = Stats;
+
+	UE_LOG(LogUFNNoiseProgram, Verbose, TEXT("Compiled %d nodes into %d instructions over %d registers with %d simplifications, %d leaf evaluations per point instead of %lld"),
+		Stats.Nodes, Stats.Instructions, Stats.Registers, Stats.Simplifications, Stats.LeafEvaluations, Stats.ExpandedLeafEvaluations);
+
+	return Program;
+}
+
+void FUFNNoiseCompiler::SplitBranches(int32 Result, TArray<FUFNNoiseProgram::FScope>& OutScopes, TArray<int32>& OutInstructionScopes)
+{
+	const int32 NumInstructions = Instructions.Num();
+
+	TArray<FUFNNoiseProgram::FScope> Scopes;
+	TArray<int32> Depths;
+	FUFNNoiseProgram::FScope Root;
+	Root.Parent = INDEX_NONE;
+	Root.Instruction = INDEX_NONE;
+	Root.Arg = INDEX_NONE;
+	Scopes.Add(Root);
+	Depths.Add(0);
+
+	// Innermost scope holding both, a value read from two scopes is evaluated wherever either needs it
+	auto Meet = [&Scopes, &Depths](int32 A, int32 B)
+	{
+		if (A == INDEX_NONE)
+		{
+			return B;
+		}
+		while (A != B)
+		{
+			if (Depths[A] >= Depths[B])
+			{
+				A = Scopes[A].Parent;
+			}
+			else
+			{
+				B = Scopes[B].Parent;
+			}
+		}
+		return A;
+	};
+
+	// Every reader of a value comes after it, so walking back from the result a value's scope is settled by the time
+	// its instruction is reached
+	TArray<int32> ValueScopes;
+	ValueScopes.Init(INDEX_NONE, NumValues);
+	ValueScopes[Result] = 0;
+	TArray<int32> ArgScopes;
+	ArgScopes.Init(INDEX_NONE, NumInstructions * 4);
+	TArray<int32> InstructionScopes;
+	InstructionScopes.SetNumUninitialized(NumInstructions);
+	for (int32 Index = NumInstructions - 1; Index >= 0; Index--)
+	{
+		const FUFNNoiseInstruction& Instruction = Instructions[Index];
+		const int32 Scope = InstructionScopes[Index] = ValueScopes[Instruction.Out];
+
+		for (int32 Arg = 0; Arg < 4; Arg++)
+		{
+			const int32 Value = Instruction.Args[Arg];
+			if (Value == INDEX_NONE)
+			{
+				continue;
+			}
+
+			int32 ReadScope = Scope;
+			if (IsBranchArg(Instruction.Op, Arg))
+			{
+				int32& ArgScope = ArgScopes[Index * 4 + Arg];
+				if (ArgScope == INDEX_NONE)
+				{
+					FUFNNoiseProgram::FScope NewScope;
+					NewScope.Parent = Scope;
+					NewScope.Instruction = Index;
+					NewScope.Arg = Arg;
+					ArgScope = Scopes.Add(NewScope);
+					Depths.Add(Depths[Scope] + 1);
+				}
+				ReadScope = ArgScope;
+			}
+			ValueScopes[Value] = Meet(ValueScopes[Value], ReadScope);
+		}
+	}
+
+	// A scope's points come from its select's control, which has to run before anything in the scope. Keep the compiled
+	// order otherwise, holding back whatever is waiting on a control until it has run
+	TArray<int32> Producers;
+	Producers.Init(INDEX_NONE, NumValues);
+	for (int32 Index = 0; Index < NumInstructions; Index++)
+	{
+		Producers[Instructions[Index].Out] = Index;
+	}
+
+	TArray<bool> Scheduled;
+	Scheduled.Init(false, NumInstructions);
+	auto IsScheduled = [&Producers, &Scheduled](int32 Value)
+	{
+		return Producers[Value] == INDEX_NONE || Scheduled[Producers[Value]];
+	};
+
+	TArray<int32> Order;
+	while (Order.Num() < NumInstructions)
+	{
+		const int32 NumScheduled = Order.Num();
+		for (int32 Index = 0; Index < NumInstructions; Index++)
+		{
+			if (Scheduled[Index])
+			{
+				continue;
+			}
+
+			bool bReady = true;
+			for (int32 Arg : Instructions[Index].Args)
+			{
+				bReady &= Arg == INDEX_NONE || IsScheduled(Arg);
+			}
+			for (int32 Scope = InstructionScopes[Index]; Scope != 0; Scope = Scopes[Scope].Parent)
+			{
+				const FUFNNoiseInstruction& Select = Instructions[Scopes[Scope].Instruction];
+				bReady &= IsScheduled(Select.Args[GetControlArg(Select.Op)]);
+			}
+
+			if (bReady)
+			{
+				Scheduled[Index] = true;
+				Order.Add(Index);
+			}
+		}
+		check(Order.Num() > NumScheduled);
+	}
+
+	// Only keep scopes something is evaluated in, parents always come before their children
+	TArray<int32> NewIndices;
+	NewIndices.Init(INDEX_NONE, NumInstructions);
+	for (int32 Index = 0; Index < NumInstructions; Index++)
+	{
+		NewIndices[Order[Index]] = Index;
+	}
+
+	TArray<bool> Used;
+	Used.Init(false, Scopes.Num());
+	for (int32 Scope : InstructionScopes)
+	{
+		for (; Scope != INDEX_NONE && !Used[Scope]; Scope = Scopes[Scope].Parent)
+		{
+			Used[Scope] = true;
+		}
+	}
+
+	TArray<int32> NewScopes;
+	NewScopes.Init(INDEX_NONE, Scopes.Num());
+	OutScopes.Reset();
+	for (int32 Scope = 0; Scope < Scopes.Num(); Scope++)
+	{
+		if (Used[Scope])
+		{
+			FUFNNoiseProgram::FScope NewScope = Scopes[Scope];
+			NewScope.Parent = Scope ? NewScopes[NewScope.Parent] : INDEX_NONE;
+			NewScope.Instruction = Scope ? NewIndices[NewScope.Instruction] : INDEX_NONE;
+			NewScopes[Scope] = OutScopes.Add(NewScope);
+		}
+	}
+
+	TArray<FUFNNoiseInstruction> Ordered;
+	Ordered.Reserve(NumInstructions);
+	OutInstructionScopes.Reset();
+	for (int32 Index : Order)
+	{
+		Ordered.Add(Instructions[Index]);
+		OutInstructionScopes.Add(NewScopes[InstructionScopes[Index]]);
+	}
+	Instructions = MoveTemp(Ordered);
+}
+
+FUFNInterpFunction FUFNNoiseCompiler::GetInterpFunction(ESelectInterpType InterpType)
+{
+	switch (InterpType)
+	{
+	case ESelectInterpType::CircularIn:
+		return &InterpCircularIn;
+	case ESelectInterpType::CircularOut:
+		return &InterpCircularOut;
+	case ESelectInterpType::CircularInOut:
+		return &InterpCircularInOut;
+	case ESelectInterpType::ExponentialIn:
+		return &InterpExpoIn;
+	case ESelectInterpType::ExponentialOut:
+		return &InterpExpoOut;
+	case ESelectInterpType::ExponentialInOut:
+		return &InterpExpoInOut;
+	case ESelectInterpType::SineIn:
+		return &InterpSinIn;
+	case ESelectInterpType::SineOut:
+		return &InterpSinOut;
+	case ESelectInterpType::SineInOut:
+		return &InterpSinInOut;
+	case ESelectInterpType::Step:
+		return &InterpStep;
+	case ESelectInterpType::Linear:
+		return &InterpLinear;
+	default:
+		return nullptr;
+	}
+}
+
+// Bounds
+
+// Bounds too wide to be of use, or holding a NaN, are unbounded
+static FFloatInterval Bounded(float Min, float Max)
+{
+	const FFloatInterval Bounds(Min, Max);
+	return FUFNNoiseBounds::IsBounded(Bounds) ? Bounds : FUFNNoiseBounds::Unbounded();
+}
+
+FFloatInterval FUFNNoiseBounds::Union(const FFloatInterval& A, const FFloatInterval& B)
+{
+	if (!IsBounded(A) || !IsBounded(B))
+	{
+		return Unbounded();
+	}
+	return FFloatInterval(FMath::Min(A.Min, B.Min), FMath::Max(A.Max, B.Max));
+}
+
+FFloatInterval FUFNNoiseBounds::Add(const FFloatInterval& A, const FFloatInterval& B)
+{
+	if (!IsBounded(A) || !IsBounded(B))
+	{
+		return Unbounded();
+	}
+	return Bounded(A.Min + B.Min, A.Max + B.Max);
+}
+
+FFloatInterval FUFNNoiseBounds::Multiply(const FFloatInterval& A, const FFloatInterval& B)
+{
+	if (!IsBounded(A) || !IsBounded(B))
+	{
+		return Unbounded();
+	}
+
+	const float MinMin = A.Min * B.Min;
+	const float MinMax = A.Min * B.Max;
+	const float MaxMin = A.Max * B.Min;
+	const float MaxMax = A.Max * B.Max;
+	return Bounded(FMath::Min(FMath::Min(MinMin, MinMax), FMath::Min(MaxMin, MaxMax)), FMath::Max(FMath::Max(MinMin, MinMax), FMath::Max(MaxMin, MaxMax)));
+}
+
+FFloatInterval FUFNNoiseBounds::AddConstant(const FFloatInterval& A, float Value)
+{
+	return Add(A, Point(Value));
+}
+
+FFloatInterval FUFNNoiseBounds::MultiplyAdd(const FFloatInterval& A, const FFloatInterval& B, float Scale)
+{
+	return Add(A, Multiply(Point(Scale), B));
+}
+
+FFloatInterval FUFNNoiseBounds::ScaleBias(const FFloatInterval& A, float Scale, float Bias)
+{
+	return AddConstant(Multiply(A, Point(Scale)), Bias);
+}
+
+FFloatInterval FUFNNoiseBounds::Lerp(const FFloatInterval& A, const FFloatInterval& B, const FFloatInterval& Alpha)
+{
+	if (!IsBounded(A) || !IsBounded(B) || !IsBounded(Alpha))
+	{
+		return Unbounded();
+	}
+
+	// Between the inputs, up to the rounding of A + Alpha * (B - A)
+	if (Alpha.Min >= 0.0f && Alpha.Max <= 1.0f)
+	{
+		const FFloatInterval Hull = Union(A, B);
+		const float Headroom = FMath::Max(FMath::Abs(Hull.Min), FMath::Abs(Hull.Max)) * 1e-5f;
+		return Bounded(Hull.Min - Headroom, Hull.Max + Headroom);
+	}
+
+	const FFloatInterval Difference = Bounded(B.Min - A.Max, B.Max - A.Min);
+	return Add(A, Multiply(Alpha, Difference));
+}
+
+FFloatInterval FUFNNoiseBounds::Interp(const FFloatInterval& A, const FFloatInterval& B, const FFloatInterval& Alpha, FUFNInterpFunction Interp)
+{
+	if (Interp == &InterpLinear)
+	{
+		return Lerp(A, B, Alpha);
+	}
+
+	// InterpStep clamps alpha. The easing curves stay in [0, 1] for alpha in [0, 1], outside it they can extrapolate
+	// without bound or go NaN
+	if (Interp == &InterpStep || (IsBounded(Alpha) && Alpha.Min >= 0.0f && Alpha.Max <= 1.0f))
+	{
+		return Lerp(A, B, FFloatInterval(0.0f, 1.0f));
+	}
+
+	return Unbounded();
+}
+
+// Range of the square of a difference
+static FFloatInterval Square(const FFloatInterval& Difference)
+{
+	if (!FUFNNoiseBounds::IsBounded(Difference))
+	{
+		return FUFNNoiseBounds::Unbounded();
+	}
+	if (Difference.Min >= 0.0f)
+	{
+		return Bounded(Difference.Min * Difference.Min, Difference.Max * Difference.Max);
+	}
+	if (Difference.Max <= 0.0f)
+	{
+		return Bounded(Difference.Max * Difference.Max, Difference.Min * Difference.Min);
+	}
+	return Bounded(0.0f, FMath::Max(Difference.Min * Difference.Min, Difference.Max * Difference.Max));
+}
+
+static FFloatInterval SquareRoot(const FFloatInterval& Bounds)
+{
+	return FUFNNoiseBounds::IsBounded(Bounds) ? Bounded(FMath::Sqrt(Bounds.Min), FMath::Sqrt(Bounds.Max)) : FUFNNoiseBounds::Unbounded();
+}
+
+FFloatInterval FUFNNoiseBounds::Distance2D(const FFloatInterval& X, const FFloatInterval& Y, float OriginX, float OriginY)
+{
+	const FFloatInterval DX = Bounded(X.Min - OriginX, X.Max - OriginX);
+	const FFloatInterval DY = Bounded(Y.Min - OriginY, Y.Max - OriginY);
+	return SquareRoot(Add(Square(DX), Square(DY)));
+}
+
+FFloatInterval FUFNNoiseBounds::Distance3D(const FFloatInterval& X, const FFloatInterval& Y, const FFloatInterval& Z, const FVector& Origin)
+{
+	const FFloatInterval DX = Bounded(Origin.X - X.Max, Origin.X - X.Min);
+	const FFloatInterval DY = Bounded(Origin.Y - Y.Max, Origin.Y - Y.Min);
+	const FFloatInterval DZ = Bounded(Origin.Z - Z.Max, Origin.Z - Z.Min);
+	return SquareRoot(Add(Add(Square(DX), Square(DY)), Square(DZ)));
+}
+
+EUFNNoiseBranch FUFNNoiseBounds::GetMaskedAddBranch(const FFloatInterval& Mask, float Threshold)
+{
+	if (IsBounded(Mask))
+	{
+		if (Mask.Max < Threshold)
+		{
+			return EUFNNoiseBranch::First;
+		}
+		if (Mask.Min >= Threshold)
+		{
+			return EUFNNoiseBranch::Second;
+		}
+	}
+	return EUFNNoiseBranch::Any;
+}
+
+EUFNNoiseBranch FUFNNoiseBounds::GetSelectBranch(const FFloatInterval& Control, float Threshold)
+{
+	if (IsBounded(Control))
+	{
+		if (Control.Min > Threshold)
+		{
+			return EUFNNoiseBranch::First;
+		}
+		if (Control.Max <= Threshold)
+		{
+			return EUFNNoiseBranch::Second;
+		}
+	}
+	return EUFNNoiseBranch::Any;
+}
+
+EUFNNoiseBranch FUFNNoiseBounds::GetSelectInterpBranch(const FFloatInterval& Control, float Lower, float Upper)
+{
+	if (IsBounded(Control))
+	{
+		if (Control.Max <= Lower)
+		{
+			return EUFNNoiseBranch::Second;
+		}
+		if (Control.Min > Lower && Control.Min >= Upper)
+		{
+			return EUFNNoiseBranch::First;
+		}
+		if (Control.Min > Lower && Control.Max < Upper)
+		{
+			return EUFNNoiseBranch::Falloff;
+		}
+	}
+	return EUFNNoiseBranch::Any;
+}
+
+EUFNNoiseBranch FUFNNoiseBounds::GetSelect3Branch(const FFloatInterval& Control, float UpperThreshold, float LowerThreshold)
+{
+	if (IsBounded(Control))
+	{
+		if (Control.Min >= UpperThreshold)
+		{
+			return EUFNNoiseBranch::First;
+		}
+		if (Control.Max < UpperThreshold && Control.Min >= LowerThreshold)
+		{
+			return EUFNNoiseBranch::Second;
+		}
+		if (Control.Max < UpperThreshold && Control.Max < LowerThreshold)
+		{
+			return EUFNNoiseBranch::Third;
+		}
+	}
+	return EUFNNoiseBranch::Any;
+}
+
+EUFNNoiseBranch FUFNNoiseBounds::GetRadialInterpBranch(const FFloatInterval& Distance, float Radius, float Outer)
+{
+	if (IsBounded(Distance))
+	{
+		if (Distance.Min > Outer)
+		{
+			return EUFNNoiseBranch::Second;
+		}
+		if (Distance.Max <= Outer && Distance.Max < Radius)
+		{
+			return EUFNNoiseBranch::First;
+		}
+		if (Distance.Max <= Outer && Distance.Min >= Radius)
+		{
+			return EUFNNoiseBranch::Falloff;
+		}
+	}
+	return EUFNNoiseBranch::Any;
+}
+
+FFloatInterval FUFNNoiseBounds::MaskedAdd(const FFloatInterval& A, const FFloatInterval& B, const FFloatInterval& Mask, float Threshold)
+{
+	switch (GetMaskedAddBranch(Mask, Threshold))
+	{
+	case EUFNNoiseBranch::First:
+		return A;
+	case EUFNNoiseBranch::Second:
+		return Multiply(Mask, Add(A, B));
+	default:
+		// Only masks that pass scale the sum
+		return IsBounded(Mask) ? Union(A, Multiply(FFloatInterval(FMath::Max(Mask.Min, Threshold), Mask.Max), Add(A, B))) : Unbounded();
+	}
+}
+
+FFloatInterval FUFNNoiseBounds::Select(const FFloatInterval& A, const FFloatInterval& B, const FFloatInterval& Control, float Threshold)
+{
+	switch (GetSelectBranch(Control, Threshold))
+	{
+	case EUFNNoiseBranch::First:
+		return A;
+	case EUFNNoiseBranch::Second:
+		return B;
+	default:
+		return Union(A, B);
+	}
+}
+
+FFloatInterval FUFNNoiseBounds::SelectInterp(const FFloatInterval& A, const FFloatInterval& B, const FFloatInterval& Control, float Lower, float Upper, float AlphaOffset, FUFNInterpFunction Interp)
+{
+	const EUFNNoiseBranch Branch = GetSelectInterpBranch(Control, Lower, Upper);
+	if (Branch == EUFNNoiseBranch::First)
+	{
+		return A;
+	}
+	if (Branch == EUFNNoiseBranch::Second)
+	{
+		return B;
+	}
+	if (!IsBounded(Control))
+	{
+		return Unbounded();
+	}
+
+	// Only controls inside the band are blended
+	const FFloatInterval Alpha = Bounded(FMath::Max(Control.Min, Lower) - AlphaOffset, FMath::Min(Control.Max, Upper) - AlphaOffset);
+	const FFloatInterval Blended = FUFNNoiseBounds::Interp(B, A, Alpha, Interp);
+	return Branch == EUFNNoiseBranch::Falloff ? Blended : Union(Union(A, B), Blended);
+}
+
+FFloatInterval FUFNNoiseBounds::Select3(const FFloatInterval& A, const FFloatInterval& B, const FFloatInterval& C, const FFloatInterval& Control, float UpperThreshold, float LowerThreshold)
+{
+	switch (GetSelect3Branch(Control, UpperThreshold, LowerThreshold))
+	{
+	case EUFNNoiseBranch::First:
+		return A;
+	case EUFNNoiseBranch::Second:
+		return B;
+	case EUFNNoiseBranch::Third:
+		return C;
+	default:
+		return Union(Union(A, B), C);
+	}
+}
+
+FFloatInterval FUFNNoiseBounds::BlendAlpha(const FFloatInterval& Control, UCurveFloat* Curve)
+{
+	if (Curve || !IsBounded(Control))
+	{
+		return Unbounded();
+	}
+	return Bounded((Control.Min + 1.0f) / 2.0f, (Control.Max + 1.0f) / 2.0f);
+}
+
+FFloatInterval FUFNNoiseBounds::Blend(const FFloatInterval& A, const FFloatInterval& B, const FFloatInterval& Control, UCurveFloat* Curve)
+{
+	return Lerp(A, B, BlendAlpha(Control, Curve));
+}
+
+FFloatInterval FUFNNoiseBounds::RadialInterp(const FFloatInterval& A, const FFloatInterval& B, const FFloatInterval& Distance, float Radius, float Outer, float Falloff, FUFNInterpFunction Interp)
+{
+	const EUFNNoiseBranch Branch = GetRadialInterpBranch(Distance, Radius, Outer);
+	if (Branch == EUFNNoiseBranch::First)
+	{
+		return A;
+	}
+	if (Branch == EUFNNoiseBranch::Second)
+	{
+		return B;
+	}
+	if (!IsBounded(Distance))
+	{
+		return Unbounded();
+	}
+
+	// Only distances inside the band are blended, dividing by a negative falloff flips the range
+	const float AlphaLower = (FMath::Max(Distance.Min, Radius) - Radius) / Falloff;
+	const float AlphaUpper = (FMath::Min(Distance.Max, Outer) - Radius) / Falloff;
+	const FFloatInterval Blended = FUFNNoiseBounds::Interp(A, B, Bounded(FMath::Min(AlphaLower, AlphaUpper), FMath::Max(AlphaLower, AlphaUpper)), Interp);
+	return Branch == EUFNNoiseBranch::Falloff ? Blended : Union(Union(A, B), Blended);
+}
@@ -1,6 +1,8 @@
 #include "UFNRadialModule.h"
 #include "UnrealFastNoisePlugin.h"
 #include "UFNNoiseGenerator.h"
+#include "UFNNoiseProgram.h"
+#include "UFNNoiseProfiler.h"
 
 
 UUFNRadialModule::UUFNRadialModule(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
@@ -10,6 +12,7 @@ UUFNRadialModule::UUFNRadialModule(const FObjectInitializer& ObjectInitializer)
 
 float UUFNRadialModule::GetNoise3D(float aX, float aY, float aZ)
 {
+	UFN_NOISE_PROFILE_SCOPE(this);
 	if (!(inputModule1 && inputModule2)) {
 		return 0.0f;
 	}
@@ -70,6 +73,7 @@ float UUFNRadialModule::GetNoise3D(float aX, float aY, float aZ)
 
 float UUFNRadialModule::GetNoise2D(float aX, float aY)
 {
+	UFN_NOISE_PROFILE_SCOPE(this);
 	if (!(inputModule1 && inputModule2)) {
 		return 0.0f;
 	}
@@ -127,3 +131,53 @@ float UUFNRadialModule::GetNoise2D(float aX, float aY)
 
 }
 
+int32 UUFNRadialModule::CompileNoise(FUFNNoiseCompiler& compiler, const FUFNNoiseCoordinates& coords)
+{
+	if (!(inputModule1 && inputModule2)) {
+		return compiler.Constant(0.0f);
+	}
+
+	int32 dist = compiler.Distance(coords, origin);
+	int32 input1 = compiler.Compile(inputModule1, coords);
+	int32 input2 = compiler.Compile(inputModule2, coords);
+
+	if (interpType != ESelectInterpType::None)
+	{
+		// Both GetNoise2D and GetNoise3D ease SineOut in and out
+		ESelectInterpType type = interpType == ESelectInterpType::SineOut ? ESelectInterpType::SineInOut : interpType;
+		return compiler.RadialInterp(input1, input2, dist, radius, falloff, type, numSteps);
+	}
+
+	return compiler.Select(input1, input2, dist, radius);
+}
+
+FFloatInterval UUFNRadialModule::GetNoiseBounds2D(const FBox2D& region)
+{
+	if (!(inputModule1 && inputModule2)) {
+		return FUFNNoiseBounds::Point(0.0f);
+	}
+
+	FFloatInterval dist = FUFNNoiseBounds::Distance2D(FFloatInterval(region.Min.X, region.Max.X), FFloatInterval(region.Min.Y, region.Max.Y), origin.X, origin.Y);
+	return GetNoiseBounds(inputModule1->GetNoiseBounds2D(region), inputModule2->GetNoiseBounds2D(region), dist);
+}
+
+FFloatInterval UUFNRadialModule::GetNoiseBounds3D(const FBox& region)
+{
+	if (!(inputModule1 && inputModule2)) {
+		return FUFNNoiseBounds::Point(0.0f);
+	}
+
+	FFloatInterval dist = FUFNNoiseBounds::Distance3D(FFloatInterval(region.Min.X, region.Max.X), FFloatInterval(region.Min.Y, region.Max.Y), FFloatInterval(region.Min.Z, region.Max.Z), origin);
+	return GetNoiseBounds(inputModule1->GetNoiseBounds3D(region), inputModule2->GetNoiseBounds3D(region), dist);
+}
+
+FFloatInterval UUFNRadialModule::GetNoiseBounds(const FFloatInterval& input1, const FFloatInterval& input2, const FFloatInterval& dist) const
+{
+	if (interpType != ESelectInterpType::None)
+	{
+		ESelectInterpType type = interpType == ESelectInterpType::SineOut ? ESelectInterpType::SineInOut : interpType;
+		return FUFNNoiseBounds::RadialInterp(input1, input2, dist, radius, radius + falloff, falloff, FUFNNoiseCompiler::GetInterpFunction(type));
+	}
+
+	return FUFNNoiseBounds::Select(input1, input2, dist, radius);
+}
\ No newline at end of file
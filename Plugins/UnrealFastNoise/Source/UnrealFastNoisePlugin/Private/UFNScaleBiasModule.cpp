@@ -1,5 +1,7 @@
 #include "UFNScaleBiasModule.h"
 #include "UFNNoiseGenerator.h"
+#include "UFNNoiseProgram.h"
+#include "UFNNoiseProfiler.h"
 
 
 UUFNScaleBiasModule::UUFNScaleBiasModule(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
@@ -9,6 +11,7 @@ UUFNScaleBiasModule::UUFNScaleBiasModule(const FObjectInitializer& ObjectInitial
 
 float UUFNScaleBiasModule::GetNoise3D(float aX, float aY, float aZ)
 {
+	UFN_NOISE_PROFILE_SCOPE(this);
 	if (!(inputModule)) {
 		return 0.0f;
 	}
@@ -18,6 +21,7 @@ float UUFNScaleBiasModule::GetNoise3D(float aX, float aY, float aZ)
 
 float UUFNScaleBiasModule::GetNoise2D(float aX, float aY)
 {
+	UFN_NOISE_PROFILE_SCOPE(this);
 	if (!(inputModule)) {
 		return 0.0f;
 	}
@@ -25,3 +29,29 @@ float UUFNScaleBiasModule::GetNoise2D(float aX, float aY)
 	return (inputModule->GetNoise2D(aX, aY) * scale) + bias;
 }
 
+int32 UUFNScaleBiasModule::CompileNoise(FUFNNoiseCompiler& compiler, const FUFNNoiseCoordinates& coords)
+{
+	if (!(inputModule)) {
+		return compiler.Constant(0.0f);
+	}
+
+	return compiler.ScaleBias(compiler.Compile(inputModule, coords), scale, bias);
+}
+
+FFloatInterval UUFNScaleBiasModule::GetNoiseBounds2D(const FBox2D& region)
+{
+	if (!(inputModule)) {
+		return FUFNNoiseBounds::Point(0.0f);
+	}
+
+	return FUFNNoiseBounds::ScaleBias(inputModule->GetNoiseBounds2D(region), scale, bias);
+}
+
+FFloatInterval UUFNScaleBiasModule::GetNoiseBounds3D(const FBox& region)
+{
+	if (!(inputModule)) {
+		return FUFNNoiseBounds::Point(0.0f);
+	}
+
+	return FUFNNoiseBounds::ScaleBias(inputModule->GetNoiseBounds3D(region), scale, bias);
+}
\ No newline at end of file
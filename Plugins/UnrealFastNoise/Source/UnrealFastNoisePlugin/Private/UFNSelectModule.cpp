@@ -1,5 +1,7 @@
 #include "UFNSelectModule.h"
 #include "UFNNoiseGenerator.h"
+#include "UFNNoiseProgram.h"
+#include "UFNNoiseProfiler.h"
 
 
 UUFNSelectModule::UUFNSelectModule(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
@@ -9,6 +11,7 @@ UUFNSelectModule::UUFNSelectModule(const FObjectInitializer& ObjectInitializer)
 
 float UUFNSelectModule::GetNoise3D(float aX, float aY, float aZ)
 {
+	UFN_NOISE_PROFILE_SCOPE(this);
 	if (!(inputModule1 && inputModule2 && selectModule)) {
 		return 0.0f;
 	}
@@ -70,6 +73,7 @@ float UUFNSelectModule::GetNoise3D(float aX, float aY, float aZ)
 
 float UUFNSelectModule::GetNoise2D(float aX, float aY)
 {
+	UFN_NOISE_PROFILE_SCOPE(this);
 	if (!(inputModule1 && inputModule2 && selectModule)) {
 		return 0.0f;
 	}
@@ -129,3 +133,59 @@ float UUFNSelectModule::GetNoise2D(float aX, float aY)
 
 }
 
+int32 UUFNSelectModule::CompileNoise(FUFNNoiseCompiler& compiler, const FUFNNoiseCoordinates& coords)
+{
+	if (!(inputModule1 && inputModule2 && selectModule)) {
+		return compiler.Constant(0.0f);
+	}
+
+	int32 control = compiler.Compile(selectModule, coords);
+	int32 input1 = compiler.Compile(inputModule1, coords);
+	int32 input2 = compiler.Compile(inputModule2, coords);
+
+	if (interpType != ESelectInterpType::None)
+	{
+		// GetNoise2D eases SineOut in and out
+		ESelectInterpType type = (coords.Is2D() && interpType == ESelectInterpType::SineOut) ? ESelectInterpType::SineInOut : interpType;
+		return compiler.SelectInterp(input1, input2, control, threshold, falloff, type, numSteps);
+	}
+
+	return compiler.Select(input1, input2, control, threshold);
+}
+
+FFloatInterval UUFNSelectModule::GetNoiseBounds2D(const FBox2D& region)
+{
+	if (!(inputModule1 && inputModule2 && selectModule)) {
+		return FUFNNoiseBounds::Point(0.0f);
+	}
+
+	FFloatInterval control = selectModule->GetNoiseBounds2D(region);
+	FFloatInterval input1 = inputModule1->GetNoiseBounds2D(region);
+	FFloatInterval input2 = inputModule2->GetNoiseBounds2D(region);
+
+	if (interpType != ESelectInterpType::None)
+	{
+		ESelectInterpType type = interpType == ESelectInterpType::SineOut ? ESelectInterpType::SineInOut : interpType;
+		return FUFNNoiseBounds::SelectInterp(input1, input2, control, threshold - falloff, threshold + falloff, (threshold - falloff) / (2.0f * falloff), FUFNNoiseCompiler::GetInterpFunction(type));
+	}
+
+	return FUFNNoiseBounds::Select(input1, input2, control, threshold);
+}
+
+FFloatInterval UUFNSelectModule::GetNoiseBounds3D(const FBox& region)
+{
+	if (!(inputModule1 && inputModule2 && selectModule)) {
+		return FUFNNoiseBounds::Point(0.0f);
+	}
+
+	FFloatInterval control = selectModule->GetNoiseBounds3D(region);
+	FFloatInterval input1 = inputModule1->GetNoiseBounds3D(region);
+	FFloatInterval input2 = inputModule2->GetNoiseBounds3D(region);
+
+	if (interpType != ESelectInterpType::None)
+	{
+		return FUFNNoiseBounds::SelectInterp(input1, input2, control, threshold - falloff, threshold + falloff, (threshold - falloff) / (2.0f * falloff), FUFNNoiseCompiler::GetInterpFunction(interpType));
+	}
+
+	return FUFNNoiseBounds::Select(input1, input2, control, threshold);
+}
\ No newline at end of file
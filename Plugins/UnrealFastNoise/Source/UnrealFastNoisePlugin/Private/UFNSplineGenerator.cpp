@@ -1,56 +1,82 @@
 #include "UFNSplineGenerator.h"
 #include "UFNNoiseGenerator.h"
+#include "UFNNoiseProgram.h"
+#include "UFNNoiseProfiler.h"
 #include "Classes/Components/SplineComponent.h"
+#include "UObject/UObjectGlobals.h"
 
 
 UUFNSplineGenerator::UUFNSplineGenerator(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+	, SegmentLength(100.0f)
+	, GridOrigin(0.0f, 0.0f)
+	, CellSize(1.0f)
+	, GridSizeX(0)
+	, GridSizeY(0)
 {
 }
 
 float UUFNSplineGenerator::GetNoise3D(float aX, float aY, float aZ)
 {
-	float LocalMinDistance = MaximumDistance;
-	FVector WorldPoint = FVector(aX, aY, aZ);
-	for (auto Spline : Splines)
-	{
-		// May need the InputKey later, so instead of finding location, find input key to prevent multiple searches
-		float InputKey = Spline->FindInputKeyClosestToWorldLocation(WorldPoint);
-		FVector PointOnSpline = Spline->GetLocationAtSplineInputKey(InputKey, ESplineCoordinateSpace::World);
+	UFN_NOISE_PROFILE_SCOPE(this);
+	const FVector WorldPoint(aX, aY, aZ);
+	const float MinimumDistanceSquared = MinimumDistance > 0.0f ? FMath::Square(MinimumDistance) : 0.0f;
+	float ClosestDistanceSquared = FMath::Square(FMath::Max(MaximumDistance, 0.0f));
+	bool bFound = false;
 
-		float Distance = FVector::Dist(FVector(aX, aY, 0.0f), PointOnSpline);
+	if (GridSizeX > 0)
+	{
+		const int32 CellX = FMath::FloorToInt((aX - GridOrigin.X) / CellSize);
+		const int32 CellY = FMath::FloorToInt((aY - GridOrigin.Y) / CellSize);
 
-		// If we are inside a spline's width, distance from other splines is irrelevant so we can return early
-		if (Distance < MinimumDistance)
+		// Visit the cells in rings around the point's cell, from the first ring touching the grid. A cell in ring N is at
+		// least N - 1 cells away over XY alone, so once that is further than the closest segment so far nothing further
+		// can be closer, and nothing beyond MaximumDistance is visited at all
+		const int32 FirstRing = FMath::Max(FMath::Max(-CellX, CellX - (GridSizeX - 1)), FMath::Max(FMath::Max(-CellY, CellY - (GridSizeY - 1)), 0));
+		const int32 LastRing = FMath::Max(FMath::Max(CellX, GridSizeX - 1 - CellX), FMath::Max(CellY, GridSizeY - 1 - CellY));
+		for (int32 Ring = FirstRing; Ring <= LastRing; Ring++)
 		{
-			return 0.0f;
-		}
-		else {
-			LocalMinDistance = Distance < LocalMinDistance ? Distance : LocalMinDistance;
-			/*
-			This is not implemented
-
-			Inside convex curves we have the problem that a point may be closer to the sides than to the points
-			near the apex. This means there will be a seam down the centre rather than a soft gradient. We could
-			alleviate this by ensuring we use a point on the curve that has a (roughly) orthogonal tangent to
-			the vector between our world space point and the point on the tangent, but this doesn't seem to work.
-
-			FVector TangentOnSpline = Spline->GetTangentAtSplineInputKey(InputKey, ESplineCoordinateSpace::World);
-			TangentOnSpline.Normalize();
-			FVector WorldPointToSplinePoint = PointOnSpline - WorldPoint;
-			WorldPointToSplinePoint.Normalize();
-			if (FVector::DotProduct(TangentOnSpline, WorldPointToSplinePoint) <= TangentApproximation)
+			if (Ring > 0 && FMath::Square((Ring - 1) * CellSize) >= ClosestDistanceSquared)
 			{
-				LocalMinDistance = Distance < LocalMinDistance ? Distance : LocalMinDistance;
+				break;
 			}
-			else {
-				// Find a point on the curve with orthogonal tangent, and use distance to that instead.
-				return 0.0f;
-			}
-			*/
 
+			const int32 MinX = FMath::Max(CellX - Ring, 0);
+			const int32 MaxX = FMath::Min(CellX + Ring, GridSizeX - 1);
+			for (int32 Y = FMath::Max(CellY - Ring, 0); Y <= FMath::Min(CellY + Ring, GridSizeY - 1); Y++)
+			{
+				// The top and bottom rows of the ring are whole, the rows between only have their ends in it
+				const bool bEdgeRow = Y == CellY - Ring || Y == CellY + Ring;
+				for (int32 X = MinX; X <= MaxX; X++)
+				{
+					if (!bEdgeRow && X > CellX - Ring && X < CellX + Ring)
+					{
+						X = CellX + Ring - 1;
+						continue;
+					}
+
+					const int32 Cell = Y * GridSizeX + X;
+					for (int32 Index = CellStarts[Cell]; Index < CellStarts[Cell + 1]; Index++)
+					{
+						const FSplineSegment& Segment = Segments[CellSegments[Index]];
+						const float DistanceSquared = FVector::DistSquared(WorldPoint, FMath::ClosestPointOnSegment(WorldPoint, Segment.Start, Segment.End));
+
+						// If we are inside a spline's width, distance from other splines is irrelevant so we can return early
+						if (DistanceSquared < MinimumDistanceSquared)
+						{
+							return 0.0f;
+						}
+						if (DistanceSquared < ClosestDistanceSquared)
+						{
+							ClosestDistanceSquared = DistanceSquared;
+							bFound = true;
+						}
+					}
+				}
+			}
 		}
 	}
 
+	const float LocalMinDistance = bFound ? FMath::Min(FMath::Sqrt(ClosestDistanceSquared), MaximumDistance) : MaximumDistance;
 	if (FalloffCurve)
 	{
 		return FalloffCurve->GetFloatValue((LocalMinDistance - MinimumDistance) / (MaximumDistance - MinimumDistance));
@@ -64,8 +90,191 @@ float UUFNSplineGenerator::GetNoise2D(float aX, float aY)
 	return GetNoise3D(aX, aY, 0.0f);
 }
 
+FFloatInterval UUFNSplineGenerator::GetNoiseBounds2D(const FBox2D& region)
+{
+	return GetNoiseBounds3D(FBox(FVector(region.Min, 0.0f), FVector(region.Max, 0.0f)));
+}
+
+FFloatInterval UUFNSplineGenerator::GetNoiseBounds3D(const FBox& region)
+{
+	// The distance used never leaves [MinimumDistance, MaximumDistance], the curve can map it anywhere
+	if (FalloffCurve || !(MaximumDistance > MinimumDistance))
+	{
+		return FUFNNoiseBounds::Unbounded();
+	}
+
+	return FFloatInterval(0.0f, 1.0f);
+}
+
 void UUFNSplineGenerator::AddSpline(USplineComponent* Spline)
 {
 	Splines.Add(Spline);
+	RebuildSplineIndex();
 	//GLog->Log(FString::Printf(TEXT("Number of Splines: %d, ID %d"), Splines.Num(), GetUniqueID()));
-}
\ No newline at end of file
+}
+
+void UUFNSplineGenerator::PostLoad()
+{
+	Super::PostLoad();
+	RebuildSplineIndex();
+}
+
+void UUFNSplineGenerator::PostDuplicate(bool bDuplicateForPIE)
+{
+	Super::PostDuplicate(bDuplicateForPIE);
+	RebuildSplineIndex();
+}
+
+void UUFNSplineGenerator::BeginDestroy()
+{
+	UnwatchSplines();
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(ObjectPropertyChangedHandle);
+	ObjectPropertyChangedHandle.Reset();
+#endif
+	Super::BeginDestroy();
+}
+
+#if WITH_EDITOR
+void UUFNSplineGenerator::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	RebuildSplineIndex();
+}
+
+void UUFNSplineGenerator::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	USplineComponent* Spline = Cast<USplineComponent>(Object);
+	if (Spline && Splines.Contains(Spline))
+	{
+		RebuildSplineIndex();
+	}
+}
+#endif
+
+void UUFNSplineGenerator::OnSplineTransformUpdated(USceneComponent* Component, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	RebuildSplineIndex();
+}
+
+void UUFNSplineGenerator::UnwatchSplines()
+{
+	for (const TWeakObjectPtr<USplineComponent>& Spline : WatchedSplines)
+	{
+		if (Spline.IsValid())
+		{
+			Spline->TransformUpdated.RemoveAll(this);
+		}
+	}
+	WatchedSplines.Reset();
+}
+
+void UUFNSplineGenerator::RebuildSplineIndex()
+{
+	UnwatchSplines();
+	for (USplineComponent* Spline : Splines)
+	{
+		if (Spline && !WatchedSplines.Contains(Spline))
+		{
+			Spline->TransformUpdated.AddUObject(this, &UUFNSplineGenerator::OnSplineTransformUpdated);
+			WatchedSplines.Add(Spline);
+		}
+	}
+#if WITH_EDITOR
+	if (!ObjectPropertyChangedHandle.IsValid() && Splines.Num() > 0)
+	{
+		ObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddUObject(this, &UUFNSplineGenerator::OnObjectPropertyChanged);
+	}
+#endif
+
+	Segments.Reset();
+	CellStarts.Reset();
+	CellSegments.Reset();
+	GridSizeX = GridSizeY = 0;
+
+	// Flatten the splines in world space. Their points stay segment ends, so the corners of linear splines are exact
+	const float MaxSegmentLength = FMath::Max(SegmentLength, 1.0f);
+	for (USplineComponent* Spline : Splines)
+	{
+		const int32 NumPoints = Spline ? Spline->GetNumberOfSplinePoints() : 0;
+		if (NumPoints == 0)
+		{
+			continue;
+		}
+
+		FVector Previous = Spline->GetLocationAtSplinePoint(0, ESplineCoordinateSpace::World);
+		const int32 NumSplineSegments = Spline->IsClosedLoop() ? NumPoints : NumPoints - 1;
+		if (NumSplineSegments == 0)
+		{
+			Segments.Add({ Previous, Previous });
+		}
+
+		for (int32 SplineSegment = 0; SplineSegment < NumSplineSegments; SplineSegment++)
+		{
+			const float StartDistance = Spline->GetDistanceAlongSplineAtSplinePoint(SplineSegment);
+			const float EndDistance = SplineSegment + 1 < NumPoints ? Spline->GetDistanceAlongSplineAtSplinePoint(SplineSegment + 1) : Spline->GetSplineLength();
+			const int32 Steps = FMath::Max(FMath::CeilToInt((EndDistance - StartDistance) / MaxSegmentLength), 1);
+			for (int32 Step = 1; Step <= Steps; Step++)
+			{
+				const FVector Next = Step == Steps ?
+					Spline->GetLocationAtSplinePoint((SplineSegment + 1) % NumPoints, ESplineCoordinateSpace::World) :
+					Spline->GetLocationAtDistanceAlongSpline(FMath::Lerp(StartDistance, EndDistance, (float)Step / Steps), ESplineCoordinateSpace::World);
+				Segments.Add({ Previous, Next });
+				Previous = Next;
+			}
+		}
+	}
+
+	if (Segments.Num() == 0)
+	{
+		return;
+	}
+
+	FBox2D Bounds(ForceInit);
+	for (const FSplineSegment& Segment : Segments)
+	{
+		Bounds += FVector2D(Segment.Start);
+		Bounds += FVector2D(Segment.End);
+	}
+
+	// About one cell per segment, and no smaller than a segment so each only overlaps a few
+	const FVector2D Size = Bounds.GetSize();
+	CellSize = FMath::Max(FMath::Sqrt(Size.X * Size.Y / Segments.Num()), MaxSegmentLength);
+	GridOrigin = Bounds.Min;
+	GridSizeX = FMath::FloorToInt(Size.X / CellSize) + 1;
+	GridSizeY = FMath::FloorToInt(Size.Y / CellSize) + 1;
+
+	auto ForEachCell = [this](const FSplineSegment& Segment, auto&& Function)
+	{
+		const int32 MinX = FMath::Clamp(FMath::FloorToInt((FMath::Min(Segment.Start.X, Segment.End.X) - GridOrigin.X) / CellSize), 0, GridSizeX - 1);
+		const int32 MaxX = FMath::Clamp(FMath::FloorToInt((FMath::Max(Segment.Start.X, Segment.End.X) - GridOrigin.X) / CellSize), 0, GridSizeX - 1);
+		const int32 MinY = FMath::Clamp(FMath::FloorToInt((FMath::Min(Segment.Start.Y, Segment.End.Y) - GridOrigin.Y) / CellSize), 0, GridSizeY - 1);
+		const int32 MaxY = FMath::Clamp(FMath::FloorToInt((FMath::Max(Segment.Start.Y, Segment.End.Y) - GridOrigin.Y) / CellSize), 0, GridSizeY - 1);
+		for (int32 Y = MinY; Y <= MaxY; Y++)
+		{
+			for (int32 X = MinX; X <= MaxX; X++)
+			{
+				Function(Y * GridSizeX + X);
+			}
+		}
+	};
+
+	// Count the segments of each cell, turn the counts into offsets, then fill the cells in
+	const int32 NumCells = GridSizeX * GridSizeY;
+	CellStarts.Init(0, NumCells + 1);
+	for (const FSplineSegment& Segment : Segments)
+	{
+		ForEachCell(Segment, [this](int32 Cell) { CellStarts[Cell + 1]++; });
+	}
+	for (int32 Cell = 0; Cell < NumCells; Cell++)
+	{
+		CellStarts[Cell + 1] += CellStarts[Cell];
+	}
+
+	TArray<int32> CellEnds(CellStarts.GetData(), NumCells);
+	CellSegments.SetNumUninitialized(CellStarts[NumCells]);
+	for (int32 Index = 0; Index < Segments.Num(); Index++)
+	{
+		ForEachCell(Segments[Index], [this, &CellEnds, Index](int32 Cell) { CellSegments[CellEnds[Cell]++] = Index; });
+	}
+}
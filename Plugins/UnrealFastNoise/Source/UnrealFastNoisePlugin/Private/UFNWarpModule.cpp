@@ -1,6 +1,18 @@
 #include "UFNWarpModule.h"
 #include "UFNNoiseGenerator.h"
+#include "UFNNoiseProgram.h"
+#include "UFNNoiseProfiler.h"
 
+// Regions sampled by the warp, from the bounds of each coordinate
+static FBox2D MakeRegion(const FFloatInterval& x, const FFloatInterval& y)
+{
+	return FBox2D(FVector2D(x.Min, y.Min), FVector2D(x.Max, y.Max));
+}
+
+static FBox MakeRegion(const FFloatInterval& x, const FFloatInterval& y, const FFloatInterval& z)
+{
+	return FBox(FVector(x.Min, y.Min, z.Min), FVector(x.Max, y.Max, z.Max));
+}
 
 UUFNWarpModule::UUFNWarpModule(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -9,6 +21,7 @@ UUFNWarpModule::UUFNWarpModule(const FObjectInitializer& ObjectInitializer) : Su
 
 float UUFNWarpModule::GetNoise3D(float aX, float aY, float aZ)
 {
+	UFN_NOISE_PROFILE_SCOPE(this);
 	if (!(inputModule)) {
 		return 0.0f;
 	}
@@ -32,6 +45,7 @@ float UUFNWarpModule::GetNoise3D(float aX, float aY, float aZ)
 
 float UUFNWarpModule::GetNoise2D(float aX, float aY)
 {
+	UFN_NOISE_PROFILE_SCOPE(this);
 	if ((!(inputModule)) || !warpModule) {
 		return 0.0f;
 	}
@@ -53,3 +67,122 @@ float UUFNWarpModule::GetNoise2D(float aX, float aY)
 
 }
 
+int32 UUFNWarpModule::CompileNoise(FUFNNoiseCompiler& compiler, const FUFNNoiseCoordinates& coords)
+{
+	if (coords.Is2D())
+	{
+		if ((!(inputModule)) || !warpModule) {
+			return compiler.Constant(0.0f);
+		}
+
+		FUFNNoiseCoordinates offset1 = FUFNNoiseCoordinates(compiler.AddConstant(coords.X, Iteration1XOffset), compiler.AddConstant(coords.Y, Iteration1YOffset));
+		int32 qX = compiler.Compile(warpModule, coords);
+		int32 qY = compiler.Compile(warpModule, offset1);
+
+		FUFNNoiseCoordinates warped = FUFNNoiseCoordinates(compiler.MultiplyAdd(coords.X, qX, multiplier), compiler.MultiplyAdd(coords.Y, qY, multiplier));
+		if (warpIterations == EWarpIterations::One)
+		{
+			return compiler.Compile(inputModule, warped);
+		}
+
+		FUFNNoiseCoordinates offset21 = FUFNNoiseCoordinates(compiler.AddConstant(warped.X, Iteration2XOffset1), compiler.AddConstant(warped.Y, Iteration2YOffset1));
+		FUFNNoiseCoordinates offset22 = FUFNNoiseCoordinates(compiler.AddConstant(warped.X, Iteration2XOffset2), compiler.AddConstant(warped.Y, Iteration2YOffset2));
+		int32 rX = compiler.Compile(warpModule, offset21);
+		int32 rY = compiler.Compile(warpModule, offset22);
+
+		return compiler.Compile(inputModule, FUFNNoiseCoordinates(compiler.MultiplyAdd(coords.X, rX, multiplier), compiler.MultiplyAdd(coords.Y, rY, multiplier)));
+	}
+
+	if (!(inputModule)) {
+		return compiler.Constant(0.0f);
+	}
+
+	// GetNoise3D reads warpModule without checking it, leave that to it
+	if (!warpModule) {
+		return Super::CompileNoise(compiler, coords);
+	}
+
+	FUFNNoiseCoordinates offset1 = FUFNNoiseCoordinates(compiler.AddConstant(coords.X, Iteration1XOffset), compiler.AddConstant(coords.Y, Iteration1YOffset), compiler.AddConstant(coords.Z, Iteration1ZOffset));
+	FUFNNoiseCoordinates offset1b = FUFNNoiseCoordinates(compiler.AddConstant(offset1.X, 0.5f), compiler.AddConstant(offset1.Y, 0.5f), compiler.AddConstant(offset1.Z, 2.4f));
+	int32 qX = compiler.Compile(warpModule, coords);
+	int32 qY = compiler.Compile(warpModule, offset1);
+	int32 qZ = compiler.Compile(warpModule, offset1b);
+
+	FUFNNoiseCoordinates warped = FUFNNoiseCoordinates(compiler.MultiplyAdd(coords.X, qX, multiplier), compiler.MultiplyAdd(coords.Y, qY, multiplier), compiler.MultiplyAdd(coords.Z, qZ, multiplier));
+	if (warpIterations == EWarpIterations::One)
+	{
+		return compiler.Compile(inputModule, warped);
+	}
+
+	FUFNNoiseCoordinates offset21 = FUFNNoiseCoordinates(compiler.AddConstant(warped.X, Iteration2XOffset1), compiler.AddConstant(warped.Y, Iteration2YOffset1), compiler.AddConstant(warped.Z, Iteration2ZOffset1));
+	FUFNNoiseCoordinates offset22 = FUFNNoiseCoordinates(compiler.AddConstant(warped.X, Iteration2XOffset2), compiler.AddConstant(warped.Y, Iteration2YOffset2), compiler.AddConstant(warped.Z, Iteration2ZOffset2));
+	FUFNNoiseCoordinates offset22b = FUFNNoiseCoordinates(compiler.AddConstant(compiler.AddConstant(warped.X, 3.4f), Iteration2XOffset2), compiler.AddConstant(offset22.Y, 4.6f), offset22.Z);
+	int32 rX = compiler.Compile(warpModule, offset21);
+	int32 rY = compiler.Compile(warpModule, offset22);
+	int32 rZ = compiler.AddConstant(compiler.Compile(warpModule, offset22b), 2.3f);
+
+	return compiler.Compile(inputModule, FUFNNoiseCoordinates(compiler.MultiplyAdd(coords.X, rX, multiplier), compiler.MultiplyAdd(coords.Y, rY, multiplier), compiler.MultiplyAdd(coords.Z, rZ, multiplier)));
+}
+
+FFloatInterval UUFNWarpModule::GetNoiseBounds2D(const FBox2D& region)
+{
+	if ((!(inputModule)) || !warpModule) {
+		return FUFNNoiseBounds::Point(0.0f);
+	}
+
+	// Follows CompileNoise, the warped region is the region moved by up to multiplier times the warp's bounds
+	FFloatInterval x = FFloatInterval(region.Min.X, region.Max.X);
+	FFloatInterval y = FFloatInterval(region.Min.Y, region.Max.Y);
+	FFloatInterval qX = warpModule->GetNoiseBounds2D(region);
+	FFloatInterval qY = warpModule->GetNoiseBounds2D(MakeRegion(FUFNNoiseBounds::AddConstant(x, Iteration1XOffset), FUFNNoiseBounds::AddConstant(y, Iteration1YOffset)));
+
+	FFloatInterval warpedX = FUFNNoiseBounds::MultiplyAdd(x, qX, multiplier);
+	FFloatInterval warpedY = FUFNNoiseBounds::MultiplyAdd(y, qY, multiplier);
+	if (warpIterations == EWarpIterations::One)
+	{
+		return inputModule->GetNoiseBounds2D(MakeRegion(warpedX, warpedY));
+	}
+
+	FFloatInterval rX = warpModule->GetNoiseBounds2D(MakeRegion(FUFNNoiseBounds::AddConstant(warpedX, Iteration2XOffset1), FUFNNoiseBounds::AddConstant(warpedY, Iteration2YOffset1)));
+	FFloatInterval rY = warpModule->GetNoiseBounds2D(MakeRegion(FUFNNoiseBounds::AddConstant(warpedX, Iteration2XOffset2), FUFNNoiseBounds::AddConstant(warpedY, Iteration2YOffset2)));
+
+	return inputModule->GetNoiseBounds2D(MakeRegion(FUFNNoiseBounds::MultiplyAdd(x, rX, multiplier), FUFNNoiseBounds::MultiplyAdd(y, rY, multiplier)));
+}
+
+FFloatInterval UUFNWarpModule::GetNoiseBounds3D(const FBox& region)
+{
+	if (!(inputModule)) {
+		return FUFNNoiseBounds::Point(0.0f);
+	}
+
+	if (!warpModule) {
+		return FUFNNoiseBounds::Unbounded();
+	}
+
+	FFloatInterval x = FFloatInterval(region.Min.X, region.Max.X);
+	FFloatInterval y = FFloatInterval(region.Min.Y, region.Max.Y);
+	FFloatInterval z = FFloatInterval(region.Min.Z, region.Max.Z);
+	FFloatInterval offset1X = FUFNNoiseBounds::AddConstant(x, Iteration1XOffset);
+	FFloatInterval offset1Y = FUFNNoiseBounds::AddConstant(y, Iteration1YOffset);
+	FFloatInterval offset1Z = FUFNNoiseBounds::AddConstant(z, Iteration1ZOffset);
+	FFloatInterval qX = warpModule->GetNoiseBounds3D(region);
+	FFloatInterval qY = warpModule->GetNoiseBounds3D(MakeRegion(offset1X, offset1Y, offset1Z));
+	FFloatInterval qZ = warpModule->GetNoiseBounds3D(MakeRegion(FUFNNoiseBounds::AddConstant(offset1X, 0.5f), FUFNNoiseBounds::AddConstant(offset1Y, 0.5f), FUFNNoiseBounds::AddConstant(offset1Z, 2.4f)));
+
+	FFloatInterval warpedX = FUFNNoiseBounds::MultiplyAdd(x, qX, multiplier);
+	FFloatInterval warpedY = FUFNNoiseBounds::MultiplyAdd(y, qY, multiplier);
+	FFloatInterval warpedZ = FUFNNoiseBounds::MultiplyAdd(z, qZ, multiplier);
+	if (warpIterations == EWarpIterations::One)
+	{
+		return inputModule->GetNoiseBounds3D(MakeRegion(warpedX, warpedY, warpedZ));
+	}
+
+	FFloatInterval offset22X = FUFNNoiseBounds::AddConstant(FUFNNoiseBounds::AddConstant(warpedX, 3.4f), Iteration2XOffset2);
+	FFloatInterval offset22Y = FUFNNoiseBounds::AddConstant(FUFNNoiseBounds::AddConstant(warpedY, Iteration2YOffset2), 4.6f);
+	FFloatInterval offset22Z = FUFNNoiseBounds::AddConstant(warpedZ, Iteration2ZOffset2);
+	FFloatInterval rX = warpModule->GetNoiseBounds3D(MakeRegion(FUFNNoiseBounds::AddConstant(warpedX, Iteration2XOffset1), FUFNNoiseBounds::AddConstant(warpedY, Iteration2YOffset1), FUFNNoiseBounds::AddConstant(warpedZ, Iteration2ZOffset1)));
+	FFloatInterval rY = warpModule->GetNoiseBounds3D(MakeRegion(FUFNNoiseBounds::AddConstant(warpedX, Iteration2XOffset2), FUFNNoiseBounds::AddConstant(warpedY, Iteration2YOffset2), offset22Z));
+	FFloatInterval rZ = FUFNNoiseBounds::AddConstant(warpModule->GetNoiseBounds3D(MakeRegion(offset22X, offset22Y, offset22Z)), 2.3f);
+
+	return inputModule->GetNoiseBounds3D(MakeRegion(FUFNNoiseBounds::MultiplyAdd(x, rX, multiplier), FUFNNoiseBounds::MultiplyAdd(y, rY, multiplier), FUFNNoiseBounds::MultiplyAdd(z, rZ, multiplier)));
+}
\ No newline at end of file
@@ -32,6 +32,9 @@
 #include "CoreMinimal.h"
 #include "Object.h"
 #include "UFNNoiseGenerator.h"
+#include "UFNNoiseProfiler.h"
+#include "FastNoiseBatch.h"
+#include "FastNoisePermutation.h"
 #include "FastNoise.generated.h"
 
 UENUM(BlueprintType)
@@ -82,6 +85,14 @@ enum ECellularReturnType { CellValue, NoiseLookup, Distance, Distance2, Distance
 UENUM(BlueprintType)
 enum EPositionWarpType { None, Regular, Fractal };
 UENUM(BlueprintType)
+enum class ELatticeHash : uint8
+{
+	// Lattice corners hashed through the seed's permutation tables
+	Permutation,
+	// Lattice corners hashed arithmetically with a multiply-xorshift, no table lookups
+	Integer
+};
+UENUM(BlueprintType)
 enum class ESelectInterpType : uint8
 {
 	None,
@@ -99,13 +110,13 @@ enum class ESelectInterpType : uint8
 };
 
 
-UCLASS()
-class UNREALFASTNOISEPLUGIN_API UFastNoise : public UUFNNoiseGenerator
+// The noise itself, a plain value type holding the permutation tables and settings. Evaluation is const and doesn't
+// touch anything outside the object, so one FFastNoise can be sampled from any number of threads at once as long as
+// nothing changes its settings meanwhile. Background generation should use this rather than UFastNoise
+class UNREALFASTNOISEPLUGIN_API FFastNoise
 {
-	GENERATED_UCLASS_BODY()
 public:
-	//FastNoise(int seed = 1337) { SetSeed(seed);  };
-	~UFastNoise() { delete m_cellularNoiseLookup; }
+	explicit FFastNoise(int seed = 1337);
 
 	// Returns seed used for all noise types
 	void SetSeed(int seed);
@@ -116,7 +127,7 @@ public:
 
 	// Sets frequency for all noise types
 	// Default: 0.01
-	void SetFrequency(float frequency) { m_frequency = frequency; }
+	void SetFrequency(float frequency) { m_frequency = frequency; BindKernels(); }
 
 	// Changes the interpolation method used to smooth between noise values
 	// Possible interpolation methods (lowest to highest quality) :
@@ -125,40 +136,47 @@ public:
 	// - Quintic
 	// Used in Value, Gradient Noise and Position Warping
 	// Default: Quintic
-	void SetInterp(EInterp interp) { m_interp = interp; }
+	void SetInterp(EInterp interp) { m_interp = interp; BindKernels(); }
 
 	// Sets noise return type of GetNoise(...)
 	// Default: Simplex
-	void SetNoiseType(ENoiseType noiseType) { m_noiseType = noiseType; }
+	void SetNoiseType(ENoiseType noiseType) { m_noiseType = noiseType; BindKernels(); }
+
+	// Sets how lattice corners are hashed. Integer hashing gives different noise for the same seed, but the batch
+	// kernels work it out with integer multiplies rather than table gathers, which is much faster on wide SIMD
+	// Default: Permutation
+	void SetLatticeHash(ELatticeHash latticeHash) { m_latticeHash = latticeHash; BindKernels(); }
+	ELatticeHash GetLatticeHash() const { return m_latticeHash; }
 
 	// Sets octave count for all fractal noise types
 	// Default: 3
-	void SetFractalOctaves(unsigned int octaves) { m_octaves = octaves; CalculateFractalBounding(); }
+	void SetFractalOctaves(unsigned int octaves) { m_octaves = octaves; CalculateFractalBounding(); BindKernels(); }
 
 	// Sets octave lacunarity for all fractal noise types
 	// Default: 2.0
-	void SetFractalLacunarity(float lacunarity) { m_lacunarity = lacunarity; }
+	void SetFractalLacunarity(float lacunarity) { m_lacunarity = lacunarity; BindKernels(); }
 
 	// Sets octave gain for all fractal noise types
 	// Default: 0.5
-	void SetFractalGain(float gain) { m_gain = gain; CalculateFractalBounding(); }
+	void SetFractalGain(float gain) { m_gain = gain; CalculateFractalBounding(); BindKernels(); }
 
 	// Sets method for combining octaves in all fractal noise types
 	// Default: FBM
-	void SetFractalType(EFractalType fractalType) { m_fractalType = fractalType; }
+	void SetFractalType(EFractalType fractalType) { m_fractalType = fractalType; BindKernels(); }
 
 	// Sets return type from cellular noise calculations
 	// Note: NoiseLookup requires another FastNoise object be set with SetCellularNoiseLookup() to function
 	// Default: CellValue
-	void SetCellularDistanceFunction(ECellularDistanceFunction cellularDistanceFunction) { m_cellularDistanceFunction = cellularDistanceFunction; }
+	void SetCellularDistanceFunction(ECellularDistanceFunction cellularDistanceFunction) { m_cellularDistanceFunction = cellularDistanceFunction; BindKernels(); }
 
 	// Sets distance function used in cellular noise calculations
 	// Default: Euclidean
-	void SetCellularReturnType(ECellularReturnType cellularReturnType) { m_cellularReturnType = cellularReturnType; }
+	void SetCellularReturnType(ECellularReturnType cellularReturnType) { m_cellularReturnType = cellularReturnType; BindKernels(); }
 
 	// Noise used to calculate a cell value if cellular return type is NoiseLookup
 	// The lookup value is acquired through GetNoise() so ensure you SetNoiseType() on the noise lookup, value, gradient or simplex is recommended
-	void SetCellularNoiseLookup(UFastNoise* noise) { m_cellularNoiseLookup = noise; }
+	// Not owned, the lookup has to outlive this and any copies of it
+	void SetCellularNoiseLookup(const FFastNoise* noise) { m_cellularNoiseLookup = noise; }
 
 	// Sets the maximum warp distance from original location when using PositionWarp{Fractal}(...)
 	// Default: 1.0
@@ -166,62 +184,123 @@ public:
 	void SetPositionWarpType(EPositionWarpType positionWarpType) { m_positionWarpType = positionWarpType; }
 
 	//2D												
-	float GetValue(float x, float y);
-	float GetValueFractal(float x, float y);
+	float GetValue(float x, float y) const;
+	float GetValueFractal(float x, float y) const;
+
+	float GetGradient(float x, float y) const;
+	float GetGradientFractal(float x, float y) const;
+
+	float GetSimplex(float x, float y) const;
+	float GetSimplexFractal(float x, float y) const;
 
-	float GetGradient(float x, float y);
-	float GetGradientFractal(float x, float y);
+	float GetCellular(float x, float y) const;
 
-	float GetSimplex(float x, float y);
-	float GetSimplexFractal(float x, float y);
+	float GetWhiteNoise(float x, float y) const;
+	float GetWhiteNoiseInt(int x, int y) const;
 
-	float GetCellular(float x, float y);
+	float GetNoise(float x, float y) const;
+	float GetNoise2D(float x, float y) const;
 
-	float GetWhiteNoise(float x, float y);
-	float GetWhiteNoiseInt(int x, int y);
+	// GetNoise2D and its gradient with respect to x and y from a single evaluation, for slopes and normals
+	float GetNoise2DWithGradient(float x, float y, FVector2D& outGradient) const;
 
-	FORCEINLINE float GetNoise(float x, float y);
-	FORCEINLINE float GetNoise2D(float x, float y);
-	FORCEINLINE FVector GetNoise2DDeriv(float x, float y);
+	// The value and gradient from GetNoise2DWithGradient packed as (value, d/dx, d/dy)
+	FVector GetNoise2DDeriv(float x, float y) const;
 
-	void PositionWarp(float& x, float& y);
-	void PositionWarpFractal(float& x, float& y);
+	void PositionWarp(float& x, float& y) const;
+	void PositionWarpFractal(float& x, float& y) const;
 
 	//3D												
-	float GetValue(float x, float y, float z);
-	float GetValueFractal(float x, float y, float z);
+	float GetValue(float x, float y, float z) const;
+	float GetValueFractal(float x, float y, float z) const;
+
+	float GetGradient(float x, float y, float z) const;
+	float GetGradientFractal(float x, float y, float z) const;
+
+	float GetSimplex(float x, float y, float z) const;
+	float GetSimplexFractal(float x, float y, float z) const;
+
+	float GetCellular(float x, float y, float z) const;
+
+	float GetWhiteNoise(float x, float y, float z) const;
+	float GetWhiteNoiseInt(int x, int y, int z) const;
+
+	float GetNoise(float x, float y, float z) const;
+	float GetNoise3D(float x, float y, float z) const;
+
+	// GetNoise3D and its gradient with respect to x, y and z from a single evaluation, for slopes and normals
+	float GetNoise3DWithGradient(float x, float y, float z, FVector& outGradient) const;
+
+	void PositionWarp(float& x, float& y, float& z) const;
+	void PositionWarpFractal(float& x, float& y, float& z) const;
+
+	// GetNoise2D/GetNoise3D for samples footprint apart, in the same units as x, y and z. Fractal octaves above half
+	// the sample rate would only alias, so they are skipped and the highest one left fades out as the footprint grows.
+	// A footprint of 0 keeps every octave
+	float GetNoise2DAdaptive(float x, float y, float footprint) const;
+	float GetNoise3DAdaptive(float x, float y, float z, float footprint) const;
 
-	float GetGradient(float x, float y, float z);
-	float GetGradientFractal(float x, float y, float z);
+	// The octaves the Adaptive and batch functions evaluate for a footprint and the weight of the last of them
+	void GetOctaveCutoff(float footprint, unsigned int& outOctaves, float& outLastOctaveWeight) const;
 
-	float GetSimplex(float x, float y, float z);
-	float GetSimplexFractal(float x, float y, float z);
+	// Batch evaluation, the same as calling GetNoise2DAdaptive/GetNoise3DAdaptive for each point but Value, Gradient,
+	// Simplex (and their fractals) and Cellular are evaluated several points at a time using SSE4.1 or AVX2 when the
+	// CPU supports it. Results match the single point functions to within 1e-5. With position warping the points are
+	// warped and evaluated a cache sized chunk at a time, the coordinates passed in aren't changed. Cellular NoiseLookup
+	// and white noise fall back to single point evaluation
+	void GetNoise2DBatch(const float* x, const float* y, float* out, int32 n, float footprint = 0.0f) const;
+	void GetNoise3DBatch(const float* x, const float* y, const float* z, float* out, int32 n, float footprint = 0.0f) const;
 
-	float GetCellular(float x, float y, float z);
+	// Fill a regular grid, extent.X by extent.Y samples from origin spaced by step, with x varying fastest in outValues.
+	// Matches calling GetNoise2DAdaptive/GetNoise3DAdaptive on each point to within FASTNOISE_BATCH_TOLERANCE, the lattice
+	// lookups and weights shared along a row are only worked out once per row and the row is evaluated with the batch kernels.
+	// A seedOffset fills the grid as the generator reseeded with GetSeed() + seedOffset would. That reseeds on every
+	// call, so when filling many grids on one seed keep a WithSeedOffset generator around and fill from it instead
+	void FillNoiseGrid2D(const FVector2D& origin, const FVector2D& step, const FIntPoint& extent, float* outValues, float footprint = 0.0f, int32 seedOffset = 0) const;
+	void FillNoiseGrid3D(const FVector& origin, const FVector& step, const FIntVector& extent, float* outValues, float footprint = 0.0f, int32 seedOffset = 0) const;
 
-	float GetWhiteNoise(float x, float y, float z);
-	float GetWhiteNoiseInt(int x, int y, int z);
+	// PositionWarp/PositionWarpFractal for n points, warping the coordinate arrays in place several points at a time.
+	// Works whatever the noise type, the results match the single point functions to within 1e-5
+	void PositionWarpBatch(float* x, float* y, int32 n) const;
+	void PositionWarpFractalBatch(float* x, float* y, int32 n) const;
+	void PositionWarpBatch(float* x, float* y, float* z, int32 n) const;
+	void PositionWarpFractalBatch(float* x, float* y, float* z, int32 n) const;
 
-	FORCEINLINE float GetNoise(float x, float y, float z);
-	FORCEINLINE float GetNoise3D(float x, float y, float z);
+	// A copy of this generator reseeded with GetSeed() + seedOffset. The copy shares its permutation tables with
+	// every other live generator on that seed, the tables are only built when no generator holds them
+	FFastNoise WithSeedOffset(int32 seedOffset) const;
 
-	void PositionWarp(float& x, float& y, float& z);
-	void PositionWarpFractal(float& x, float& y, float& z);
+	// True if the WithGradient functions work the gradient out analytically. That covers Gradient and Simplex noise
+	// and their fractals without position warping, anything else falls back to central differences
+	bool SupportsAnalyticGradient() const;
+
+	// Conservative range of every GetNoise function, the batch ones included, whatever the input. Cellular distance
+	// return types have no useful bound, they give TNumericLimits' Lowest and Max
+	FFloatInterval GetNoiseBounds() const;
 
 	//4D
-	float GetSimplex(float x, float y, float z, float w);
+	float GetSimplex(float x, float y, float z, float w) const;
 
-	float GetWhiteNoise(float x, float y, float z, float w);
-	float GetWhiteNoiseInt(int x, int y, int z, int w);
+	float GetWhiteNoise(float x, float y, float z, float w) const;
+	float GetWhiteNoiseInt(int x, int y, int z, int w) const;
 
 protected:
-	unsigned char m_perm[512];
-	unsigned char m_perm12[512];
+	// The seed's permutation tables, shared with every other generator using the same seed
+	FFastNoisePermutationPtr m_permutation;
+
+	// m_permutation's Perm and Perm12, kept alongside so the lattice hashes don't go through the shared pointer
+	const unsigned char* m_perm = nullptr;
+	const unsigned char* m_perm12 = nullptr;
+
+	// The batch kernels compiled for the current settings, rebound whenever a setting changes
+	// so evaluation doesn't switch on the noise type, fractal type or interpolation
+	FFastNoiseBatchKernels m_kernels;
 
 	int m_seed = 1337;
 	float m_frequency = 0.01f;
 	EInterp m_interp = EInterp::InterpQuintic;
 	ENoiseType m_noiseType = ENoiseType::Simplex;
+	ELatticeHash m_latticeHash = ELatticeHash::Permutation;
 
 	EPositionWarpType m_positionWarpType = EPositionWarpType::None;
 
@@ -245,66 +324,214 @@ protected:
 
 	ECellularDistanceFunction m_cellularDistanceFunction = ECellularDistanceFunction::Euclidean;
 	ECellularReturnType m_cellularReturnType = ECellularReturnType::CellValue;
-	UFastNoise* m_cellularNoiseLookup = nullptr;
+	const FFastNoise* m_cellularNoiseLookup = nullptr;
 
 	float m_positionWarpAmp = 1.0f / 0.45f;
 
 	//2D
-	float SingleValueFractalFBM(float x, float y);
-	float SingleValueFractalBillow(float x, float y);
-	float SingleValueFractalRigidMulti(float x, float y);
-	float SingleValue(unsigned char offset, float x, float y);
+	template<EInterp Interp> float SingleValueFractalFBM(float x, float y, unsigned int octaves, float lastOctaveWeight) const;
+	template<EInterp Interp> float SingleValueFractalBillow(float x, float y, unsigned int octaves, float lastOctaveWeight) const;
+	template<EInterp Interp> float SingleValueFractalRigidMulti(float x, float y, unsigned int octaves, float lastOctaveWeight) const;
+	float SingleValue(unsigned char offset, float x, float y) const;
+	template<EInterp Interp> float SingleValue(unsigned char offset, float x, float y) const;
 
-	float SingleGradientFractalFBM(float x, float y);
-	float SingleGradientFractalBillow(float x, float y);
-	float SingleGradientFractalRigidMulti(float x, float y);
-	float SingleGradient(unsigned char offset, float x, float y);
+	template<EInterp Interp> float SingleGradientFractalFBM(float x, float y, unsigned int octaves, float lastOctaveWeight) const;
+	template<EInterp Interp> float SingleGradientFractalBillow(float x, float y, unsigned int octaves, float lastOctaveWeight) const;
+	template<EInterp Interp> float SingleGradientFractalRigidMulti(float x, float y, unsigned int octaves, float lastOctaveWeight) const;
+	float SingleGradient(unsigned char offset, float x, float y) const;
+	template<EInterp Interp> float SingleGradient(unsigned char offset, float x, float y) const;
 
-	float SingleSimplexFractalFBM(float x, float y);
-	float SingleSimplexFractalBillow(float x, float y);
-	float SingleSimplexFractalRigidMulti(float x, float y);
-	float SingleSimplex(unsigned char offset, float x, float y);
+	float SingleSimplexFractalFBM(float x, float y, unsigned int octaves, float lastOctaveWeight) const;
+	float SingleSimplexFractalBillow(float x, float y, unsigned int octaves, float lastOctaveWeight) const;
+	float SingleSimplexFractalRigidMulti(float x, float y, unsigned int octaves, float lastOctaveWeight) const;
+	float SingleSimplex(unsigned char offset, float x, float y) const;
 
-	float SingleCellular(float x, float y);
-	float SingleCellular2Edge(float x, float y);
+	float SingleCellular(float x, float y) const;
+	// The closest feature point distance with either the second closest (bDistance2) or the closest cell, in one search
+	template<ECellularDistanceFunction Distance, bool bDistance2> void SingleCellularSearch(float x, float y, float& distance, float& distance2, int& xc, int& yc) const;
 
-	void SinglePositionWarp(unsigned char offset, float warpAmp, float frequency, float& x, float& y);
+	void SinglePositionWarp(unsigned char offset, float warpAmp, float frequency, float& x, float& y) const;
 
 	//3D
-	float SingleValueFractalFBM(float x, float y, float z);
-	float SingleValueFractalBillow(float x, float y, float z);
-	float SingleValueFractalRigidMulti(float x, float y, float z);
-	float SingleValue(unsigned char offset, float x, float y, float z);
+	template<EInterp Interp> float SingleValueFractalFBM(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const;
+	template<EInterp Interp> float SingleValueFractalBillow(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const;
+	template<EInterp Interp> float SingleValueFractalRigidMulti(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const;
+	float SingleValue(unsigned char offset, float x, float y, float z) const;
+	template<EInterp Interp> float SingleValue(unsigned char offset, float x, float y, float z) const;
+
+	template<EInterp Interp> float SingleGradientFractalFBM(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const;
+	template<EInterp Interp> float SingleGradientFractalBillow(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const;
+	template<EInterp Interp> float SingleGradientFractalRigidMulti(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const;
+	float SingleGradient(unsigned char offset, float x, float y, float z) const;
+	template<EInterp Interp> float SingleGradient(unsigned char offset, float x, float y, float z) const;
+
+	float SingleSimplexFractalFBM(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const;
+	float SingleSimplexFractalBillow(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const;
+	float SingleSimplexFractalRigidMulti(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const;
+	float SingleSimplex(unsigned char offset, float x, float y, float z) const;
+
+	float SingleCellular(float x, float y, float z) const;
+	template<ECellularDistanceFunction Distance, bool bDistance2> void SingleCellularSearch(float x, float y, float z, float& distance, float& distance2, int& xc, int& yc, int& zc) const;
+
+	void SinglePositionWarp(unsigned char offset, float warpAmp, float frequency, float& x, float& y, float& z) const;
+
+	// Noise with its gradient in noise space, see GetNoise2DWithGradient/GetNoise3DWithGradient
+	template<EInterp Interp> float SingleGradientDeriv(unsigned char offset, float x, float y, float& outDX, float& outDY) const;
+	template<EInterp Interp> float SingleGradientDeriv(unsigned char offset, float x, float y, float z, float& outDX, float& outDY, float& outDZ) const;
+	float SingleSimplexDeriv(unsigned char offset, float x, float y, float& outDX, float& outDY) const;
+	float SingleSimplexDeriv(unsigned char offset, float x, float y, float z, float& outDX, float& outDY, float& outDZ) const;
+	float SingleNoiseDeriv(unsigned char offset, float x, float y, float& outDX, float& outDY) const;
+	float SingleNoiseDeriv(unsigned char offset, float x, float y, float z, float& outDX, float& outDY, float& outDZ) const;
+	float SingleFractalDeriv(float x, float y, float& outDX, float& outDY) const;
+	float SingleFractalDeriv(float x, float y, float z, float& outDX, float& outDY, float& outDZ) const;
 
-	float SingleGradientFractalFBM(float x, float y, float z);
-	float SingleGradientFractalBillow(float x, float y, float z);
-	float SingleGradientFractalRigidMulti(float x, float y, float z);
-	float SingleGradient(unsigned char offset, float x, float y, float z);
+	//4D
+	float SingleSimplex(unsigned char offset, float x, float y, float z, float w) const;
 
-	float SingleSimplexFractalFBM(float x, float y, float z);
-	float SingleSimplexFractalBillow(float x, float y, float z);
-	float SingleSimplexFractalRigidMulti(float x, float y, float z);
-	float SingleSimplex(unsigned char offset, float x, float y, float z);
+private:
+	// Binds m_kernels and m_singleNoise2D/3D to the functions compiled for the current settings
+	void BindKernels();
+
+	// The settings as the batch kernels see them. Made for each call rather than stored, as it points into the
+	// permutation tables and a stored copy would go stale when the FFastNoise is copied
+	FFastNoiseBatchParams MakeBatchParams(float footprint) const;
+
+	// The batch warp with the warp type given rather than the generator's
+	void PositionWarpBatch(EPositionWarpType positionWarpType, float* x, float* y, int32 n) const;
+	void PositionWarpBatch(EPositionWarpType positionWarpType, float* x, float* y, float* z, int32 n) const;
+
+	// Batch evaluation with position warping, over coordinates the warp can overwrite
+	void GetWarpedNoise2DBatch(const FFastNoiseBatchParams& params, float* x, float* y, float* out, int32 n) const;
+	void GetWarpedNoise3DBatch(const FFastNoiseBatchParams& params, float* x, float* y, float* z, float* out, int32 n) const;
+
+	// GetNoise evaluating only the first octaves of the fractal types, with the last one scaled by lastOctaveWeight
+	float GetNoiseOctaves(float x, float y, unsigned int octaves, float lastOctaveWeight) const;
+	float GetNoiseOctaves(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const;
+
+	// GetNoise for one configuration of noise type, fractal type and interpolation, bound when the settings change
+	// so GetNoise doesn't switch on them for every point or the lattice functions for every octave
+	template<ENoiseType NoiseType, EFractalType FractalType, EInterp Interp> float SingleNoise(float x, float y, unsigned int octaves, float lastOctaveWeight) const;
+	template<ENoiseType NoiseType, EFractalType FractalType, EInterp Interp> float SingleNoise(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const;
+
+	typedef float (FFastNoise::*FSingleNoise2D)(float x, float y, unsigned int octaves, float lastOctaveWeight) const;
+	typedef float (FFastNoise::*FSingleNoise3D)(float x, float y, float z, unsigned int octaves, float lastOctaveWeight) const;
+	FSingleNoise2D m_singleNoise2D = nullptr;
+	FSingleNoise3D m_singleNoise3D = nullptr;
+
+	friend struct FFastNoiseSingleBinder;
+
+	// The seed Integer lattice hashing starts from for an octave offset
+	inline uint32 HashSeed(unsigned char offset) const;
+
+	inline unsigned char Index2D_12(unsigned char offset, int x, int y) const;
+	inline unsigned char Index3D_12(unsigned char offset, int x, int y, int z) const;
+	inline unsigned char Index4D_32(unsigned char offset, int x, int y, int z, int w) const;
+	inline unsigned char Index2D_256(unsigned char offset, int x, int y) const;
+	inline unsigned char Index3D_256(unsigned char offset, int x, int y, int z) const;
+	inline unsigned char Index4D_256(unsigned char offset, int x, int y, int z, int w) const;
+
+	inline float ValCoord2DFast(unsigned char offset, int x, int y) const;
+	inline float ValCoord3DFast(unsigned char offset, int x, int y, int z) const;
+	inline float GradCoord2D(unsigned char offset, int x, int y, float xd, float yd) const;
+	inline float GradCoord3D(unsigned char offset, int x, int y, int z, float xd, float yd, float zd) const;
+	inline float GradCoord4D(unsigned char offset, int x, int y, int z, int w, float xd, float yd, float zd, float wd) const;
+};
 
-	float SingleCellular(float x, float y, float z);
-	float SingleCellular2Edge(float x, float y, float z);
+// UObject wrapper around FFastNoise for Blueprints and the module graph. Keeps the UFastNoise interface, everything
+// is forwarded to the FFastNoise returned by GetFastNoise().
+// GetNoise2D/GetNoise3D are non-const overrides of the generator interface and record into the noise profiler when it
+// is on. They may be called from several threads at once only while nothing calls the setters and the object is kept
+// alive by the game thread; anything that can't promise that should sample a copy of GetFastNoise() instead
+UCLASS()
+class UNREALFASTNOISEPLUGIN_API UFastNoise : public UUFNNoiseGenerator
+{
+	GENERATED_UCLASS_BODY()
+public:
+	// The wrapped noise, copy it to sample off the game thread without keeping this object alive
+	const FFastNoise& GetFastNoise() const { return Noise; }
+
+	void SetSeed(int seed) { Noise.SetSeed(seed); }
+	int GetSeed(void) const { return Noise.GetSeed(); }
+	void SetFrequency(float frequency) { Noise.SetFrequency(frequency); }
+	void SetInterp(EInterp interp) { Noise.SetInterp(interp); }
+	void SetNoiseType(ENoiseType noiseType) { Noise.SetNoiseType(noiseType); }
+	void SetLatticeHash(ELatticeHash latticeHash) { Noise.SetLatticeHash(latticeHash); }
+	void SetFractalOctaves(unsigned int octaves) { Noise.SetFractalOctaves(octaves); }
+	void SetFractalLacunarity(float lacunarity) { Noise.SetFractalLacunarity(lacunarity); }
+	void SetFractalGain(float gain) { Noise.SetFractalGain(gain); }
+	void SetFractalType(EFractalType fractalType) { Noise.SetFractalType(fractalType); }
+	void SetCellularDistanceFunction(ECellularDistanceFunction cellularDistanceFunction) { Noise.SetCellularDistanceFunction(cellularDistanceFunction); }
+	void SetCellularReturnType(ECellularReturnType cellularReturnType) { Noise.SetCellularReturnType(cellularReturnType); }
+	void SetPositionWarpAmp(float positionWarpAmp) { Noise.SetPositionWarpAmp(positionWarpAmp); }
+	void SetPositionWarpType(EPositionWarpType positionWarpType) { Noise.SetPositionWarpType(positionWarpType); }
+
+	// Referenced so the lookup is kept alive as long as this is
+	void SetCellularNoiseLookup(UFastNoise* noise)
+	{
+		CellularNoiseLookup = noise;
+		Noise.SetCellularNoiseLookup(noise ? &noise->Noise : nullptr);
+	}
 
-	void SinglePositionWarp(unsigned char offset, float warpAmp, float frequency, float& x, float& y, float& z);
+	//2D
+	float GetValue(float x, float y) const { return Noise.GetValue(x, y); }
+	float GetValueFractal(float x, float y) const { return Noise.GetValueFractal(x, y); }
+	float GetGradient(float x, float y) const { return Noise.GetGradient(x, y); }
+	float GetGradientFractal(float x, float y) const { return Noise.GetGradientFractal(x, y); }
+	float GetSimplex(float x, float y) const { return Noise.GetSimplex(x, y); }
+	float GetSimplexFractal(float x, float y) const { return Noise.GetSimplexFractal(x, y); }
+	float GetCellular(float x, float y) const { return Noise.GetCellular(x, y); }
+	float GetWhiteNoise(float x, float y) const { return Noise.GetWhiteNoise(x, y); }
+	float GetWhiteNoiseInt(int x, int y) const { return Noise.GetWhiteNoiseInt(x, y); }
+
+	float GetNoise(float x, float y) const { return Noise.GetNoise(x, y); }
+	float GetNoise2D(float x, float y) override { UFN_NOISE_PROFILE_SCOPE(this); return Noise.GetNoise2D(x, y); }
+	float GetNoise2DWithGradient(float x, float y, FVector2D& outGradient) const { return Noise.GetNoise2DWithGradient(x, y, outGradient); }
+	FVector GetNoise2DDeriv(float x, float y) const { return Noise.GetNoise2DDeriv(x, y); }
+
+	void PositionWarp(float& x, float& y) const { Noise.PositionWarp(x, y); }
+	void PositionWarpFractal(float& x, float& y) const { Noise.PositionWarpFractal(x, y); }
+
+	//3D
+	float GetValue(float x, float y, float z) const { return Noise.GetValue(x, y, z); }
+	float GetValueFractal(float x, float y, float z) const { return Noise.GetValueFractal(x, y, z); }
+	float GetGradient(float x, float y, float z) const { return Noise.GetGradient(x, y, z); }
+	float GetGradientFractal(float x, float y, float z) const { return Noise.GetGradientFractal(x, y, z); }
+	float GetSimplex(float x, float y, float z) const { return Noise.GetSimplex(x, y, z); }
+	float GetSimplexFractal(float x, float y, float z) const { return Noise.GetSimplexFractal(x, y, z); }
+	float GetCellular(float x, float y, float z) const { return Noise.GetCellular(x, y, z); }
+	float GetWhiteNoise(float x, float y, float z) const { return Noise.GetWhiteNoise(x, y, z); }
+	float GetWhiteNoiseInt(int x, int y, int z) const { return Noise.GetWhiteNoiseInt(x, y, z); }
+
+	float GetNoise(float x, float y, float z) const { return Noise.GetNoise(x, y, z); }
+	float GetNoise3D(float x, float y, float z) override { UFN_NOISE_PROFILE_SCOPE(this); return Noise.GetNoise3D(x, y, z); }
+	int32 CompileNoise(FUFNNoiseCompiler& compiler, const FUFNNoiseCoordinates& coords) override;
+	FFloatInterval GetNoiseBounds2D(const FBox2D& region) override { return Noise.GetNoiseBounds(); }
+	FFloatInterval GetNoiseBounds3D(const FBox& region) override { return Noise.GetNoiseBounds(); }
+	float GetNoise3DWithGradient(float x, float y, float z, FVector& outGradient) const { return Noise.GetNoise3DWithGradient(x, y, z, outGradient); }
+
+	void PositionWarp(float& x, float& y, float& z) const { Noise.PositionWarp(x, y, z); }
+	void PositionWarpFractal(float& x, float& y, float& z) const { Noise.PositionWarpFractal(x, y, z); }
+
+	// See FFastNoise
+	float GetNoise2DAdaptive(float x, float y, float footprint) const { return Noise.GetNoise2DAdaptive(x, y, footprint); }
+	float GetNoise3DAdaptive(float x, float y, float z, float footprint) const { return Noise.GetNoise3DAdaptive(x, y, z, footprint); }
+	void GetNoise2DBatch(const float* x, const float* y, float* out, int32 n, float footprint = 0.0f) const { Noise.GetNoise2DBatch(x, y, out, n, footprint); }
+	void GetNoise3DBatch(const float* x, const float* y, const float* z, float* out, int32 n, float footprint = 0.0f) const { Noise.GetNoise3DBatch(x, y, z, out, n, footprint); }
+	void FillNoiseGrid2D(const FVector2D& origin, const FVector2D& step, const FIntPoint& extent, float* outValues, float footprint = 0.0f, int32 seedOffset = 0) const { Noise.FillNoiseGrid2D(origin, step, extent, outValues, footprint, seedOffset); }
+	void FillNoiseGrid3D(const FVector& origin, const FVector& step, const FIntVector& extent, float* outValues, float footprint = 0.0f, int32 seedOffset = 0) const { Noise.FillNoiseGrid3D(origin, step, extent, outValues, footprint, seedOffset); }
+	void PositionWarpBatch(float* x, float* y, int32 n) const { Noise.PositionWarpBatch(x, y, n); }
+	void PositionWarpFractalBatch(float* x, float* y, int32 n) const { Noise.PositionWarpFractalBatch(x, y, n); }
+	void PositionWarpBatch(float* x, float* y, float* z, int32 n) const { Noise.PositionWarpBatch(x, y, z, n); }
+	void PositionWarpFractalBatch(float* x, float* y, float* z, int32 n) const { Noise.PositionWarpFractalBatch(x, y, z, n); }
 
 	//4D
-	float SingleSimplex(unsigned char offset, float x, float y, float z, float w);
+	float GetSimplex(float x, float y, float z, float w) const { return Noise.GetSimplex(x, y, z, w); }
+	float GetWhiteNoise(float x, float y, float z, float w) const { return Noise.GetWhiteNoise(x, y, z, w); }
+	float GetWhiteNoiseInt(int x, int y, int z, int w) const { return Noise.GetWhiteNoiseInt(x, y, z, w); }
 
 private:
-	inline unsigned char Index2D_12(unsigned char offset, int x, int y);
-	inline unsigned char Index3D_12(unsigned char offset, int x, int y, int z);
-	inline unsigned char Index4D_32(unsigned char offset, int x, int y, int z, int w);
-	inline unsigned char Index2D_256(unsigned char offset, int x, int y);
-	inline unsigned char Index3D_256(unsigned char offset, int x, int y, int z);
-	inline unsigned char Index4D_256(unsigned char offset, int x, int y, int z, int w);
-
-	inline float ValCoord2DFast(unsigned char offset, int x, int y);
-	inline float ValCoord3DFast(unsigned char offset, int x, int y, int z);
-	inline float GradCoord2D(unsigned char offset, int x, int y, float xd, float yd);
-	inline float GradCoord3D(unsigned char offset, int x, int y, int z, float xd, float yd, float zd);
-	inline float GradCoord4D(unsigned char offset, int x, int y, int z, int w, float xd, float yd, float zd, float wd);
+	FFastNoise Noise;
+
+	UPROPERTY()
+	UFastNoise* CellularNoiseLookup = nullptr;
 };
\ No newline at end of file
@@ -0,0 +1,121 @@
+// FastNoiseBatch.h
+//
+// Batch evaluation of the FastNoise Value, Gradient, Simplex and Cellular types, several points at a time.
+// The kernels are compiled for SSE4.1 and AVX2 as well as plain scalar code, the best one the CPU
+// supports is picked at runtime. Each combination of noise type, fractal type and interpolation is
+// compiled separately, so once bound for a configuration the kernels have no per sample dispatch.
+// Position warping has kernels of its own, warping coordinate arrays in place ahead of the noise kernels.
+//
+// Results match the single point FFastNoise functions to within FASTNOISE_BATCH_TOLERANCE. The
+// kernels do the same floating point operations in the same order, so in practice they are usually
+// identical, the tolerance covers compilers contracting the single point code into FMA instructions.
+//
+
+#pragma once
+#include "CoreMinimal.h"
+
+enum class ENoiseType : uint8;
+enum class EInterp : uint8;
+enum class EFractalType : uint8;
+enum class ELatticeHash : uint8;
+
+#define FASTNOISE_BATCH_TOLERANCE 1e-5f
+
+// The multiply-xorshift lattice hash of ELatticeHash::Integer. A corner hashes to
+// seed ^ x * PRIME_X ^ y * PRIME_Y ^ z * PRIME_Z, multiplied by MULTIPLIER and xored with itself shifted down by 15.
+// Octaves add their offset times OFFSET_MULTIPLIER to the seed. FastNoise.cpp and the kernels both follow this
+#define FASTNOISE_HASH_PRIME_X 501125321
+#define FASTNOISE_HASH_PRIME_Y 1136930381
+#define FASTNOISE_HASH_PRIME_Z 1720413743
+#define FASTNOISE_HASH_MULTIPLIER 0x27d4eb2d
+#define FASTNOISE_HASH_OFFSET_MULTIPLIER 0x9e3779b9
+
+// No CELL_2D/CELL_3D offset moves a cellular feature point further than this from its cell along an axis, the largest
+// is just under 0.45. Cells are skipped when a bound made with it shows they can't hold a closer feature point
+#define FASTNOISE_CELL_JITTER_BOUND 0.46f
+
+// Everything the batch kernels need from an FFastNoise
+struct FFastNoiseBatchParams
+{
+	// Permutation tables widened to int32, so they can be gathered from directly
+	const int32* Perm;
+	const int32* Perm12;
+
+	// Value noise lookup table, 256 entries
+	const float* ValueLUT;
+
+	// Cellular feature point offsets, the CELL_2D_* and CELL_3D_* tables
+	const float* Cell2DX;
+	const float* Cell2DY;
+	const float* Cell3DX;
+	const float* Cell3DY;
+	const float* Cell3DZ;
+
+	ENoiseType NoiseType;
+	EInterp Interp;
+	EFractalType FractalType;
+	ELatticeHash LatticeHash;
+
+	// Seed for Integer lattice hashing
+	int32 Seed;
+
+	// ECellularDistanceFunction and ECellularReturnType, plain enums that can't be forward declared
+	uint8 CellularDistanceFunction;
+	uint8 CellularReturnType;
+
+	float Frequency;
+	// Octaves to evaluate, fewer than the generator's when cut off for the sample footprint. The last one is
+	// scaled by LastOctaveWeight so it can fade out
+	int32 Octaves;
+	float LastOctaveWeight;
+	float Lacunarity;
+	float Gain;
+	float FractalBounding;
+
+	// EPositionWarpType, for the warp kernels. Warping isn't cut off for the footprint, it always uses all the
+	// generator's octaves
+	uint8 PositionWarpType;
+	float PositionWarpAmp;
+	int32 WarpOctaves;
+};
+
+// The kernels for one configuration, filled by FastNoiseBatch::BindKernels
+struct FFastNoiseBatchKernels
+{
+	// Evaluate n points, coordinates are scaled by the frequency like FFastNoise::GetNoise
+	void (*GetNoise2D)(const FFastNoiseBatchParams& params, const float* x, const float* y, float* out, int32 n) = nullptr;
+	void (*GetNoise3D)(const FFastNoiseBatchParams& params, const float* x, const float* y, const float* z, float* out, int32 n) = nullptr;
+
+	// Evaluate a regular grid of points, x varies fastest in out. Values shared along a row are only worked out once
+	void (*FillGrid2D)(const FFastNoiseBatchParams& params, float originX, float originY, float stepX, float stepY, int32 sizeX, int32 sizeY, float* out) = nullptr;
+	void (*FillGrid3D)(const FFastNoiseBatchParams& params, float originX, float originY, float originZ, float stepX, float stepY, float stepZ, int32 sizeX, int32 sizeY, int32 sizeZ, float* out) = nullptr;
+
+	// Warp n points in place like FFastNoise::PositionWarp/PositionWarpFractal, for the params' PositionWarpType.
+	// Bound for every configuration, including ones the noise kernels don't implement
+	void (*PositionWarp2D)(const FFastNoiseBatchParams& params, float* x, float* y, int32 n) = nullptr;
+	void (*PositionWarp3D)(const FFastNoiseBatchParams& params, float* x, float* y, float* z, int32 n) = nullptr;
+
+	bool IsBound() const { return GetNoise2D != nullptr; }
+};
+
+namespace FastNoiseBatch
+{
+	enum class EInstructionSet : uint8
+	{
+		Scalar,
+		SSE41,
+		AVX2
+	};
+
+	// The best instruction set the CPU and OS support, detected once
+	UNREALFASTNOISEPLUGIN_API EInstructionSet GetInstructionSet();
+
+	UNREALFASTNOISEPLUGIN_API const TCHAR* GetInstructionSetName(EInstructionSet instructionSet);
+
+	// True for the configurations the batch kernels implement, all but cellular NoiseLookup of the noise types above
+	bool SupportsConfiguration(const FFastNoiseBatchParams& params);
+
+	// The kernels for the configuration in params, using the best instruction set.
+	// Leaves the noise kernels unbound if the configuration isn't one the batch kernels implement
+	UNREALFASTNOISEPLUGIN_API void BindKernels(const FFastNoiseBatchParams& params, FFastNoiseBatchKernels& outKernels);
+}
@@ -0,0 +1,50 @@
+// FastNoisePermutation.h
+//
+// The permutation tables FFastNoise hashes lattice coordinates with. They only depend on the seed, so rather
+// than every generator building and carrying its own 4KB of tables they are built once per seed, interned in a
+// process-wide cache and shared read-only between every generator using that seed.
+//
+
+#pragma once
+#include "CoreMinimal.h"
+#include "UFNWeakValueCache.h"
+
+// Permutation tables for one seed, never modified once built
+struct FFastNoisePermutation
+{
+	explicit FFastNoisePermutation(int seed);
+
+	unsigned char Perm[512];
+	unsigned char Perm12[512];
+
+	// Perm and Perm12 widened to int32 for the batch kernels to gather from
+	int32 PermBatch[512];
+	int32 Perm12Batch[512];
+};
+
+typedef TSharedPtr<const FFastNoisePermutation, ESPMode::ThreadSafe> FFastNoisePermutationPtr;
+
+/**
+ * Process-wide cache of permutation tables keyed by seed.
+ *
+ * Entries are weak, the tables are reference counted by the generators using them and are freed
+ * once the last generator with that seed is destroyed or reseeded.
+ */
+class UNREALFASTNOISEPLUGIN_API FFastNoisePermutationCache
+{
+public:
+
+	static FFastNoisePermutationCache& Get();
+
+	// Returns the shared tables for the seed, building them on a miss
+	FFastNoisePermutationPtr FindOrCreate(int seed);
+
+	// Number of seeds currently shared through the cache
+	int32 Num();
+
+private:
+
+	FFastNoisePermutationCache() {}
+
+	TUFNWeakValueCache<int, FFastNoisePermutation> Tables;
+};
@@ -12,6 +12,9 @@ public:
 
 	float GetNoise3D(float aX, float aY, float aZ) override;
 	float GetNoise2D(float aX, float aY) override;
+	int32 CompileNoise(FUFNNoiseCompiler& compiler, const FUFNNoiseCoordinates& coords) override;
+	FFloatInterval GetNoiseBounds2D(const FBox2D& region) override;
+	FFloatInterval GetNoiseBounds3D(const FBox& region) override;
 
 	UPROPERTY()
 		UUFNNoiseGenerator* inputModule1;
@@ -3,6 +3,9 @@
 #include "CoreMinimal.h"
 #include "UFNNoiseGenerator.generated.h"
 
+class FUFNNoiseCompiler;
+struct FUFNNoiseCoordinates;
+
 UCLASS(BlueprintType)
 class UNREALFASTNOISEPLUGIN_API UUFNNoiseGenerator : public UObject
 {
@@ -12,4 +15,14 @@ class UNREALFASTNOISEPLUGIN_API UUFNNoiseGenerator : public UObject
 	virtual float GetNoise2D(float aX, float aY);
 	UFUNCTION(BlueprintCallable, Category = "UnrealFastNoise")
 	virtual float GetNoise3D(float aX, float aY, float aZ);
+
+	// Emits the instructions computing this node at coords into a FUFNNoiseProgram and returns the value holding the
+	// result. The default samples GetNoise2D/GetNoise3D a point at a time.
+	virtual int32 CompileNoise(FUFNNoiseCompiler& compiler, const FUFNNoiseCoordinates& coords);
+
+	// Conservative range of GetNoise2D/GetNoise3D over every point in region, built from FUFNNoiseBounds. The default
+	// knows nothing about the node and is unbounded. The range must be proven rather than measured, programs prune on
+	// it and compiling drops masked adds for good when it can't reach their threshold.
+	virtual FFloatInterval GetNoiseBounds2D(const FBox2D& region);
+	virtual FFloatInterval GetNoiseBounds3D(const FBox& region);
 };
\ No newline at end of file
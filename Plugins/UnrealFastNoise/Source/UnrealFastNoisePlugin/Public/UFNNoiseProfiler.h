@@ -0,0 +1,105 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UUFNNoiseGenerator;
+class FJsonObject;
+class FUFNNoiseProfileScope;
+
+// Profiling is compiled out of shipping builds, and off elsewhere until ufn.Profile is set
+#ifndef UFN_NOISE_PROFILING
+#define UFN_NOISE_PROFILING !UE_BUILD_SHIPPING
+#endif
+
+#if UFN_NOISE_PROFILING
+
+/**
+ * Opt-in per node profiling of noise graphs. With ufn.Profile set every GetNoise2D/GetNoise3D call and every
+ * FUFNNoiseProgram instruction is timed into a call tree, one entry per path from the outermost node down, so a node
+ * shared by two parents shows up under each. Inclusive time counts everything below a node, exclusive only the node
+ * itself. Each thread records into a tree of its own, merged when read, so recording only takes its own tree's lock
+ * when it meets a new path or starts over after a reset.
+ *
+ * A program records each instruction under the path of nodes it was compiled for. Work that compiling shared between
+ * nodes is counted under the first node that asked for it, and a node's calls are the points its result was computed
+ * for.
+ *
+ * ufn.Profile.Dump logs the tree, ufn.Profile.Export [path] writes it as JSON and ufn.Profile.Reset starts over. Both
+ * can run while other threads are evaluating, calls still in progress are missing from the result.
+ */
+class UNREALFASTNOISEPLUGIN_API FUFNNoiseProfiler
+{
+public:
+	// Whether evaluation is being recorded, ufn.Profile
+	static bool IsEnabled() { return Enabled != 0; }
+
+	static void Reset();
+	static void Dump();
+	static TSharedRef<FJsonObject> ToJson();
+	static bool Export(const FString& Path);
+
+	// Bound to ufn.Profile
+	static int32 Enabled;
+
+private:
+	friend class FUFNNoiseProfileScope;
+
+	static void Begin(FUFNNoiseProfileScope& Scope, UUFNNoiseGenerator* const* Path, int32 PathLength);
+	static void End(FUFNNoiseProfileScope& Scope);
+};
+
+// Times a node from construction to destruction while profiling is enabled
+class UNREALFASTNOISEPLUGIN_API FUFNNoiseProfileScope
+{
+public:
+	// A single GetNoise call
+	explicit FUFNNoiseProfileScope(UUFNNoiseGenerator* Generator)
+		: bActive(FUFNNoiseProfiler::IsEnabled())
+	{
+		if (bActive)
+		{
+			Calls = 1;
+			FUFNNoiseProfiler::Begin(*this, &Generator, 1);
+		}
+	}
+
+	// Work done for the last node of a path below the current scope, such as a program instruction
+	FUFNNoiseProfileScope(UUFNNoiseGenerator* const* Path, int32 PathLength, int64 InCalls)
+		: bActive(FUFNNoiseProfiler::IsEnabled())
+	{
+		if (bActive)
+		{
+			Calls = InCalls;
+			FUFNNoiseProfiler::Begin(*this, Path, PathLength);
+		}
+	}
+
+	~FUFNNoiseProfileScope()
+	{
+		if (bActive)
+		{
+			FUFNNoiseProfiler::End(*this);
+		}
+	}
+
+private:
+	friend class FUFNNoiseProfiler;
+
+	bool bActive;
+	int64 Calls;
+	// Entries in the thread's tree of the node timed and of the node it was entered from
+	int32 Entry;
+	int32 ParentEntry;
+	uint64 StartCycles;
+	// Time spent in scopes nested in this one
+	uint64 ChildCycles;
+	FUFNNoiseProfileScope* Parent;
+};
+
+#define UFN_NOISE_PROFILE_SCOPE(Generator) FUFNNoiseProfileScope UFNNoiseProfileScope(Generator)
+
+#else
+
+#define UFN_NOISE_PROFILE_SCOPE(Generator)
+
+#endif
@@ -0,0 +1,363 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FastNoise/FastNoise.h"
+
+class UUFNNoiseGenerator;
+class UCurveFloat;
+
+// Interpolation used by the interpolated Select and Radial instructions, Steps is only read by InterpStep
+typedef float(*FUFNInterpFunction)(float A, float B, float Alpha, int32 Steps);
+
+enum class EUFNNoiseOp : uint8
+{
+	// Out = Values[0]
+	Constant,
+	// Out = A + Values[0]
+	AddConstant,
+	// Out = A + B * Values[0]
+	MultiplyAdd,
+	// Out = A * Values[0] + Values[1]
+	ScaleBias,
+	// Out = A + B
+	Add,
+	// Out = C >= Values[0] ? C * (A + B) : A
+	MaskedAdd,
+	// Out = C > Values[0] ? A : B
+	Select,
+	// Out = C <= Values[0] ? B : C >= Values[1] ? A : Interp(B, A, C - Values[2])
+	SelectInterp,
+	// Out = D >= Values[0] ? A : D >= Values[1] ? B : C
+	Select3,
+	// Out = Curve((A + 1) / 2), the alpha of a Blend
+	BlendAlpha,
+	// Out = C == 0 ? A : Lerp(A, B, C), which is Lerp(A, B, C) whenever B is finite
+	Blend,
+	// Out = |(A, B) - (Values[0], Values[1])|
+	Distance2D,
+	// Out = |(Values[0], Values[1], Values[2]) - (A, B, C)|
+	Distance3D,
+	// Out = C > Values[1] ? B : C < Values[0] ? A : Interp(A, B, (C - Values[0]) / Values[2])
+	RadialInterp,
+	// Out = Noise(A, B[, C]), batched
+	FastNoise2D,
+	FastNoise3D,
+	// Out = Generator->GetNoise(A, B[, C]), a point at a time, for nodes that cannot be compiled
+	Generator2D,
+	Generator3D,
+};
+
+struct UNREALFASTNOISEPLUGIN_API FUFNNoiseInstruction
+{
+	EUFNNoiseOp Op;
+	// Registers once the program is finished, values while it is being compiled
+	int32 Out;
+	int32 Args[4];
+	float Values[4];
+
+	int32 Steps;
+	FUFNInterpFunction Interp;
+	const FFastNoise* Noise;
+	UUFNNoiseGenerator* Generator;
+	UCurveFloat* Curve;
+
+	// For profiling, the program's path of nodes that emitted the instruction and whether it holds the last node's
+	// result. Neither is compared
+	int32 ProfilePath;
+	bool bProfileResult;
+
+	FUFNNoiseInstruction(EUFNNoiseOp InOp)
+		: Op(InOp), Out(INDEX_NONE), Steps(0), Interp(nullptr), Noise(nullptr), Generator(nullptr), Curve(nullptr), ProfilePath(INDEX_NONE), bProfileResult(false)
+	{
+		Args[0] = Args[1] = Args[2] = Args[3] = INDEX_NONE;
+		Values[0] = Values[1] = Values[2] = Values[3] = 0.0f;
+	}
+
+	bool IsLeaf() const { return Op == EUFNNoiseOp::FastNoise2D || Op == EUFNNoiseOp::FastNoise3D || Op == EUFNNoiseOp::Generator2D || Op == EUFNNoiseOp::Generator3D; }
+
+	// Values compare bitwise, so 0 and -0 stay apart
+	bool operator==(const FUFNNoiseInstruction& Other) const
+	{
+		return Op == Other.Op && Out == Other.Out && FMemory::Memcmp(Args, Other.Args, sizeof(Args)) == 0 && FMemory::Memcmp(Values, Other.Values, sizeof(Values)) == 0 &&
+			Steps == Other.Steps && Interp == Other.Interp && Noise == Other.Noise && Generator == Other.Generator && Curve == Other.Curve;
+	}
+
+	friend uint32 GetTypeHash(const FUFNNoiseInstruction& Instruction)
+	{
+		uint32 Hash = FCrc::MemCrc32(Instruction.Args, sizeof(Instruction.Args), (uint32)Instruction.Op);
+		Hash = FCrc::MemCrc32(Instruction.Values, sizeof(Instruction.Values), Hash);
+		return HashCombine(Hash, HashCombine(PointerHash(Instruction.Noise), PointerHash(Instruction.Generator)));
+	}
+};
+
+// Values holding the coordinates a node is sampled at, Z is INDEX_NONE for 2D sampling
+struct FUFNNoiseCoordinates
+{
+	int32 X;
+	int32 Y;
+	int32 Z;
+
+	FUFNNoiseCoordinates(int32 InX, int32 InY, int32 InZ = INDEX_NONE) : X(InX), Y(InY), Z(InZ) {}
+
+	bool Is2D() const { return Z == INDEX_NONE; }
+
+	bool operator==(const FUFNNoiseCoordinates& Other) const { return X == Other.X && Y == Other.Y && Z == Other.Z; }
+};
+
+// Which inputs of a select can be taken over a range of control values
+enum class EUFNNoiseBranch : uint8
+{
+	// Depends on the point
+	Any,
+	// Always the first, second or third input
+	First,
+	Second,
+	Third,
+	// Always inside the falloff band, both inputs are blended
+	Falloff,
+};
+
+/**
+ * Interval arithmetic for the module types, giving conservative bounds of a node's output from bounds of its inputs.
+ * Each op works out its bounds with the same float operations the module evaluates with, which are monotonic, so the
+ * bounds hold with the rounding included. Blends between two inputs are given a little headroom instead. An unknown
+ * range, or one that could hold a NaN, is Unbounded; only bounded ranges ever decide a branch.
+ */
+struct UNREALFASTNOISEPLUGIN_API FUFNNoiseBounds
+{
+	static FFloatInterval Unbounded() { return FFloatInterval(TNumericLimits<float>::Lowest(), TNumericLimits<float>::Max()); }
+	static FFloatInterval Point(float Value) { return FFloatInterval(Value, Value); }
+	// Every point there is, for bounds that hold wherever a node is sampled
+	static FBox UnboundedRegion() { return FBox(FVector(TNumericLimits<float>::Lowest()), FVector(TNumericLimits<float>::Max())); }
+	static bool IsBounded(const FFloatInterval& Bounds) { return Bounds.Min > TNumericLimits<float>::Lowest() && Bounds.Max < TNumericLimits<float>::Max() && Bounds.Min <= Bounds.Max; }
+
+	static FFloatInterval Union(const FFloatInterval& A, const FFloatInterval& B);
+	static FFloatInterval Add(const FFloatInterval& A, const FFloatInterval& B);
+	static FFloatInterval Multiply(const FFloatInterval& A, const FFloatInterval& B);
+	static FFloatInterval AddConstant(const FFloatInterval& A, float Value);
+	static FFloatInterval MultiplyAdd(const FFloatInterval& A, const FFloatInterval& B, float Scale);
+	static FFloatInterval ScaleBias(const FFloatInterval& A, float Scale, float Bias);
+	static FFloatInterval Lerp(const FFloatInterval& A, const FFloatInterval& B, const FFloatInterval& Alpha);
+	static FFloatInterval Interp(const FFloatInterval& A, const FFloatInterval& B, const FFloatInterval& Alpha, FUFNInterpFunction Interp);
+	static FFloatInterval Distance2D(const FFloatInterval& X, const FFloatInterval& Y, float OriginX, float OriginY);
+	static FFloatInterval Distance3D(const FFloatInterval& X, const FFloatInterval& Y, const FFloatInterval& Z, const FVector& Origin);
+
+	// The branch each select takes over the control range, then the bounds of its output. The arguments follow the
+	// instructions of the same names
+	static EUFNNoiseBranch GetMaskedAddBranch(const FFloatInterval& Mask, float Threshold);
+	static EUFNNoiseBranch GetSelectBranch(const FFloatInterval& Control, float Threshold);
+	static EUFNNoiseBranch GetSelectInterpBranch(const FFloatInterval& Control, float Lower, float Upper);
+	static EUFNNoiseBranch GetSelect3Branch(const FFloatInterval& Control, float UpperThreshold, float LowerThreshold);
+	static EUFNNoiseBranch GetRadialInterpBranch(const FFloatInterval& Distance, float Radius, float Outer);
+
+	static FFloatInterval MaskedAdd(const FFloatInterval& A, const FFloatInterval& B, const FFloatInterval& Mask, float Threshold);
+	static FFloatInterval Select(const FFloatInterval& A, const FFloatInterval& B, const FFloatInterval& Control, float Threshold);
+	static FFloatInterval SelectInterp(const FFloatInterval& A, const FFloatInterval& B, const FFloatInterval& Control, float Lower, float Upper, float AlphaOffset, FUFNInterpFunction Interp);
+	static FFloatInterval Select3(const FFloatInterval& A, const FFloatInterval& B, const FFloatInterval& C, const FFloatInterval& Control, float UpperThreshold, float LowerThreshold);
+	static FFloatInterval BlendAlpha(const FFloatInterval& Control, UCurveFloat* Curve);
+	static FFloatInterval Blend(const FFloatInterval& A, const FFloatInterval& B, const FFloatInterval& Control, UCurveFloat* Curve);
+	static FFloatInterval RadialInterp(const FFloatInterval& A, const FFloatInterval& B, const FFloatInterval& Distance, float Radius, float Outer, float Falloff, FUFNInterpFunction Interp);
+};
+
+// Work done evaluating a program, counted in points
+struct FUFNNoiseEvaluationStats
+{
+	int64 Points = 0;
+	// Leaf evaluations made, and those skipped because bounds showed their branch wasn't taken anywhere in a block
+	int64 LeafEvaluations = 0;
+	int64 SkippedLeafEvaluations = 0;
+};
+
+// How much compiling the graph shared, leaf evaluations are FastNoise and per-point generator calls for each point
+struct FUFNNoiseProgramStats
+{
+	// Nodes in the graph, counted once however many parents they have
+	int32 Nodes = 0;
+	// Leaf evaluations if every node were evaluated for every parent and every time a parent asks for it, with both
+	// branches of each select taken
+	int64 ExpandedLeafEvaluations = 0;
+	// Leaf evaluations the program makes, after nodes reached again at the same coordinates are shared
+	int32 LeafEvaluations = 0;
+	int32 Instructions = 0;
+	int32 Registers = 0;
+	// Instructions folded into constants or replaced by cheaper ones
+	int32 Simplifications = 0;
+};
+
+/**
+ * A UFN module graph flattened into a register program. Evaluating it runs each instruction over a block of points
+ * before moving to the next, so leaves use the FastNoise batch kernels and combinators are plain loops over arrays,
+ * instead of a chain of virtual calls per point. Results match GetNoise2D/GetNoise3D on the root to within the batch
+ * kernels' error, each FastNoise leaf being within FASTNOISE_BATCH_TOLERANCE of its single point value, and merged
+ * ScaleBias chains can differ from applying each node in turn by a rounding.
+ *
+ * Each block first bounds every instruction over the block's coordinate range. Inputs of a select that no point in
+ * the block can take are skipped, along with everything only they read, and a select entirely on one side of its
+ * threshold just copies the input it takes, as does a falloff select with every point inside the band. Tiles with
+ * coherent points, rows of a grid or a mesh patch, get the most out of this.
+ *
+ * Where a block's points go both ways, a select's inputs are still only evaluated for the points that read them. Each
+ * input of a Select, 3Select, Radial, masked Add or Blend gets a scope holding the instructions nothing else reads.
+ * Once the control is known the block's points are split by the input they need, those in a falloff band needing
+ * both, and noise, generators and interpolations in a scope run on that scope's points gathered into a compact batch,
+ * the results scattered back. Cheap arithmetic runs over the whole block, the points outside its scope are ignored.
+ *
+ * The program points at the graph's nodes, keep the graph alive while it is in use and compile it again after
+ * changing it. Evaluation is const and may run on any thread, as long as the graph's generators allow that.
+ */
+class UNREALFASTNOISEPLUGIN_API FUFNNoiseProgram
+{
+public:
+	// Points evaluated per instruction, registers hold this many floats
+	static const int32 BlockSize = 256;
+
+	static TSharedRef<FUFNNoiseProgram> Compile2D(UUFNNoiseGenerator* Root);
+	static TSharedRef<FUFNNoiseProgram> Compile3D(UUFNNoiseGenerator* Root);
+
+	// Same as calling GetNoise2D/GetNoise3D on the root for each point, out may not alias the coordinates. Stats, if
+	// given, are added to
+	void Evaluate2D(const float* X, const float* Y, float* Out, int32 Count, FUFNNoiseEvaluationStats* OutStats = nullptr) const;
+	void Evaluate3D(const float* X, const float* Y, const float* Z, float* Out, int32 Count, FUFNNoiseEvaluationStats* OutStats = nullptr) const;
+
+	// Conservative range of the root over a region
+	FFloatInterval GetBounds2D(const FBox2D& Region) const;
+	FFloatInterval GetBounds3D(const FBox& Region) const;
+
+	bool Is2D() const { return bIs2D; }
+	const TArray<FUFNNoiseInstruction>& GetInstructions() const { return Instructions; }
+	int32 GetNumRegisters() const { return NumRegisters; }
+	const FUFNNoiseProgramStats& GetStats() const { return Stats; }
+
+private:
+	friend class FUFNNoiseCompiler;
+
+	// An input of a select and the instructions only it reads, nested in the scope of the select
+	struct FScope
+	{
+		int32 Parent;
+		// The select, and which of its arguments
+		int32 Instruction;
+		int32 Arg;
+	};
+
+	// Registers and scratch for evaluating one block, see the cpp
+	struct FBlock;
+
+	void Evaluate(const float* X, const float* Y, const float* Z, float* Out, int32 Count, FUFNNoiseEvaluationStats* OutStats) const;
+	void EvaluateBlock(FBlock& Block) const;
+	// Points of the block in a scope, computed the first time the scope is entered
+	int32 GetLanes(FBlock& Block, int32 Scope) const;
+
+	// Bounds of every instruction given the bounds of the coordinates, and the branch each select takes
+	FFloatInterval ComputeBounds(const FFloatInterval* InputBounds, FFloatInterval* RegisterBounds, EUFNNoiseBranch* Branches) const;
+	// Which instructions the result needs once the branches are known
+	void ComputeRun(const EUFNNoiseBranch* Branches, bool* Run) const;
+
+	TArray<FUFNNoiseInstruction> Instructions;
+	// Scope 0 is the whole block, instructions are only evaluated for the points of their scope
+	TArray<FScope> Scopes;
+	TArray<int32> InstructionScopes;
+	// Nodes from the root down to each node compiled, see FUFNNoiseProfiler
+	TArray<TArray<UUFNNoiseGenerator*>> ProfilePaths;
+	int32 NumRegisters = 0;
+	int32 ResultRegister = INDEX_NONE;
+	bool bIs2D = false;
+	// Whether the program has any instruction that bounds can prune
+	bool bHasBranches = false;
+	FUFNNoiseProgramStats Stats;
+};
+
+/**
+ * Builds a FUFNNoiseProgram. Nodes emit their instructions from UUFNNoiseGenerator::CompileNoise through the helpers
+ * here, each returning the value that holds its result, and compile their inputs with Compile. Values are assigned
+ * once, registers are only handed out when the program is finished.
+ *
+ * Nothing is computed twice per point. An instruction identical to one already emitted returns the earlier value, so
+ * repeated work such as the warp offsets or a Select reading both inputs is shared, and a node compiled again at the
+ * same coordinates, through a second parent or a second call from the same one, returns the value it had before.
+ *
+ * Each helper also simplifies what it is given. Instructions reading only constants are folded, ScaleBias chains are
+ * merged, identities are dropped, and Select, 3Select, Blend, Radial and masked Add with a constant control are
+ * replaced by the input they take, as is a masked Add whose mask can't reach the threshold anywhere. Whatever the
+ * result no longer depends on is removed when the program is finished.
+ * Merged ScaleBias chains and fully blended inputs can differ from GetNoise by a rounding, everything else is exact.
+ */
+class UNREALFASTNOISEPLUGIN_API FUFNNoiseCompiler
+{
+public:
+	explicit FUFNNoiseCompiler(bool bIs2D);
+
+	// Values of the sampled coordinates
+	const FUFNNoiseCoordinates& GetInputCoordinates() const { return InputCoordinates; }
+
+	// A null node evaluates to 0, each node is only compiled once for the same coordinates
+	int32 Compile(UUFNNoiseGenerator* Node, const FUFNNoiseCoordinates& Coordinates);
+
+	int32 Constant(float Value);
+	int32 AddConstant(int32 A, float Value);
+	int32 MultiplyAdd(int32 A, int32 B, float Scale);
+	int32 ScaleBias(int32 A, float Scale, float Bias);
+	int32 Add(int32 A, int32 B);
+	// MaskBounds must hold for the mask at every point, if they can't reach the threshold the result is just A. A mask
+	// with unbounded bounds keeps the compare
+	int32 MaskedAdd(int32 A, int32 B, int32 Mask, float Threshold, const FFloatInterval& MaskBounds = FUFNNoiseBounds::Unbounded());
+	int32 Select(int32 A, int32 B, int32 Control, float Threshold);
+	int32 SelectInterp(int32 A, int32 B, int32 Control, float Threshold, float Falloff, ESelectInterpType InterpType, int32 Steps);
+	int32 Select3(int32 A, int32 B, int32 C, int32 Control, float UpperThreshold, float LowerThreshold);
+	int32 Blend(int32 A, int32 B, int32 Control, UCurveFloat* Curve);
+	int32 Distance(const FUFNNoiseCoordinates& Coordinates, const FVector& Origin);
+	int32 RadialInterp(int32 A, int32 B, int32 Distance, float Radius, float Falloff, ESelectInterpType InterpType, int32 Steps);
+	int32 FastNoise(const FFastNoise& Noise, const FUFNNoiseCoordinates& Coordinates);
+	int32 Generator(UUFNNoiseGenerator* Node, const FUFNNoiseCoordinates& Coordinates);
+
+	// Assigns registers and moves the instructions into the program
+	TSharedRef<FUFNNoiseProgram> Finish(int32 Result);
+
+	static FUFNInterpFunction GetInterpFunction(ESelectInterpType InterpType);
+
+private:
+	struct FNodeKey
+	{
+		UUFNNoiseGenerator* Node;
+		FUFNNoiseCoordinates Coordinates;
+
+		FNodeKey(UUFNNoiseGenerator* InNode, const FUFNNoiseCoordinates& InCoordinates) : Node(InNode), Coordinates(InCoordinates) {}
+
+		bool operator==(const FNodeKey& Other) const { return Node == Other.Node && Coordinates == Other.Coordinates; }
+
+		friend uint32 GetTypeHash(const FNodeKey& Key)
+		{
+			return HashCombine(PointerHash(Key.Node), HashCombine(::GetTypeHash(Key.Coordinates.X), HashCombine(::GetTypeHash(Key.Coordinates.Y), ::GetTypeHash(Key.Coordinates.Z))));
+		}
+	};
+
+	struct FCompiledNode
+	{
+		int32 Value;
+		// Leaf evaluations of the node's subgraph when nothing is shared
+		int64 ExpandedLeafEvaluations;
+	};
+
+	int32 Emit(FUFNNoiseInstruction& Instruction);
+	// Puts each instruction in the scope of the select input it is read through, and reorders them so a select's
+	// control comes before anything in its scopes
+	void SplitBranches(int32 Result, TArray<FUFNNoiseProgram::FScope>& OutScopes, TArray<int32>& OutInstructionScopes);
+	const FUFNNoiseInstruction* GetInstruction(int32 Value) const;
+	bool GetConstant(int32 Value, float& OutConstant) const;
+	float Fold(const FUFNNoiseInstruction& Instruction) const;
+
+	TArray<FUFNNoiseInstruction> Instructions;
+	// Emitted instructions, with Out cleared, to the value they assigned
+	TMap<FUFNNoiseInstruction, int32> EmittedValues;
+	TMap<FNodeKey, FCompiledNode> CompiledNodes;
+	TSet<UUFNNoiseGenerator*> Nodes;
+	// Nodes being compiled, and the profile path of the innermost
+	TArray<UUFNNoiseGenerator*> NodePath;
+	TArray<TArray<UUFNNoiseGenerator*>> ProfilePaths;
+	int32 ProfilePath;
+	FUFNNoiseProgramStats Stats;
+	int64 ExpandedLeafEvaluations;
+	FUFNNoiseCoordinates InputCoordinates;
+	int32 NumValues;
+	bool bIs2D;
+};
@@ -12,6 +12,11 @@ public:
 
 	float GetNoise3D(float aX, float aY, float aZ) override;
 	float GetNoise2D(float aX, float aY) override;
+	int32 CompileNoise(FUFNNoiseCompiler& compiler, const FUFNNoiseCoordinates& coords) override;
+	FFloatInterval GetNoiseBounds2D(const FBox2D& region) override;
+	FFloatInterval GetNoiseBounds3D(const FBox& region) override;
+	// Bounds given those of the inputs and of the distance to origin
+	FFloatInterval GetNoiseBounds(const FFloatInterval& input1, const FFloatInterval& input2, const FFloatInterval& dist) const;
 
 	UPROPERTY()
 	UUFNNoiseGenerator* inputModule1;
@@ -2,6 +2,7 @@
 
 #include "UFNNoiseGenerator.h"
 #include "CoreMinimal.h"
+#include "Components/SceneComponent.h"
 #include "UFNSplineGenerator.generated.h"
 
 UCLASS(BlueprintType)
@@ -11,10 +12,24 @@ class UUFNSplineGenerator : public UUFNNoiseGenerator
 public:
 	float GetNoise3D(float aX, float aY, float aZ) override;
 	float GetNoise2D(float aX, float aY) override;
+	FFloatInterval GetNoiseBounds2D(const FBox2D& region) override;
+	FFloatInterval GetNoiseBounds3D(const FBox& region) override;
+
+	void PostLoad() override;
+	void PostDuplicate(bool bDuplicateForPIE) override;
+	void BeginDestroy() override;
+#if WITH_EDITOR
+	void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
 
 	UFUNCTION(BlueprintCallable, Category="FastNoise")
 	void AddSpline(USplineComponent* Spline);
 
+	// Samples the splines again. Moving a spline, or editing its points in the editor, does so by itself, call it after
+	// assigning Splines or changing points at runtime. Don't evaluate the generator on other threads meanwhile
+	UFUNCTION(BlueprintCallable, Category="FastNoise")
+	void RebuildSplineIndex();
+
 	UPROPERTY()
 	TArray<class USplineComponent*> Splines;
 
@@ -35,4 +50,40 @@ public:
 	  if provided.
 	*/
 	UCurveFloat *FalloffCurve;
+
+	/*
+	  Splines are approximated by straight segments no longer than this, sampled when they
+	  are added
+	*/
+	float SegmentLength;
+
+private:
+	struct FSplineSegment
+	{
+		FVector Start;
+		FVector End;
+	};
+
+	void OnSplineTransformUpdated(USceneComponent* Component, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+	void UnwatchSplines();
+
+	// The splines the index was built from, rebuilt when one of them moves
+	TArray<TWeakObjectPtr<class USplineComponent>> WatchedSplines;
+
+#if WITH_EDITOR
+	void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent);
+
+	// Rebuilds the index when the points of one of the splines are edited
+	FDelegateHandle ObjectPropertyChangedHandle;
+#endif
+
+	// Segments of all splines in a uniform grid over XY, each cell listing the segments whose bounds overlap it. Not
+	// saved, they are rebuilt when the generator is loaded or duplicated
+	TArray<FSplineSegment> Segments;
+	TArray<int32> CellStarts;
+	TArray<int32> CellSegments;
+	FVector2D GridOrigin;
+	float CellSize;
+	int32 GridSizeX;
+	int32 GridSizeY;
 };
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeLock.h"
+#include "Templates/Function.h"
+
+/**
+ * Interns read-only values built from a key, so everything asking for the same key shares one value.
+ *
+ * Entries are weak, so the cache never keeps a value alive on its own: values are reference counted by their users and
+ * freed once the last one lets go. Values are built outside the lock, callers building other keys don't wait on them.
+ */
+template<typename KeyType, typename ValueType>
+class TUFNWeakValueCache
+{
+public:
+	typedef TSharedPtr<const ValueType, ESPMode::ThreadSafe> FValuePtr;
+
+	// Returns the live value for the key, or null if none built from it is still referenced
+	FValuePtr Find(const KeyType& Key)
+	{
+		FScopeLock Lock(&CacheLock);
+
+		TWeakPtr<const ValueType, ESPMode::ThreadSafe>* Entry = Entries.Find(Key);
+		if (Entry == nullptr)
+		{
+			return nullptr;
+		}
+
+		FValuePtr Value = Entry->Pin();
+		if (!Value.IsValid())
+		{
+			Entries.Remove(Key);
+		}
+		return Value;
+	}
+
+	// Returns the live value for the key, calling Create to build it on a miss. Null if Create returns null
+	FValuePtr FindOrCreate(const KeyType& Key, TFunctionRef<FValuePtr()> Create)
+	{
+		FValuePtr Value = Find(Key);
+		if (Value.IsValid())
+		{
+			return Value;
+		}
+
+		FValuePtr Created = Create();
+		if (!Created.IsValid())
+		{
+			return nullptr;
+		}
+
+		FScopeLock Lock(&CacheLock);
+
+		// Another caller may have built the same key meanwhile, keep the first one in
+		TWeakPtr<const ValueType, ESPMode::ThreadSafe>& Entry = Entries.FindOrAdd(Key);
+		Value = Entry.Pin();
+		if (!Value.IsValid())
+		{
+			Entry = Created;
+			Value = Created;
+		}
+
+		PruneReleasedEntries();
+		return Value;
+	}
+
+	// Number of values currently shared through the cache
+	int32 Num()
+	{
+		FScopeLock Lock(&CacheLock);
+		PruneReleasedEntries();
+		return Entries.Num();
+	}
+
+private:
+	// Must be called with CacheLock held
+	void PruneReleasedEntries()
+	{
+		for (auto It = Entries.CreateIterator(); It; ++It)
+		{
+			if (!It.Value().IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	TMap<KeyType, TWeakPtr<const ValueType, ESPMode::ThreadSafe>> Entries;
+
+	FCriticalSection CacheLock;
+};
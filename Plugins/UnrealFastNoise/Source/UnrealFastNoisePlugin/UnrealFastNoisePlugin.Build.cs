@@ -9,6 +9,12 @@ public class UnrealFastNoisePlugin : ModuleRules
         
 		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore"  });
 
+        // ufn.Profile.Export, profiling is compiled out of shipping builds
+        if (Target.Configuration != UnrealTargetConfiguration.Shipping)
+        {
+            PrivateDependencyModuleNames.AddRange(new string[] { "Json" });
+        }
+
         PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
         // Uncomment if you are using Slate UI
@@ -3,6 +3,7 @@
 #include "ProceduralIcosahedron.h"
 #include "FastNoise.h"
 #include "UnrealFastNoisePlugin/Public/UFNNoiseGenerator.h"
+#include "UnrealFastNoisePlugin/Public/UFNNoiseProgram.h"
 #include "UnrealFastNoisePlugin/Public/UFNBlueprintFunctionLibrary.h"
 #include "Kismet/GameplayStatics.h"
 #include "Atmosphere/AtmosphericFogComponent.h"
@@ -161,11 +162,30 @@ void AProceduralIcosahedron::CreateIcosahedron(bool Update)
 			FVector position = GetActorLocation();
 			//FVector ActorLocation = GetActorLocation();
 			
+			// Get the heights from the 3D noise using the vertex locations, all at once through the compiled graph
+			const int32 NumVertices = planetData->Vertices.Num();
+			TArray<float> VertexX, VertexY, VertexZ, Heights;
+			VertexX.SetNumUninitialized(NumVertices);
+			VertexY.SetNumUninitialized(NumVertices);
+			VertexZ.SetNumUninitialized(NumVertices);
+			Heights.SetNumUninitialized(NumVertices);
+			for (int i = 0; i < NumVertices; i++)
+			{
+				VertexX[i] = planetData->Vertices[i].X;
+				VertexY[i] = planetData->Vertices[i].Y;
+				VertexZ[i] = planetData->Vertices[i].Z;
+			}
+			if (!NoiseProgram.IsValid() || NoiseProgramSource.Get() != NoiseGenerator)
+			{
+				NoiseProgram = FUFNNoiseProgram::Compile3D(NoiseGenerator);
+				NoiseProgramSource = NoiseGenerator;
+			}
+			NoiseProgram->Evaluate3D(VertexX.GetData(), VertexY.GetData(), VertexZ.GetData(), Heights.GetData(), NumVertices);
+
 			TArray<FSphericalCoords> PolarVertices3D;
 			for (int i = 0; i < planetData->Vertices.Num(); i++)
 			{
-				// Get the height from the 3D noise using the vertex location
-				float height = NoiseGenerator->GetNoise3D(planetData->Vertices[i].X, planetData->Vertices[i].Y, planetData->Vertices[i].Z);
+				float height = Heights[i];
 				if (height > (1.0f - (MinWaterLevel * 2.0f))) // Clamp to water level
 				{
 					height = 1.0f - (MinWaterLevel * 2.0f);
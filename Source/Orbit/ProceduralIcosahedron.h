@@ -239,6 +239,10 @@ protected:
 	UPROPERTY()
 	class UUFNNoiseGenerator* NoiseGenerator;
 
+	// NoiseGenerator compiled for evaluating the vertex heights, rebuilt when NoiseGenerator is replaced
+	TSharedPtr<class FUFNNoiseProgram> NoiseProgram;
+	TWeakObjectPtr<class UUFNNoiseGenerator> NoiseProgramSource;
+
 	// Calculate and cache LOD levels so they only have to be calculated once
 	UPROPERTY()
 	TMap<uint8, UPlanetData* > CachedLODLevels;
@@ -73,6 +73,9 @@ void ATestProceduralMesh::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// The height data samples the noise, so it has to exist first
+	GenerateNoiseMap();
+
 	if (OutputTex != nullptr)
 	{
 		LinearHeightValues = GetHeightDataFromTexture(OutputTex);
@@ -82,7 +85,6 @@ void ATestProceduralMesh::BeginPlay()
 		LinearHeightValues = GetHeightDataFromAlgorithm();
 	}
 
-	GenerateNoiseMap();
 	CreateNoiseTexture(Resolution, Resolution);
 	GenerateMesh(Resolution, Resolution);
 }
@@ -94,11 +96,17 @@ void ATestProceduralMesh::GenerateMesh(float width, float height)
 	float topLeftX = (width - 1) / -2.0f;
 	float topLeftY = (height - 1) / 2.0f;
 
+	// Sample the heights of every vertex in one go, rows run down from topLeftY
+	const FIntPoint extent((int32)width, (int32)height);
+	TArray<float> heights;
+	heights.SetNumUninitialized(extent.X * extent.Y);
+	NoiseGen->FillNoiseGrid2D(FVector2D(0.0f, topLeftY), FVector2D(1.0f, -1.0f), extent, heights.GetData());
+
 	for (int x = 0; x < width; x++)
 	{
 		for (int y = 0; y < height; y++)
 		{
-			FVector vertex = FVector(topLeftX + x, y, NoiseGenerator->GetNoise2D(x, topLeftY - y) * HeightBoost);
+			FVector vertex = FVector(topLeftX + x, y, heights[(y * extent.X) + x] * HeightBoost);
 			vertex *= Scale;
 			meshData.Vertices[vertexIndex] = vertex;
 			meshData.UV[vertexIndex] = FVector2D((x / (float)width), (y / (float)height));
@@ -155,18 +163,16 @@ TArray<float> ATestProceduralMesh::GetHeightDataFromTexture(const UTexture2D * i
 TArray<float> ATestProceduralMesh::GetHeightDataFromAlgorithm()
 {
 	TArray<float> heightData;
-	if (NoiseGenerator == nullptr)
+	if (NoiseGen == nullptr)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("No Noise Generator created, ATestProceduralMesh::GetHeightDataFromAlgorithm"));
+		return heightData;
 	}
 
-	for (int x = 0; x < Resolution; x++)
-	{
-		for (int y = 0; y < Resolution; y++)
-		{
-			heightData.Add(NoiseGenerator->GetNoise2D(x, y));
-		}
-	}
+	// Row major, the layout HeightValueAtCoord reads
+	const int32 size = (int32)Resolution;
+	heightData.SetNumUninitialized(size * size);
+	NoiseGen->FillNoiseGrid2D(FVector2D(0.0f, 0.0f), FVector2D(1.0f, 1.0f), FIntPoint(size, size), heightData.GetData());
 
 	return heightData;
 }
@@ -272,11 +278,8 @@ TArray<float> ATestProceduralMesh::GetNoiseMap(int width, int height)
 	TArray<float> map;
 	if (!NoiseGen) return map;
 
-	for (int x = 0; x < width; x++)
-		for (int y = 0; y < height; y++)		
-		{
-			map.Add(NoiseGenerator->GetNoise2D(x, y));
-		}
+	map.SetNumUninitialized(width * height);
+	NoiseGen->FillNoiseGrid2D(FVector2D(0.0f, 0.0f), FVector2D(1.0f, 1.0f), FIntPoint(width, height), map.GetData());
 
 
 